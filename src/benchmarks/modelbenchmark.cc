@@ -0,0 +1,125 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../model/batch.h"
+#include "../model/calculator.h"
+#include "../model/compiler.h"
+#include "../model/defaultmodel.h"
+
+namespace {
+constexpr std::size_t kInputSize = 100 * 1024;
+constexpr std::size_t kPoints = 1000;
+constexpr int kRepeats = 5;
+
+using Generator = std::function<std::string(std::size_t)>;
+
+struct Input {
+  const char* name;
+  Generator generate;
+};
+
+std::string Polynomial(std::size_t size) {
+  std::string expr = "0.5";
+  for (int power = 1; expr.size() < size; ++power)
+    expr += "+" + std::to_string(1.0 / power) + "*x^" + std::to_string(power);
+  return expr;
+}
+
+std::string LongSum(std::size_t size) {
+  std::string expr = "x";
+  for (int term = 1; expr.size() < size; ++term)
+    expr += (term % 2 ? "+" : "-") + std::to_string(term);
+  return expr;
+}
+
+std::string NestedBrackets(std::size_t size) {
+  std::size_t depth = size / 2;
+  return std::string(depth, '(') + "x+1" + std::string(depth, ')');
+}
+
+std::string NestedFunctions(std::size_t size) {
+  std::string expr;
+  std::size_t depth = size / 5;
+  for (std::size_t i = 0; i < depth; ++i) expr += i % 2 ? "sin(" : "cos(";
+  return expr + "x" + std::string(depth, ')');
+}
+
+double BestOf(const std::function<void()>& run) {
+  double best = 0;
+  for (int i = 0; i < kRepeats; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (!i || elapsed.count() < best) best = elapsed.count();
+  }
+  return best;
+}
+
+double CompileTime(const std::string& expr) {
+  s21::ShuntingYardCompiler compiler;
+  return BestOf([&] { compiler.Compile(expr); });
+}
+
+void Measure(const Input& input) {
+  std::string expr = input.generate(kInputSize);
+  std::string half = input.generate(kInputSize / 2);
+  double compile = CompileTime(expr);
+  double scaling = compile / CompileTime(half);
+
+  s21::ShuntingYardCompiler compiler;
+  compiler.Recompile(expr);
+  std::string edited = expr + "+1";
+  double recompile = BestOf([&] {
+    compiler.Recompile(edited);
+    compiler.Recompile(expr);
+  });
+
+  s21::DefaultModel model(s21::DefaultModel::kNoSizeLimit);
+  model.setExpression(expr);
+  std::vector<double> x(kPoints), y(kPoints);
+  for (std::size_t i = 0; i < kPoints; ++i) x[i] = i * 2.0 / kPoints - 1;
+  s21::RPNCalculator calc;
+  s21::Program program = compiler.Compile(expr);
+  double eval =
+      BestOf([&] { calc.Calculate(program, x.data(), y.data(), kPoints); });
+
+  std::printf(
+      "%-16s %7zu B  compile %7.2f MB/s  half input %5.2fx faster  "
+      "edit at end %8.1f us  eval %8.1f us/point\n",
+      input.name, expr.size(), expr.size() / compile / 1e6, scaling,
+      recompile / 2 * 1e6, eval / kPoints * 1e6);
+}
+void MeasureBatch() {
+  std::vector<s21::BatchJob> jobs;
+  std::vector<double> x(kPoints);
+  for (std::size_t i = 0; i < kPoints; ++i) x[i] = i * 2.0 / kPoints - 1;
+  for (std::size_t i = 0; i < 2000; ++i)
+    jobs.push_back({Polynomial(64 + i % 512), x});
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  double single = 0;
+  for (unsigned threads = 1; threads <= cores; threads *= 2) {
+    s21::BatchEvaluator batch(threads);
+    double time = BestOf([&] { batch.Run(jobs); });
+    if (threads == 1) single = time;
+    std::printf("batch %2u threads %8.1f jobs/ms  %5.2fx\n", threads,
+                jobs.size() / time / 1e3, single / time);
+  }
+}
+}  // namespace
+
+int main() {
+  const std::vector<Input> inputs = {{"polynomial", Polynomial},
+                                     {"long sum", LongSum},
+                                     {"nested brackets", NestedBrackets},
+                                     {"nested functions", NestedFunctions}};
+  for (const Input& input : inputs) Measure(input);
+  MeasureBatch();
+  return 0;
+}
@@ -2,10 +2,16 @@
 #ifndef CPP3_SMARTCALC_V2_SRC_CONTROLLER_CONTROLLER_H_
 #define CPP3_SMARTCALC_V2_SRC_CONTROLLER_CONTROLLER_H_
 
+#include <algorithm>
 #include <cmath>
+#include <locale>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "../model/model_interface.h"
+#include "../model/tokenizer.h"
+#include "../model/trace.h"
 #include "../view/view_interface.h"
 
 /*!
@@ -25,8 +31,195 @@ class CalcModelController {
  public:
   static_assert(std::is_same<ICalculationModel::set_type,
                              ICalculatorView::set_type>::value);
+  static_assert(std::is_same<ICalculationModel::overlay_type,
+                             ICalculatorView::overlay_type>::value);
+  static_assert(std::is_same<ICalculationModel::status_type,
+                             ICalculatorView::status_type>::value);
 
   using set_type = ICalculationModel::set_type;
+  using overlay_type = ICalculationModel::overlay_type;
+  using status_type = ICalculationModel::status_type;
+
+  /*!
+
+\var CalcModelController::kFitSamples
+\brief Number of samples of an expression evaluated to fit the Y range.
+*/
+  static constexpr std::size_t kFitSamples = 1 << 14;
+
+  /*!
+
+\var CalcModelController::kFitMargin
+\brief Margin of the fitted Y range, relative to the height of the values.
+*/
+  static constexpr double kFitMargin = 0.05;
+
+  /*!
+
+\fn SplitExpressions
+\brief Splits the input into the expressions separated by ';'.
+\details Spaces around the expressions and empty expressions are dropped.
+\param input The input of the view.
+\return The expressions, in the input order.
+*/
+
+  static std::vector<std::string> SplitExpressions(const std::string& input) {
+    std::vector<std::string> expressions;
+    std::size_t begin = 0;
+    while (begin <= input.size()) {
+      std::size_t end = std::min(input.find(';', begin), input.size());
+      std::size_t first = input.find_first_not_of(' ', begin);
+      if (first < end) {
+        std::size_t last = input.find_last_not_of(' ', end - 1);
+        expressions.push_back(input.substr(first, last + 1 - first));
+      }
+      begin = end + 1;
+    }
+    return expressions;
+  }
+
+  /*!
+
+\fn ParseCurve
+\brief Parses the input as a curve given by a parameter t.
+\details A parametric curve is written as "x(t), y(t)" and a polar one as
+"r = r(t)"; both may be followed by ", t_min, t_max", the parameter is from 0
+to 2 pi otherwise.
+\param input The input of the view.
+\param kind The kind of the curve.
+\param components The expressions of the components.
+\param t_min Lower bound of the parameter.
+\param t_max Upper bound of the parameter.
+\return False if the input is not a curve.
+\exception BadExpression If the input is a curve with an invalid parameter
+range or a wrong number of components.
+*/
+
+  static bool ParseCurve(const std::string& input, CurveKind& kind,
+                         std::vector<std::string>& components, double& t_min,
+                         double& t_max) {
+    std::vector<std::string> parts;
+    std::size_t begin = 0;
+    while (begin <= input.size()) {
+      std::size_t end = std::min(input.find(',', begin), input.size());
+      std::size_t first = input.find_first_not_of(' ', begin);
+      if (first < end) {
+        std::size_t last = input.find_last_not_of(' ', end - 1);
+        parts.push_back(input.substr(first, last + 1 - first));
+      } else {
+        parts.emplace_back();
+      }
+      begin = end + 1;
+    }
+    std::size_t equal = parts[0].find('=');
+    bool polar = equal != std::string::npos &&
+                 (parts[0][0] == 'r' || parts[0][0] == 'R') &&
+                 parts[0].find_first_not_of(' ', 1) == equal;
+    if (!polar && parts.size() == 1) return false;
+    kind = polar ? CurveKind::kPolar : CurveKind::kParametric;
+    std::size_t count = polar ? 1 : 2;
+    if (polar) parts[0].erase(0, parts[0].find_first_not_of(' ', equal + 1));
+    if (parts.size() != count && parts.size() != count + 2)
+      throw BadExpression("Invalid curve, expected " +
+                          std::string(polar ? "r = r(t)" : "x(t), y(t)") +
+                          " and optional t_min, t_max");
+    components.assign(parts.begin(), parts.begin() + count);
+    t_min = 0;
+    t_max = 2 * M_PI;
+    if (parts.size() == count + 2 && (!ParseNumber(parts[count], t_min) ||
+                                      !ParseNumber(parts[count + 1], t_max)))
+      throw BadExpression("Invalid parameter range");
+    return true;
+  }
+
+  /*!
+
+\fn ParseImplicit
+\brief Parses the input as an implicit curve "f(x, y) = g(x, y)".
+\param input The input of the view.
+\param expression The expression f(x, y) - g(x, y) to trace the zeros of.
+\return False if the input is not an equation.
+\exception BadExpression If the input has several '='.
+*/
+
+  static bool ParseImplicit(const std::string& input, std::string& expression) {
+    std::size_t equal = input.find('=');
+    if (equal == std::string::npos) return false;
+    if (input.find('=', equal + 1) != std::string::npos)
+      throw BadExpression("Invalid equation, expected f(x, y) = g(x, y)");
+    expression = "(" + input.substr(0, equal) + ")-(" +
+                 input.substr(equal + 1) + ")";
+    return true;
+  }
+
+  /*!
+
+\fn ParseDefinition
+\brief Parses the input as a definition "f(t) = body" of a function or
+"k = body" of a constant.
+\details The name must be accepted by Tokenizer::IsName, and a bare r is left
+to the polar curves. Any other equation is not a definition, e.g.
+"sin(x) = y" is an implicit curve.
+\param input The input of the view.
+\param name The name of the function or the constant.
+\param parameter The parameter of the function, empty for a constant.
+\param body The expression of the function or the constant.
+\return False if the input is not a definition.
+*/
+
+  static bool ParseDefinition(const std::string& input, std::string& name,
+                              std::string& parameter, std::string& body) {
+    std::size_t equal = input.find('=');
+    if (equal == std::string::npos ||
+        input.find_first_of("=,", equal + 1) != std::string::npos ||
+        input.find(',') < equal)
+      return false;
+    std::string lhs = Trim(input.substr(0, equal));
+    std::string argument;
+    std::size_t open = lhs.find('(');
+    if (open != std::string::npos) {
+      if (lhs.back() != ')') return false;
+      argument = Trim(lhs.substr(open + 1, lhs.size() - open - 2));
+      lhs = Trim(lhs.substr(0, open));
+      if (argument != "x" && argument != "y" && !Tokenizer::IsName(argument))
+        return false;
+    } else if (lhs == "r" || lhs == "R") {
+      return false;
+    }
+    if (!Tokenizer::IsName(lhs)) return false;
+    name = lhs;
+    parameter = argument;
+    body = Trim(input.substr(equal + 1));
+    return true;
+  }
+
+  /*!
+
+\fn FitRange
+\brief Fits the Y range to the values of the expressions.
+\details The range spans the finite values with a margin of kFitMargin of
+its height on both sides; a constant is shown in a range of height 2.
+\param stats The statistics of the expressions over the X range.
+\param y_min Lower boundary of the Y range.
+\param y_max Upper boundary of the Y range.
+\return False if no expression has finite values.
+*/
+
+  static bool FitRange(const std::vector<RangeStats>& stats, double& y_min,
+                       double& y_max) {
+    double low = INFINITY, high = -INFINITY;
+    for (const RangeStats& expression : stats) {
+      if (!expression.finite) continue;
+      low = std::min(low, expression.min);
+      high = std::max(high, expression.max);
+    }
+    if (!(low <= high)) return false;
+    double margin = (high - low) * kFitMargin;
+    if (!(margin > 0)) margin = 1;
+    y_min = low - margin;
+    y_max = high + margin;
+    return true;
+  }
 
   /*!
 
@@ -39,8 +232,18 @@ class CalcModelController {
       : model_(model), view_(view) {
     view_->SubscribeExprEval(std::bind(&CalcModelController::EvaluationEvent,
                                        this, std::placeholders::_1));
-    view_->SubscribePlotEval(std::bind(
-        &CalcModelController::PlotEvent, this, std::placeholders::_1,
+    view_->SubscribePlotEval(
+        std::bind(&CalcModelController::PlotEvent, this,
+                  std::placeholders::_1, std::placeholders::_2,
+                  std::placeholders::_3, std::placeholders::_4,
+                  std::placeholders::_5));
+    view_->SubscribeCurveEval(
+        std::bind(&CalcModelController::CurveEvent, this,
+                  std::placeholders::_1, std::placeholders::_2,
+                  std::placeholders::_3, std::placeholders::_4,
+                  std::placeholders::_5));
+    view_->SubscribeRangeEval(std::bind(
+        &CalcModelController::RangeEvent, this, std::placeholders::_1,
         std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
   }
 
@@ -49,13 +252,29 @@ class CalcModelController {
 
 \fn EvaluationEvent
 \brief Handles expression evaluation events for current x-value.
+\details A definition, see ParseDefinition, is made instead: the value of a
+constant is returned, a function is only reported. A live preview makes no
+definitions, see ICalculatorView::Previewing.
 \param x argument value.
 */
 
   double EvaluationEvent(double x) {
+    ScopedTrace trace("EvaluationEvent", "controller");
     double eval_result = NAN;
     try {
-      model_->setExpression(view_->GetExpr());
+      std::string input = view_->GetExpr();
+      std::string name, parameter, body;
+      if (ParseDefinition(input, name, parameter, body)) {
+        Define(name, parameter, body);
+        if (!parameter.empty()) {
+          view_->SendError("Note: " + name + "(" + parameter + ") is defined");
+          return eval_result;
+        }
+        model_->setExpression(name);
+        return model_->Calculate(x);
+      }
+      std::vector<std::string> expressions = SplitExpressions(input);
+      model_->EditExpression(expressions.empty() ? input : expressions[0]);
       eval_result = model_->Calculate(x);
       if (model_->ExressionChanged())
         view_->SendError("Note: An attempt was made to fix expression");
@@ -69,18 +288,33 @@ class CalcModelController {
 
 \fn PlotEvent
 \brief Handles plot evaluation events.
+\details Several expressions are plotted together in a single pass.
 \param left Lower x-axis bound.
 \param right Upper x-axis bound.
 \param y_min Lower y-axis bound.
 \param y_max Upper y-axis bound.
-
+\param status The LaneStatus masks of the sets, see
+ICalculationModel::PlotStatus; empty if the model gives none for every set.
+\return A set of points for every expression.
 */
 
-  set_type PlotEvent(double left, double right, double y_min, double y_max) {
-    set_type eval_result;
+  overlay_type PlotEvent(double left, double right, double y_min,
+                         double y_max, status_type& status) {
+    ScopedTrace trace("PlotEvent", "controller");
+    overlay_type eval_result;
+    status.clear();
     try {
-      model_->setExpression(view_->GetExpr());
-      eval_result = model_->Plot(left, right, y_min, y_max);
+      std::string input = view_->GetExpr();
+      std::vector<std::string> expressions = SplitExpressions(input);
+      if (expressions.size() > 1) {
+        eval_result =
+            model_->PlotOverlay(expressions, left, right, y_min, y_max);
+      } else {
+        model_->EditExpression(expressions.empty() ? input : expressions[0]);
+        eval_result.push_back(model_->Plot(left, right, y_min, y_max));
+      }
+      if (model_->PlotStatus().size() == eval_result.size())
+        status = model_->PlotStatus();
       if (model_->ExressionChanged())
         view_->SendError("Note: An attempt was made to fix expression");
     } catch (BadExpression& err) {
@@ -89,6 +323,124 @@ class CalcModelController {
     return eval_result;
   }
 
+  /*!
+
+\fn CurveEvent
+\brief Handles curve evaluation events.
+\details The input is plotted as a parametric or a polar curve if it is
+written as one, see ParseCurve, or as an implicit curve if it is an equation,
+see ParseImplicit. A definition, see ParseDefinition, is made instead, with
+no curve to plot, unless it is a live preview.
+\param left Lower x-axis bound.
+\param right Upper x-axis bound.
+\param y_min Lower y-axis bound.
+\param y_max Upper y-axis bound.
+\param curve The points of the curve, or the segments of an implicit one
+separated by NaN points, empty on error.
+\return False if the input is not a curve.
+*/
+
+  bool CurveEvent(double left, double right, double y_min, double y_max,
+                  set_type& curve) {
+    ScopedTrace trace("CurveEvent", "controller");
+    curve = set_type();
+    try {
+      std::string input = view_->GetExpr();
+      CurveKind kind;
+      std::vector<std::string> components;
+      double t_min, t_max;
+      std::string expression, name, parameter;
+      if (ParseCurve(input, kind, components, t_min, t_max))
+        curve = model_->PlotCurve(kind, components, t_min, t_max, left, right,
+                                  y_min, y_max);
+      else if (ParseDefinition(input, name, parameter, expression))
+        Define(name, parameter, expression);
+      else if (ParseImplicit(input, expression))
+        curve = model_->PlotImplicit(expression, left, right, y_min, y_max);
+      else
+        return false;
+    } catch (BadExpression& err) {
+      view_->SendError("Error: " + std::string(err.what()));
+    }
+    return true;
+  }
+
+  /*!
+
+\fn RangeEvent
+\brief Handles range fitting events.
+\details The functions of x are analyzed over the X range, see FitRange;
+the curves, the equations and the definitions are not fitted.
+\param left Lower x-axis bound.
+\param right Upper x-axis bound.
+\param y_min Lower y-axis bound, filled by the call.
+\param y_max Upper y-axis bound, filled by the call.
+\return False if the Y range was not fitted.
+*/
+
+  bool RangeEvent(double left, double right, double& y_min, double& y_max) {
+    ScopedTrace trace("RangeEvent", "controller");
+    try {
+      std::string input = view_->GetExpr();
+      if (input.find_first_of("=,") != std::string::npos) return false;
+      std::vector<RangeStats> stats;
+      for (const std::string& expression : SplitExpressions(input)) {
+        model_->EditExpression(expression);
+        stats.push_back(model_->Analyze(left, right, kFitSamples));
+      }
+      return FitRange(stats, y_min, y_max);
+    } catch (BadExpression&) {
+      return false;
+    }
+  }
+
+  /*!
+
+\fn Define
+\brief Makes the definition, unless the view is previewing the input.
+\param name The name of the function or the constant.
+\param parameter The parameter of the function, empty for a constant.
+\param body The expression of the function or the constant.
+\exception BadExpression If the definition is invalid or made by a live
+preview, see ICalculatorView::Previewing.
+*/
+
+  void Define(const std::string& name, const std::string& parameter,
+              const std::string& body) {
+    if (view_->Previewing())
+      throw BadExpression("Definitions are made on evaluation");
+    model_->Define(name, parameter, body);
+  }
+
+  /*!
+
+\fn ParseNumber
+\brief Parses a number written with the decimal point.
+\param text The text of the number.
+\param number The number.
+\return False if the text is not a number.
+*/
+
+  static bool ParseNumber(const std::string& text, double& number) {
+    std::istringstream stream(text);
+    stream.imbue(std::locale::classic());
+    return static_cast<bool>(stream >> number) && stream.eof();
+  }
+
+  /*!
+
+\fn Trim
+\brief Drops the spaces around the text.
+\param text The text.
+\return The text without leading and trailing spaces.
+*/
+
+  static std::string Trim(const std::string& text) {
+    std::size_t first = text.find_first_not_of(' ');
+    if (first == std::string::npos) return std::string();
+    return text.substr(first, text.find_last_not_of(' ') + 1 - first);
+  }
+
   ICalculationModel* model_;
   ICalculatorView* view_;
 };
@@ -1,17 +1,36 @@
 #include <QApplication>
 #include <clocale>
+#include <cstdlib>
 #include <iostream>
+#include <string>
 
 #include "controller/controller.h"
 #include "model/defaultmodel.h"
+#include "model/trace.h"
 #include "view/mainwindow.h"
 
 int main(int argc, char *argv[]) {
   std::setlocale(LC_NUMERIC, "C");
+  if (const char *trace = std::getenv("SMARTCALC_TRACE"))
+    s21::Tracer::Instance().Start(trace);
+  bool single_precision = std::getenv("SMARTCALC_SINGLE") != nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string(argv[i]) == "--single-precision")
+      single_precision = true;
+    else if (i + 1 < argc && std::string(argv[i]) == "--trace")
+      s21::Tracer::Instance().Start(argv[i + 1]);
+  }
   QApplication application(argc, argv);
   MainWindow window;
   s21::DefaultModel model;
+  if (single_precision)
+    model.SetPlotPrecision(s21::DefaultModel::Precision::kSingle);
   s21::CalcModelController controller(&model, &window);
   window.show();
-  return application.exec();
+  int status = application.exec();
+  if (std::getenv("SMARTCALC_STATS"))
+    std::cerr << s21::FormatStats(model.Stats());
+  if (s21::Tracer::Instance().Enabled() && !s21::Tracer::Instance().Stop())
+    std::cerr << "Failed to write the trace\n";
+  return status;
 }
@@ -0,0 +1,132 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "approximation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace s21 {
+namespace {
+constexpr std::size_t kNodes = Approximation::kDegree + 1;
+constexpr double kPi = 3.14159265358979323846;
+
+/**
+ * @brief cos(pi * j * (k + 0.5) / n) for the degree j and the node k.
+ */
+const std::array<std::array<double, kNodes>, kNodes>& CosineTable() {
+  static const auto table = [] {
+    std::array<std::array<double, kNodes>, kNodes> cosines{};
+    for (std::size_t j = 0; j < kNodes; ++j)
+      for (std::size_t k = 0; k < kNodes; ++k)
+        cosines[j][k] = std::cos(kPi * j * (k + 0.5) / kNodes);
+    return cosines;
+  }();
+  return table;
+}
+}  // namespace
+
+void Approximation::Fit(const Function& f, double left, double right,
+                        double tolerance) {
+  Clear();
+  f_ = &f;
+  tolerance_ = tolerance;
+  left_ = left;
+  right_ = right;
+  FitPiece(left, right, 0);
+  f_ = nullptr;
+}
+
+void Approximation::Clear() noexcept {
+  pieces_.clear();
+  coefficients_.clear();
+}
+
+std::size_t Approximation::ExactPieces() const noexcept {
+  return std::count_if(pieces_.begin(), pieces_.end(),
+                       [](const Piece& piece) { return !piece.count; });
+}
+
+bool Approximation::Calculate(double x, double& y) const noexcept {
+  if (!(left_ <= x && x <= right_) || pieces_.empty()) return false;
+  auto piece = std::upper_bound(
+      pieces_.begin(), pieces_.end(), x,
+      [](double value, const Piece& p) { return value < p.left; });
+  if (piece != pieces_.begin()) --piece;
+  if (!piece->count) return false;
+  double t = (x - piece->middle) * piece->inverse_half;
+  y = Clenshaw(coefficients_.data() + piece->offset, piece->count, t);
+  return true;
+}
+
+void Approximation::FitPiece(double left, double right, int depth) {
+  double middle = left + (right - left) / 2;
+  bool divisible = depth < kMaxDepth && left < middle && middle < right &&
+                   pieces_.size() + 2 <= kMaxPieces;
+  Outcome outcome = TryPiece(left, right);
+  if (outcome == Outcome::kFitted) return;
+  if (outcome == Outcome::kRefine && divisible) {
+    FitPiece(left, middle, depth + 1);
+    FitPiece(middle, right, depth + 1);
+  } else {
+    AddExact(left);
+  }
+}
+
+void Approximation::AddExact(double left) {
+  if (pieces_.empty() || pieces_.back().count)
+    pieces_.push_back({left, left, 0, coefficients_.size(), 0});
+}
+
+Approximation::Outcome Approximation::TryPiece(double left, double right) {
+  double middle = left + (right - left) / 2, half = (right - left) / 2;
+  const auto& cosines = CosineTable();
+  x_.resize(2 * kNodes - 1);
+  y_.resize(x_.size());
+  for (std::size_t k = 0; k < kNodes; ++k)
+    x_[k] = middle + half * cosines[1][k];
+  for (std::size_t k = 0; k + 1 < kNodes; ++k)
+    x_[kNodes + k] = middle + half * (cosines[1][k] + cosines[1][k + 1]) / 2;
+  (*f_)(x_.data(), y_.data(), x_.size());
+  double scale = 1;
+  std::size_t finite = 0;
+  for (double y : y_) {
+    if (!std::isfinite(y)) continue;
+    ++finite;
+    scale = std::max(scale, std::fabs(y));
+  }
+  if (!finite) return Outcome::kUndefined;
+  if (finite < y_.size()) return Outcome::kRefine;
+  double bound = tolerance_ * scale;
+
+  std::array<double, kNodes> c{};
+  for (std::size_t j = 0; j < kNodes; ++j) {
+    for (std::size_t k = 0; k < kNodes; ++k) c[j] += y_[k] * cosines[j][k];
+    c[j] *= 2.0 / kNodes;
+  }
+  c[0] /= 2;
+  std::size_t count = kNodes;
+  for (double dropped = 0;
+       count > 1 && (dropped += std::fabs(c[count - 1])) <= bound / 2;)
+    --count;
+
+  for (std::size_t k = 0; k + 1 < kNodes; ++k) {
+    double t = (x_[kNodes + k] - middle) / half;
+    if (!(std::fabs(Clenshaw(c.data(), count, t) - y_[kNodes + k]) <= bound))
+      return Outcome::kRefine;
+  }
+  pieces_.push_back({left, middle, 1 / half, coefficients_.size(), count});
+  coefficients_.insert(coefficients_.end(), c.begin(), c.begin() + count);
+  return Outcome::kFitted;
+}
+
+double Approximation::Clenshaw(const double* c, std::size_t count,
+                               double t) noexcept {
+  double b1 = 0, b2 = 0, twice = 2 * t;
+  for (std::size_t j = count - 1; j > 0; --j) {
+    double b0 = twice * b1 - b2 + c[j];
+    b2 = b1;
+    b1 = b0;
+  }
+  return t * b1 - b2 + c[0];
+}
+}  // namespace s21
@@ -0,0 +1,166 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file approximation.h
+ * @brief Header file for the Approximation class, a piecewise Chebyshev
+ * approximation of a function over a fixed domain.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_APPROXIMATION_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_APPROXIMATION_H_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace s21 {
+/**
+ * @class Approximation
+ * @brief Piecewise Chebyshev polynomials fitted to a function, evaluated by
+ * the Clenshaw recurrence in a handful of multiply-adds per point.
+ * @details The domain is bisected until the interpolant of every piece at
+ * kDegree + 1 Chebyshev nodes is within the tolerance at the midpoints
+ * between the nodes. The tolerance is absolute for values below 1 and
+ * relative to the magnitude of the piece above it. Pieces with non-finite
+ * samples (poles, the edges of the function's domain) or that do not converge
+ * within kMaxDepth bisections are left exact: the points falling into them
+ * have to be evaluated by the caller.
+ */
+class Approximation final {
+ public:
+  /**
+   * @brief Evaluates the function at n points: f(x, y, n).
+   */
+  using Function = std::function<void(const double*, double*, std::size_t)>;
+
+  /**
+   * @brief Degree of the polynomial fitted to a piece before trimming.
+   */
+  static constexpr std::size_t kDegree = 31;
+
+  /**
+   * @brief Maximum number of bisections of the domain.
+   */
+  static constexpr int kMaxDepth = 18;
+
+  /**
+   * @brief Maximum number of pieces, the rest of the domain is left exact.
+   */
+  static constexpr std::size_t kMaxPieces = 4096;
+
+  /**
+   * @brief Fits the function over the domain, replacing the previous fit.
+   * @param f The function.
+   * @param left Left boundary of the domain.
+   * @param right Right boundary of the domain.
+   * @param tolerance The maximum error, positive.
+   */
+  void Fit(const Function& f, double left, double right, double tolerance);
+
+  /**
+   * @brief Drops the fit.
+   */
+  void Clear() noexcept;
+
+  /**
+   * @brief Checks if the fit covers the range.
+   * @param left Left boundary of the range.
+   * @param right Right boundary of the range.
+   * @return true if the range is within the fitted domain.
+   */
+  bool Covers(double left, double right) const noexcept {
+    return !pieces_.empty() && left_ <= left && right <= right_;
+  }
+
+  /**
+   * @brief Evaluates the approximation.
+   * @param x The variable value.
+   * @param y Receives the approximated value.
+   * @return false if x is outside the domain or in an exact piece, y is left
+   * unchanged then.
+   */
+  bool Calculate(double x, double& y) const noexcept;
+
+  /**
+   * @brief Returns the number of pieces.
+   * @return The number of approximated and exact pieces.
+   */
+  std::size_t Pieces() const noexcept { return pieces_.size(); }
+
+  /**
+   * @brief Returns the number of exact pieces.
+   * @return The number of pieces left to the exact evaluation.
+   */
+  std::size_t ExactPieces() const noexcept;
+
+  /**
+   * @brief Returns the number of stored coefficients.
+   * @return The sum of the trimmed polynomial sizes.
+   */
+  std::size_t Coefficients() const noexcept { return coefficients_.size(); }
+
+ private:
+  /**
+   * @struct Piece
+   * @brief Polynomial of a subinterval, in the variable t in [-1, 1].
+   */
+  struct Piece {
+    double left;         /**< Left boundary*/
+    double middle;       /**< Center of the interval*/
+    double inverse_half; /**< 1 / half-width of the interval*/
+    std::size_t offset;  /**< First coefficient*/
+    std::size_t count;   /**< Number of coefficients, 0 if exact*/
+  };
+
+  /**
+   * @enum Outcome
+   * @brief Result of fitting a single polynomial to an interval.
+   */
+  enum class Outcome : unsigned char {
+    kFitted,    /**< The polynomial is within the tolerance*/
+    kRefine,    /**< The interval has to be bisected*/
+    kUndefined  /**< The function is not finite anywhere in the interval*/
+  };
+
+  /**
+   * @brief Fits the interval, bisecting it if needed.
+   * @param left Left boundary of the interval.
+   * @param right Right boundary of the interval.
+   * @param depth Number of bisections so far.
+   */
+  void FitPiece(double left, double right, int depth);
+
+  /**
+   * @brief Fits the interval with a single polynomial.
+   * @param left Left boundary of the interval.
+   * @param right Right boundary of the interval.
+   * @return The outcome, the piece is added if it is fitted.
+   */
+  Outcome TryPiece(double left, double right);
+
+  /**
+   * @brief Adds a piece left to the exact evaluation, merged with the
+   * previous one if it is exact too.
+   * @param left Left boundary of the interval.
+   */
+  void AddExact(double left);
+
+  /**
+   * @brief Sums the Chebyshev series.
+   * @param c The coefficients.
+   * @param count Number of coefficients, positive.
+   * @param t The variable in [-1, 1].
+   * @return The sum.
+   */
+  static double Clenshaw(const double* c, std::size_t count,
+                         double t) noexcept;
+
+  const Function* f_ = nullptr;      /**< The function being fitted*/
+  double tolerance_ = 0;             /**< The maximum error*/
+  double left_ = 0;                  /**< Left boundary of the domain*/
+  double right_ = 0;                 /**< Right boundary of the domain*/
+  std::vector<Piece> pieces_;        /**< Pieces sorted by x*/
+  std::vector<double> coefficients_; /**< Coefficients of all pieces*/
+  std::vector<double> x_, y_;        /**< Sampling buffers*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_APPROXIMATION_H_
@@ -0,0 +1,58 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file arena.h
+ * @brief Header file for the ScratchArena class, the memory of the temporary
+ * containers of a compilation.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_ARENA_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_ARENA_H_
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace s21 {
+/**
+ * @class ScratchArena
+ * @brief Monotonic arena for the containers that live for one compilation:
+ * the operator stacks, the bracket stack and the checkpoints.
+ * @details Allocates from a buffer inside the arena and, once it is used up,
+ * from the upstream resource in growing blocks. Nothing is freed until
+ * Release, which drops all the memory at once, so a compilation makes no
+ * heap allocations unless it outgrows the buffer. The containers must give
+ * up their memory before the arena is released.
+ */
+class ScratchArena final {
+ public:
+  static constexpr std::size_t kBufferSize = 2048;
+
+  /**
+   * @brief Constructs the arena.
+   * @param upstream The resource to allocate from once the buffer is used
+   * up.
+   */
+  explicit ScratchArena(std::pmr::memory_resource* upstream =
+                            std::pmr::get_default_resource()) noexcept
+      : arena_(buffer_, sizeof(buffer_), upstream) {}
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /**
+   * @brief Returns the resource allocating from the arena.
+   * @return The resource, valid as long as the arena.
+   */
+  std::pmr::memory_resource* Resource() noexcept { return &arena_; }
+
+  /**
+   * @brief Returns the memory taken from the upstream resource and starts
+   * allocating from the buffer again.
+   */
+  void Release() noexcept { arena_.release(); }
+
+ private:
+  alignas(std::max_align_t) std::byte buffer_[kBufferSize]; /**< The memory
+                                                                used first*/
+  std::pmr::monotonic_buffer_resource arena_; /**< Allocates from buffer_*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_ARENA_H_
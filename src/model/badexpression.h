@@ -5,10 +5,19 @@
 #include <stdexcept>
 #include <string>
 
+#include "parseerror.h"
+
 namespace s21 {
 class BadExpression final : public std::runtime_error {
  public:
   explicit BadExpression(const std::string& what) : std::runtime_error(what) {}
+  explicit BadExpression(const ParseError& error)
+      : std::runtime_error(std::string(error.Message())), error_(error) {}
+
+  const ParseError& error() const noexcept { return error_; }
+
+ private:
+  ParseError error_;
 };
 }  // namespace s21
 
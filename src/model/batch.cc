@@ -0,0 +1,148 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <clocale>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include "badexpression.h"
+#include "defaultmodel.h"
+#include "trace.h"
+
+namespace s21 {
+namespace {
+/**
+ * @class JobRange
+ * @brief Jobs [begin, end) of a thread packed into a single atomic word.
+ * @details The word fully describes the range, so a compare-and-swap against
+ * a stale but equal value is still correct. Ranges are aligned to a cache
+ * line to keep the threads from sharing them.
+ */
+class alignas(64) JobRange {
+ public:
+  void Assign(std::uint32_t begin, std::uint32_t end) noexcept {
+    bounds_.store(Pack(begin, end), std::memory_order_release);
+  }
+
+  /**
+   * @brief Takes the first job, called by the owner only.
+   */
+  bool Pop(std::uint32_t& job) noexcept {
+    std::uint64_t bounds = bounds_.load(std::memory_order_acquire);
+    while (Begin(bounds) < End(bounds)) {
+      if (bounds_.compare_exchange_weak(bounds,
+                                        Pack(Begin(bounds) + 1, End(bounds)),
+                                        std::memory_order_acq_rel)) {
+        job = Begin(bounds);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Moves the back half of the jobs to the empty range of the thief
+   * and takes the first of them.
+   */
+  bool Steal(JobRange& thief, std::uint32_t& job) noexcept {
+    std::uint64_t bounds = bounds_.load(std::memory_order_acquire);
+    while (Begin(bounds) < End(bounds)) {
+      std::uint32_t middle =
+          Begin(bounds) + (End(bounds) - Begin(bounds)) / 2;
+      if (bounds_.compare_exchange_weak(bounds, Pack(Begin(bounds), middle),
+                                        std::memory_order_acq_rel)) {
+        thief.Assign(middle + 1, End(bounds));
+        job = middle;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  static constexpr std::uint64_t Pack(std::uint32_t begin,
+                                      std::uint32_t end) noexcept {
+    return std::uint64_t{begin} << 32 | end;
+  }
+  static constexpr std::uint32_t Begin(std::uint64_t bounds) noexcept {
+    return static_cast<std::uint32_t>(bounds >> 32);
+  }
+  static constexpr std::uint32_t End(std::uint64_t bounds) noexcept {
+    return static_cast<std::uint32_t>(bounds);
+  }
+
+  std::atomic<std::uint64_t> bounds_{0};
+};
+
+void Execute(ICalculationModel& model, const BatchJob& job,
+             BatchResult& result) {
+  try {
+    model.setExpression(job.expression);
+    result.outputs.reserve(job.inputs.size());
+    for (double x : job.inputs) result.outputs.push_back(model.Calculate(x));
+  } catch (const BadExpression& e) {
+    result.outputs.clear();
+    result.error = e.error();
+    result.message = e.what();
+  }
+}
+}  // namespace
+
+BatchEvaluator::BatchEvaluator(std::size_t threads, ModelFactory factory)
+    : factory_(std::move(factory)) {
+  if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+  if (!factory_)
+    factory_ = [] {
+      return std::make_unique<DefaultModel>(DefaultModel::kNoSizeLimit);
+    };
+  models_.resize(threads);
+}
+
+std::vector<BatchResult> BatchEvaluator::Run(
+    const std::vector<BatchJob>& jobs) {
+  if (jobs.size() >= std::numeric_limits<std::uint32_t>::max())
+    throw std::length_error("Too many batch jobs");
+  std::setlocale(LC_NUMERIC, "C");
+  std::vector<BatchResult> results(jobs.size());
+  std::size_t count = jobs.size();
+  std::size_t threads =
+      std::min(models_.size(), std::max<std::size_t>(count, 1));
+  std::unique_ptr<JobRange[]> ranges(new JobRange[threads]);
+  for (std::size_t i = 0; i < threads; ++i)
+    ranges[i].Assign(static_cast<std::uint32_t>(count * i / threads),
+                     static_cast<std::uint32_t>(count * (i + 1) / threads));
+  std::vector<std::exception_ptr> errors(threads);
+  std::atomic<bool> failed{false};
+
+  auto work = [&](std::size_t self) {
+    try {
+      if (!models_[self]) models_[self] = factory_();
+      std::uint32_t job = 0;
+      while (!failed.load(std::memory_order_relaxed)) {
+        bool found = ranges[self].Pop(job);
+        for (std::size_t k = 1; !found && k < threads; ++k)
+          found = ranges[(self + k) % threads].Steal(ranges[self], job);
+        if (!found) break;
+        ScopedTrace trace("BatchJob", "model");
+        Execute(*models_[self], jobs[job], results[job]);
+      }
+    } catch (...) {
+      errors[self] = std::current_exception();
+      failed.store(true, std::memory_order_relaxed);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (std::size_t i = 1; i < threads; ++i) pool.emplace_back(work, i);
+  work(0);
+  for (std::thread& thread : pool) thread.join();
+  for (const std::exception_ptr& error : errors)
+    if (error) std::rethrow_exception(error);
+  return results;
+}
+}  // namespace s21
@@ -0,0 +1,96 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file batch.h
+ * @brief Header file for the BatchEvaluator class, which compiles and
+ * evaluates many independent expressions on all cores.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_BATCH_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_BATCH_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model_interface.h"
+#include "parseerror.h"
+
+namespace s21 {
+/**
+ * @struct BatchJob
+ * @brief An expression and the variable values to evaluate it at.
+ */
+struct BatchJob {
+  std::string expression;     /**< The expression*/
+  std::vector<double> inputs; /**< The variable values*/
+};
+
+/**
+ * @struct BatchResult
+ * @brief The values of a job's expression, or the reason it was rejected.
+ */
+struct BatchResult {
+  std::vector<double> outputs; /**< A value per input, empty on failure*/
+  ParseError error;            /**< The error and its position, if known*/
+  std::string message;         /**< The error message, empty on success*/
+
+  /**
+   * @brief Checks if the job was evaluated.
+   * @return true if the expression was accepted.
+   */
+  explicit operator bool() const noexcept { return message.empty(); }
+};
+
+/**
+ * @class BatchEvaluator
+ * @brief Runs jobs on a work-stealing pool of threads, each with its own
+ * model.
+ * @details The jobs are split into equal ranges, one per thread. A thread
+ * takes jobs from the front of its range and, once it is exhausted, steals
+ * the back half of the range of another thread. A range is a single atomic
+ * word updated by compare-and-swap, so uneven jobs are balanced without any
+ * lock, and the results are written straight to their place in the output.
+ * The calling thread works as one of the threads. The models are created
+ * by the factory on first use and kept for the later runs.
+ */
+class BatchEvaluator final {
+ public:
+  /**
+   * @brief Creates a model for a thread.
+   */
+  using ModelFactory = std::function<std::unique_ptr<ICalculationModel>()>;
+
+  /**
+   * @brief Constructs the evaluator.
+   * @param threads Number of threads, 0 for the number of cores.
+   * @param factory Creates the model of a thread, a DefaultModel without the
+   * expression size limit if empty.
+   */
+  explicit BatchEvaluator(std::size_t threads = 0,
+                          ModelFactory factory = nullptr);
+
+  /**
+   * @brief Compiles and evaluates every job.
+   * @details A rejected expression fails its own job only. Any other
+   * exception stops the run and is rethrown once all threads are done.
+   * @param jobs The jobs, fewer than 2^32.
+   * @return A result per job, in the order of the jobs.
+   */
+  std::vector<BatchResult> Run(const std::vector<BatchJob>& jobs);
+
+  /**
+   * @brief Returns the number of threads.
+   * @return The number of threads, including the calling one.
+   */
+  std::size_t Threads() const noexcept { return models_.size(); }
+
+ private:
+  /** Creates the models*/
+  ModelFactory factory_;
+  /** A model per thread, created by its first run*/
+  std::vector<std::unique_ptr<ICalculationModel>> models_;
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_BATCH_H_
@@ -1,14 +1,17 @@
 // Copyright 2023 School21 @gruntmet Snezhana Valeeva
 #include "calculator.h"
 
+#include <algorithm>
 #include <clocale>
 #include <string>
 #include <string_view>
 
 #include "badexpression.h"
+#include "stats.h"
 
 namespace s21 {
 double RPNCalculator::Calculate(const std::list<std::string>& expr, double x) {
+  ScopedStage stage(Stage::kCalculate, 1);
   std::setlocale(LC_NUMERIC, "C");
   for (auto token : expr) {
     current_token_ = Tokenizer::GetTokenType(token.at(0));
@@ -22,13 +25,47 @@ double RPNCalculator::Calculate(const std::list<std::string>& expr, double x) {
   return result;
 }
 
+double RPNCalculator::Calculate(const Program& program, double x) {
+  ScopedStage stage(Stage::kCalculate, 1);
+  Prepare(program);
+  return evaluator_.Calculate(program.View(), x);
+}
+
+void RPNCalculator::Calculate(const Program& program, const double* x,
+                              double* y, std::size_t n) {
+  ScopedStage stage(Stage::kCalculate, n);
+  Prepare(program);
+  evaluator_.Calculate(program.View(), x, y, n);
+}
+
+void RPNCalculator::Calculate(const Program& program, const double* x,
+                              double* y, unsigned char* status, double y_min,
+                              double y_max, std::size_t n) {
+  ScopedStage stage(Stage::kCalculate, n);
+  Prepare(program);
+  evaluator_.Calculate(program.View(), x, y, status, y_min, y_max, n);
+}
+
+double RPNCalculator::Calculate(const ProgramView& program, double x) {
+  ScopedStage stage(Stage::kCalculate, 1);
+  return evaluator_.Calculate(program, x);
+}
+
+void RPNCalculator::Calculate(const ProgramView& program, const double* x,
+                              double* y, std::size_t n) {
+  ScopedStage stage(Stage::kCalculate, n);
+  evaluator_.Calculate(program, x, y, n);
+}
+
+void RPNCalculator::Prepare(const Program& program) const {
+  if (!program.Valid()) throw BadExpression(program.Status());
+}
+
 void RPNCalculator::Operate(const std::string_view& operation) {
+  Opcode op = OperationCode(operation);
   double r = CalcStackPop();
-  if (kUnaryFunctions.find(operation) != kUnaryFunctions.end())
-    return calc_stack_.push(kUnaryFunctions[operation](r));
-  double l = CalcStackPop();
-  if (kBinaryFunctions.find(operation) != kBinaryFunctions.end())
-    return calc_stack_.push(kBinaryFunctions[operation](l, r));
+  double l = Arity(op) == 2 ? CalcStackPop() : 0;
+  calc_stack_.push(Evaluator<double>::Apply(op, l, r));
 }
 
 double RPNCalculator::ToDouble(std::string src, double x) const {
@@ -46,14 +83,18 @@ double RPNCalculator::ToDouble(std::string src, double x) const {
 
 std::vector<double> RPNCalculator::GenerateSet(double l, double r,
                                                int fin) const {
+  std::vector<double> points(std::max(fin, 0));
+  GenerateSet(l, r, points.data(), points.size());
+  return points;
+}
+
+void RPNCalculator::GenerateSet(double l, double r, double* points,
+                                std::size_t fin) const {
   if (l > r) throw BadExpression("Invalid set borders");
-  std::vector<double> points;
-  points.reserve(fin);
-  double delta = (r - l) / (fin - 1);
-  for (int i = 0; i < fin; i++) {
-    points.push_back(l);
+  double delta = (r - l) / (static_cast<int>(fin) - 1);
+  for (std::size_t i = 0; i < fin; i++) {
+    points[i] = l;
     l += delta;
   }
-  return points;
 }
 }  // namespace s21
@@ -2,15 +2,16 @@
 #ifndef CPP3_SMARTCALC_V2_SRC_MODEL_CALCULATOR_H_
 #define CPP3_SMARTCALC_V2_SRC_MODEL_CALCULATOR_H_
 #include <cmath>
-#include <functional>
 #include <list>
-#include <map>
 #include <stack>
 #include <stdexcept>
 #include <string>
-#include <utility>
+#include <string_view>
 #include <vector>
 
+#include "compiler.h"
+#include "evaluator.h"
+#include "program.h"
 #include "tokenizer.h"
 
 /*!
@@ -28,53 +29,16 @@ class RPNCalculator final {
 \brief RPN calculator handling expressions with unary and binary functions.
 */
 
-  RPNCalculator()
-      /*!
-
-    \fn RPNCalculator::RPNCalculator
-    \brief Constructs an RPNCalculator with predefined unary functions.
-    Initializes the RPNCalculator instance with a set of predefined unary
-    functions, including identity, negation, natural and common logarithm, and
-    trigonometry functions, binary operations including power, mul, div, sum,
-    sub and mod.
-    */
-      : kUnaryFunctions(
-            {std::make_pair("#", [](double x) { return x; }),
-             std::make_pair("~", [](double x) { return -x; }),
-             std::make_pair("ln", [](double x) { return std::log(x); }),
-             std::make_pair("tg", [](double x) { return std::tan(x); }),
-             std::make_pair("sin", [](double x) { return std::sin(x); }),
-             std::make_pair("cos", [](double x) { return std::cos(x); }),
-             std::make_pair("tan", [](double x) { return std::tan(x); }),
-             std::make_pair("ctg", [](double x) { return 1 / std::tan(x); }),
-             std::make_pair("cot", [](double x) { return 1 / std::tan(x); }),
-             std::make_pair("exp", [](double x) { return std::exp(x); }),
-             std::make_pair("log", [](double x) { return std::log10(x); }),
-             std::make_pair("atg", [](double x) { return std::atan(x); }),
-             std::make_pair("asin", [](double x) { return std::asin(x); }),
-             std::make_pair("acos", [](double x) { return std::acos(x); }),
-             std::make_pair("atan", [](double x) { return std::atan(x); }),
-             std::make_pair(
-                 "acot", [](double x) { return std::acos(0) - std::atan(x); }),
-             std::make_pair(
-                 "actg", [](double x) { return std::acos(0) - std::atan(x); }),
-             std::make_pair("sqrt", [](double x) { return std::sqrt(x); })}),
-        kBinaryFunctions(
-            {std::make_pair("^", [](double lhs,
-                                    double rhs) { return std::pow(lhs, rhs); }),
-             std::make_pair(
-                 "%",
-                 [](double lhs, double rhs) { return std::fmod(lhs, rhs); }),
-             std::make_pair("+",
-                            [](double lhs, double rhs) { return lhs + rhs; }),
-             std::make_pair("-",
-                            [](double lhs, double rhs) { return lhs - rhs; }),
-             std::make_pair("*",
-                            [](double lhs, double rhs) { return lhs * rhs; }),
-             std::make_pair("/",
-                            [](double lhs, double rhs) { return lhs / rhs; })}),
-        current_token_(TokenType::kUndefined),
-        calc_stack_() {}
+  /*!
+
+\fn RPNCalculator::RPNCalculator
+\brief Constructs an RPNCalculator.
+\details The operations are dispatched through the constexpr tables of the
+ShuntingYardCompiler and Evaluator::Apply, shared by all instances, so the
+construction does not allocate.
+*/
+
+  RPNCalculator() = default;
 
   using TokenType = Tokenizer::TokenType;
 
@@ -91,6 +55,79 @@ class RPNCalculator final {
 
   /*!
 
+\fn double RPNCalculator::Calculate
+\brief Evaluates the given compiled program.
+\param program Expression compiled into postfix bytecode.
+\param x Optional variable value (default is 0).
+\return The result of the program evaluation.
+\exception BadExpression If the program carries a compilation error.
+\details The evaluation stack is a contiguous buffer of exactly
+Program::MaxDepth() slots, so the loop does no bounds checks or allocations.
+*/
+
+  double Calculate(const Program& program, double x = 0);
+
+  /*!
+
+\fn void RPNCalculator::Calculate
+\brief Evaluates the given compiled program for every argument value.
+\param program Expression compiled into postfix bytecode.
+\param x Array of n variable values.
+\param y Array of n results, filled by the call.
+\param n Number of values.
+\exception BadExpression If the program carries a compilation error.
+*/
+
+  void Calculate(const Program& program, const double* x, double* y,
+                 std::size_t n);
+
+  /*!
+
+\fn void RPNCalculator::Calculate
+\brief Evaluates the given compiled program for every argument value and
+classifies the results.
+\param program Expression compiled into postfix bytecode.
+\param x Array of n variable values.
+\param y Array of n results, filled by the call.
+\param status Array of n LaneStatus masks of the results, filled by the call.
+\param y_min Lower boundary of the visible range.
+\param y_max Upper boundary of the visible range.
+\param n Number of values.
+\exception BadExpression If the program carries a compilation error.
+*/
+
+  void Calculate(const Program& program, const double* x, double* y,
+                 unsigned char* status, double y_min, double y_max,
+                 std::size_t n);
+
+  /*!
+
+\fn double RPNCalculator::Calculate
+\brief Evaluates the bytecode in place, with no validation.
+\param program View of a valid Program or of a program returned by
+LoadProgram.
+\param x Optional variable value (default is 0).
+\return The result of the program evaluation.
+*/
+
+  double Calculate(const ProgramView& program, double x = 0);
+
+  /*!
+
+\fn void RPNCalculator::Calculate
+\brief Evaluates the bytecode in place for every argument value.
+\param program View of a valid Program or of a program returned by
+LoadProgram.
+\param x Array of n variable values.
+\param y Array of n results, filled by the call.
+\param n Number of values.
+*/
+
+  void Calculate(const ProgramView& program, const double* x, double* y,
+                 std::size_t n);
+
+  /*!
+
 \fn std::vector<double> RPNCalculator::GenerateSet
 \brief Generates a set of equally spaced points between l and r.
 \param l Lower bound of the range.
@@ -101,20 +138,32 @@ class RPNCalculator final {
 
   std::vector<double> GenerateSet(double l, double r, int fin) const;
 
- private:
   /*!
 
-\var RPNCalculator::kUnaryFunctions
-\brief Maps supported unary functions to their corresponding operations.
+\fn void RPNCalculator::GenerateSet
+\brief Writes a set of equally spaced points between l and r.
+\param l Lower bound of the range.
+\param r Upper bound of the range.
+\param points Array receiving the fin points.
+\param fin Number of points in the range.
+\exception BadExpression If l is greater than r.
 */
-  std::map<std::string_view, std::function<double(double)>> kUnaryFunctions;
+
+  void GenerateSet(double l, double r, double* points, std::size_t fin) const;
+
+ private:
   /*!
 
-\var RPNCalculator::kBinaryFunctions
-\brief Maps supported binary functions to their corresponding operations.
+\fn Opcode RPNCalculator::OperationCode
+\brief Maps an operator or a function token to its operation.
+\param operation The token of the operation.
+\return The operation, kPlus (the identity) for an unknown token.
 */
-  std::map<std::string_view, std::function<double(double, double)>>
-      kBinaryFunctions;
+  static constexpr Opcode OperationCode(std::string_view operation) noexcept {
+    return operation.size() == 1
+               ? ShuntingYardCompiler::OperatorCode(operation.front())
+               : ShuntingYardCompiler::FunctionCode(operation);
+  }
   /*!
 
   \fn void RPNCalculator::Operate
@@ -124,6 +173,14 @@ class RPNCalculator final {
   void Operate(const std::string_view& operation);
   /*!
 
+  \fn void RPNCalculator::Prepare
+  \brief Validates the program before the evaluation.
+  \param program The program to be evaluated.
+  \exception BadExpression If the program carries a compilation error.
+  */
+  void Prepare(const Program& program) const;
+  /*!
+
   \fn double RPNCalculator::CalcStackPop
   \brief Pops the top value from the stack and returns it.
   \return The value popped from the stack, as a double.
@@ -149,13 +206,19 @@ class RPNCalculator final {
 \brief Enumerates different types of tokens encountered in processing RPN
 expressions.
 */
-  TokenType current_token_;
+  TokenType current_token_ = TokenType::kUndefined;
   /*!
 
 \var RPNCalculator::calc_stack_
 \brief Stack to hold intermediate values during RPN calculations.
 */
-  std::stack<double> calc_stack_;
+  std::stack<double, std::vector<double>> calc_stack_;
+  /*!
+
+\var RPNCalculator::evaluator_
+\brief Evaluator of compiled programs in double precision.
+*/
+  Evaluator<double> evaluator_;
 };
 }  // namespace s21
 
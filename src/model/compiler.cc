@@ -0,0 +1,172 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "compiler.h"
+
+#include <langinfo.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <memory_resource>
+#include <string>
+#include <utility>
+
+#include "badexpression.h"
+#include "stats.h"
+
+namespace s21 {
+namespace {
+/**
+ * @brief Makes strtod read the decimal point, switching LC_NUMERIC to "C"
+ * only if it is needed: setlocale is process-wide, so calling it on every
+ * compilation would race between compilers running in different threads.
+ */
+void UseDecimalPoint() {
+  if (*nl_langinfo(RADIXCHAR) != '.') std::setlocale(LC_NUMERIC, "C");
+}
+}  // namespace
+
+Program ShuntingYardCompiler::Compile(const std::string_view& expression) {
+  ScopedStage stage(Stage::kCompile);
+  Run(expression);
+  if (tokenizer_.Error().Failed()) throw BadExpression(tokenizer_.Error());
+  return std::move(program_);
+}
+
+ParseResult ShuntingYardCompiler::TryCompile(
+    const std::string_view& expression) {
+  ScopedStage stage(Stage::kCompile);
+  Run(expression);
+  ParseResult result;
+  result.error = tokenizer_.Error().Failed() ? tokenizer_.Error()
+                                             : program_.Status();
+  result.fixes = tokenizer_.Fixes();
+  result.program = std::move(program_);
+  return result;
+}
+
+void ShuntingYardCompiler::Run(const std::string_view& expression) {
+  UseDecimalPoint();
+  recompiling_ = false;
+  source_.clear();
+  checkpoints_.clear();
+  program_.Clear();
+  operator_stack_.clear();
+  begin_ = expression.data();
+  tokenizer_.Parse(expression, *this);
+  if (!tokenizer_.Error().Failed())
+    while (!operator_stack_.empty()) PushToOut();
+  ReleaseScratch();
+}
+
+void ShuntingYardCompiler::ReleaseScratch() {
+  checkpoints_ = std::pmr::vector<State>(resource_);
+  operator_stack_ = std::pmr::vector<Pending>(resource_);
+  tokenizer_.Release();
+  copied_ = 0;
+  if (resource_ == arena_.Resource()) arena_.Release();
+}
+
+Program ShuntingYardCompiler::Recompile(const std::string_view& expression) {
+  ScopedStage stage(Stage::kCompile);
+  UseDecimalPoint();
+  std::size_t prefix =
+      std::mismatch(source_.begin(), source_.end(), expression.begin(),
+                    expression.end())
+          .first -
+      source_.begin();
+  while (!checkpoints_.empty() &&
+         checkpoints_.back().tokenizer.Offset() >= prefix)
+    checkpoints_.pop_back();
+  std::size_t live = 0;
+  for (const State& state : checkpoints_) live += state.operators.size() + 1;
+  if (copied_ > 2 * live + kArenaSlack) checkpoints_.clear();
+  recompiling_ = true;
+  source_.assign(expression.begin(), expression.end());
+  begin_ = source_.data();
+  if (checkpoints_.empty()) {
+    ReleaseScratch();
+    program_.Clear();
+    since_checkpoint_ = 0;
+    tokenizer_.Tokenize(source_, *this);
+  } else {
+    State from = std::move(checkpoints_.back());
+    checkpoints_.pop_back();
+    operator_stack_ = std::move(from.operators);
+    program_.Rollback(from.program);
+    since_checkpoint_ = operator_stack_.size();
+    tokenizer_.Tokenize(source_, *this, from.tokenizer);
+  }
+  while (!operator_stack_.empty()) PushToOut();
+  return program_;
+}
+
+void ShuntingYardCompiler::Checkpoint() {
+  if (!recompiling_ || since_checkpoint_++ < operator_stack_.size()) return;
+  since_checkpoint_ = 0;
+  copied_ += operator_stack_.size() + 1;
+  checkpoints_.push_back({tokenizer_.Save(),
+                          std::pmr::vector<Pending>(operator_stack_, resource_),
+                          program_.Save()});
+}
+
+void ShuntingYardCompiler::Push(TokenType type, std::string_view token) {
+  if (Tokenizer::IsNumeric(type)) {
+    EmitOperand(token);
+  } else if (type == TokenType::kFunction) {
+    const Definitions::Definition* definition =
+        definitions_ ? definitions_->Find(token) : nullptr;
+    if (definition)
+      operator_stack_.push_back(
+          {token.front(), Opcode::kPlus, &definition->body, program_.Save()});
+    else
+      operator_stack_.push_back({token.front(), FunctionCode(token)});
+  } else if (type == TokenType::kOpenBracket) {
+    operator_stack_.push_back({token.front(), Opcode::kNumber});
+  } else if (type == TokenType::kOperator) {
+    while (PriorityLess(token.front())) PushToOut();
+    operator_stack_.push_back({token.front(), OperatorCode(token.front())});
+  } else if (type == TokenType::kCloseBracket) {
+    while (NotOpenBracket()) PushToOut();
+    operator_stack_.pop_back();
+    if (FunctionOnTop()) PushToOut();
+  }
+}
+
+std::size_t ShuntingYardCompiler::Match(std::string_view text,
+                                         TokenType& type) const noexcept {
+  std::size_t width = 0;
+  if (definitions_) {
+    auto [definition, size] = definitions_->Match(text);
+    if (definition) {
+      type = definition->function ? TokenType::kFunction : TokenType::kArg;
+      width = size;
+    }
+  }
+  if (parameter_.size() >= width && text.substr(0, parameter_.size()) ==
+                                       std::string_view(parameter_)) {
+    type = TokenType::kArg;
+    width = parameter_.size();
+  }
+  return width;
+}
+
+void ShuntingYardCompiler::EmitOperand(const std::string_view& token) {
+  if (token == parameter_) return program_.Emit(Opcode::kArg);
+  if (token == "y" && allow_y_) return program_.Emit(Opcode::kArgY);
+  const Definitions::Definition* constant =
+      definitions_ ? definitions_->Find(token) : nullptr;
+  if (constant && !constant->function)
+    return program_.Emit(Opcode::kNumber, constant->value);
+  std::pmr::string src(token, resource_);
+  char* end = nullptr;
+  errno = 0;
+  double dbl = std::strtod(src.c_str(), &end);
+  if (end != src.c_str() + src.size() || errno == ERANGE)
+    program_.Fail({ErrorCode::kInvalidNumber,
+                   static_cast<std::size_t>(token.data() - begin_),
+                   token.size()});
+  program_.Emit(Opcode::kNumber, dbl);
+}
+}  // namespace s21
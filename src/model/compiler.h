@@ -0,0 +1,351 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file compiler.h
+ * @brief Header file for the ShuntingYardCompiler class, which compiles
+ * mathematical expressions into postfix bytecode in a single pass.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_COMPILER_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_COMPILER_H_
+
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "definitions.h"
+#include "parseerror.h"
+#include "program.h"
+#include "tokenizer.h"
+
+namespace s21 {
+/**
+ * @struct ParseResult
+ * @brief Outcome of the non-throwing compilation: the program or the error
+ * that rejected the expression, with the fixes applied to it.
+ */
+struct ParseResult {
+  Program program;  /**< The compiled program, valid on success only*/
+  ParseError error; /**< The first error, not set on success*/
+  std::vector<AppliedFix> fixes; /**< The fixes applied by the Tokenizer*/
+
+  /**
+   * @brief Checks if the expression was compiled.
+   * @return true if no error was found.
+   */
+  explicit operator bool() const noexcept { return !error.Failed(); }
+};
+
+/**
+ * @class ShuntingYardCompiler
+ * @brief Fuses the Tokenizer and the shunting-yard algorithm: every token is
+ * translated as soon as the Tokenizer recognizes it, so neither the token list
+ * nor the Reverse Polish Notation list is ever built.
+ * @details The operator stack, the bracket stack and the checkpoints are
+ * allocated from a ScratchArena released after every compilation, unless
+ * another memory resource is given. Only the program is on the heap.
+ */
+class ShuntingYardCompiler final : private Tokenizer::Sink {
+ public:
+  using TokenType = Tokenizer::TokenType;
+
+  /**
+   * @brief Operator stack entries the checkpoints may copy into the arena
+   * beyond twice the entries of the live checkpoints. Past it Recompile
+   * drops the checkpoints and releases the arena, so that editing does not
+   * grow the arena without bound.
+   */
+  static constexpr std::size_t kArenaSlack = 1024;
+
+  /**
+   * @brief Constructs the compiler.
+   * @param resource The memory of the temporary containers, kept until the
+   * compiler is destroyed; nullptr for the arena of the compiler.
+   */
+  explicit ShuntingYardCompiler(std::pmr::memory_resource* resource = nullptr)
+      : resource_(resource ? resource : arena_.Resource()),
+        tokenizer_(resource_),
+        operator_stack_(resource_),
+        checkpoints_(resource_) {}
+  ShuntingYardCompiler(const ShuntingYardCompiler&) = delete;
+  ShuntingYardCompiler& operator=(const ShuntingYardCompiler&) = delete;
+
+  /**
+   * @brief Compiles the expression into postfix bytecode.
+   * @param expression The expression to compile.
+   * @return The compiled program.
+   * @exception BadExpression If the expression cannot be tokenized.
+   */
+  Program Compile(const std::string_view& expression);
+
+  /**
+   * @brief Compiles the expression without throwing on invalid input.
+   * @details Unlike Compile, errors found in the operands (e.g. a malformed
+   * number) are reported here rather than deferred to the evaluation.
+   * @param expression The expression to compile.
+   * @return The program, or the error and the position of the offending
+   * token.
+   */
+  ParseResult TryCompile(const std::string_view& expression);
+
+  /**
+   * @brief Compiles an edited version of the previously recompiled
+   * expression.
+   * @details Checkpoints are saved between tokens, so only the part of the
+   * expression after the first changed symbol is tokenized and translated
+   * again. A checkpoint copies the operator stack, so the checkpoints are
+   * spaced by its depth, which keeps saving them linear in the expression
+   * size even for deeply nested expressions.
+   * @param expression The expression to compile.
+   * @return The compiled program.
+   * @exception BadExpression If the expression cannot be tokenized.
+   */
+  Program Recompile(const std::string_view& expression);
+
+  /**
+   * @brief Checks if the last compiled expression had to be fixed.
+   * @return true if the Tokenizer applied any fixes.
+   */
+  bool ExpressionChanged() noexcept { return tokenizer_.ExpressionChanged(); }
+
+  /**
+   * @brief Lets the expressions use the second variable y.
+   * @details The variable is read by Opcode::kArgY. If it is not allowed, y
+   * is reported as an invalid number, as any other unknown operand.
+   * @param allow Whether y is a variable.
+   */
+  void AllowY(bool allow) {
+    if (allow != allow_y_) {
+      checkpoints_.clear();
+      source_.clear();
+    }
+    allow_y_ = allow;
+  }
+
+  /**
+   * @brief Sets the user-defined functions and constants the expressions may
+   * use.
+   * @details A constant is compiled as its value and a call of a function as
+   * its body with the argument in place of x, so the programs do not depend
+   * on the definitions once compiled.
+   * @param definitions The definitions, kept alive by the compiler; nullptr
+   * for none.
+   */
+  void UseDefinitions(std::shared_ptr<const Definitions> definitions) {
+    if (definitions != definitions_) {
+      checkpoints_.clear();
+      source_.clear();
+    }
+    definitions_ = std::move(definitions);
+  }
+
+  /**
+   * @brief Names the variable read by Opcode::kArg.
+   * @details Used to compile the body of a function. A parameter other than x
+   * makes x an invalid number, as any other unknown operand.
+   * @param parameter The name of the variable, x or a name accepted by
+   * Tokenizer::IsName.
+   */
+  void SetParameter(std::string parameter) {
+    if (parameter != parameter_) {
+      checkpoints_.clear();
+      source_.clear();
+    }
+    parameter_ = std::move(parameter);
+  }
+
+  /**
+   * @brief Function names and their operations, in the order the Tokenizer
+   * matches them.
+   */
+  static constexpr std::array<std::pair<std::string_view, Opcode>, 16>
+      kFunctionCodes = {{{"ln", Opcode::kLn},
+                         {"tg", Opcode::kTan},
+                         {"sin", Opcode::kSin},
+                         {"cos", Opcode::kCos},
+                         {"tan", Opcode::kTan},
+                         {"ctg", Opcode::kCot},
+                         {"cot", Opcode::kCot},
+                         {"log", Opcode::kLog},
+                         {"exp", Opcode::kExp},
+                         {"atg", Opcode::kAtan},
+                         {"asin", Opcode::kAsin},
+                         {"acos", Opcode::kAcos},
+                         {"atan", Opcode::kAtan},
+                         {"acot", Opcode::kAcot},
+                         {"actg", Opcode::kAcot},
+                         {"sqrt", Opcode::kSqrt}}};
+
+  /**
+   * @brief Maps an operator symbol to its operation.
+   * @param symbol The collapsed operator symbol.
+   * @return The operation of the operator.
+   */
+  static constexpr Opcode OperatorCode(char symbol) noexcept {
+    switch (symbol) {
+      case '#':
+        return Opcode::kPlus;
+      case '~':
+        return Opcode::kMinus;
+      case '^':
+        return Opcode::kPow;
+      case '%':
+        return Opcode::kMod;
+      case '+':
+        return Opcode::kAdd;
+      case '-':
+        return Opcode::kSub;
+      case '*':
+        return Opcode::kMul;
+      default:
+        return Opcode::kDiv;
+    }
+  }
+
+  /**
+   * @brief Maps a function name to its operation.
+   * @param name The function name recognized by the Tokenizer.
+   * @return The operation of the function, kPlus for an unknown name.
+   */
+  static constexpr Opcode FunctionCode(std::string_view name) noexcept {
+    for (const auto& function : kFunctionCodes)
+      if (function.first == name) return function.second;
+    return Opcode::kPlus;
+  }
+
+ private:
+  /**
+   * @struct Pending
+   * @brief Operator stack entry: the symbol that defines its priority and
+   * the operation emitted when it leaves the stack, or the body inlined in
+   * place of the argument emitted after the mark.
+   */
+  struct Pending {
+    char symbol;
+    Opcode op;
+    const Program* body = nullptr;
+    Program::Mark argument = {};
+  };
+
+  /**
+   * @struct State
+   * @brief Compilation state between two tokens.
+   */
+  struct State {
+    Tokenizer::Snapshot tokenizer;
+    std::pmr::vector<Pending> operators;
+    Program::Mark program;
+  };
+
+  /**
+   * @brief Gives the memory of the temporary containers back and releases
+   * the arena if it is used.
+   */
+  void ReleaseScratch();
+
+  /**
+   * @brief Tokenizes and translates the expression from scratch.
+   * @param expression The expression to compile.
+   */
+  void Run(const std::string_view& expression);
+
+  /**
+   * @brief Translates the next token straight into the program.
+   * @param type TokenType classification of the token.
+   * @param token Text of the token.
+   */
+  void Push(TokenType type, std::string_view token) override;
+
+  /**
+   * @brief Saves the compilation state if recompiling and at least as many
+   * tokens as there are pending operators were read since the last save.
+   */
+  void Checkpoint() override;
+
+  /**
+   * @brief Matches the parameter or a user-defined name, the longest of them.
+   * @param text The rest of the expression, starting with the word.
+   * @param type Set to kFunction for a function or kArg for an operand.
+   * @return The length of the name, 0 if no name is defined there.
+   */
+  std::size_t Match(std::string_view text,
+                    TokenType& type) const noexcept override;
+
+  /**
+   * @brief Pushes the top operator from the operator stack to the program.
+   */
+  void PushToOut() {
+    const Pending& top = operator_stack_.back();
+    if (top.body)
+      program_.Inline(top.argument, top.body->View());
+    else
+      program_.Emit(top.op);
+    operator_stack_.pop_back();
+  }
+
+  /**
+   * @brief Checks if the top operator of the stack has to be emitted before
+   * the input operator.
+   * @param symbol The input operator.
+   * @return true if the top operator has priority over the input one.
+   */
+  bool PriorityLess(char symbol) const noexcept {
+    return !operator_stack_.empty() &&
+           Tokenizer::GetPriority(symbol) <=
+               Tokenizer::GetPriority(operator_stack_.back().symbol) &&
+           Tokenizer::isLeftWise(symbol);
+  }
+
+  /**
+   * @brief Checks if the top element in the operator stack is not an open
+   * bracket.
+   * @return true if the top element is not an open bracket.
+   */
+  bool NotOpenBracket() const noexcept {
+    return !operator_stack_.empty() &&
+           Tokenizer::GetTokenType(operator_stack_.back().symbol) !=
+               TokenType::kOpenBracket;
+  }
+
+  /**
+   * @brief Checks if there is a function on top of the operator stack.
+   * @return true if there is a function on top of the operator stack.
+   */
+  bool FunctionOnTop() const noexcept {
+    return !operator_stack_.empty() &&
+           Tokenizer::GetTokenType(operator_stack_.back().symbol) ==
+               TokenType::kFunction;
+  }
+
+  /**
+   * @brief Converts an operand token into the program instruction.
+   * @param token The digit or argument token.
+   */
+  void EmitOperand(const std::string_view& token);
+
+  ScratchArena arena_; /**< Default memory of the temporary containers*/
+  /** The memory of the temporary containers*/
+  std::pmr::memory_resource* resource_;
+  Tokenizer tokenizer_; /**< Splits the expression and applies the fixes*/
+  std::pmr::vector<Pending> operator_stack_; /**< Stack for holding operators
+                                                and functions*/
+  Program program_; /**< The program being compiled*/
+  const char* begin_ = nullptr; /**< The expression being compiled*/
+  bool recompiling_ = false; /**< Whether checkpoints are being saved*/
+  std::string source_;        /**< The last recompiled expression*/
+  std::pmr::vector<State> checkpoints_; /**< States before the tokens of
+                                           source_*/
+  std::size_t since_checkpoint_ = 0; /**< Tokens read after the last save*/
+  std::size_t copied_ = 0; /**< Entries saved to checkpoints since the last
+                              release*/
+  bool allow_y_ = false; /**< Whether y is the second variable*/
+  std::string parameter_ = "x"; /**< The variable read by Opcode::kArg*/
+  /** The user-defined functions and constants*/
+  std::shared_ptr<const Definitions> definitions_;
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_COMPILER_H_
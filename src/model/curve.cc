@@ -0,0 +1,91 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "curve.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace s21 {
+namespace {
+bool Finite(double x, double y) noexcept {
+  return std::isfinite(x) && std::isfinite(y);
+}
+}  // namespace
+
+void CurveSampler::Set(CurveKind kind,
+                       const std::vector<ProgramView>& components) {
+  kind_ = kind;
+  program_.Fuse(components);
+}
+
+CurveSampler::Curve CurveSampler::Sample(double t_min, double t_max,
+                                         double x_left, double x_right,
+                                         double y_min, double y_max) {
+  Curve curve;
+  if (!(t_min <= t_max)) return curve;
+  std::size_t n = t_min < t_max ? kInitialSamples : 1;
+  curve.t.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+    curve.t[i] = i + 1 < n ? t_min + (t_max - t_min) * i / (n - 1) : t_max;
+  curve.x.resize(n);
+  curve.y.resize(n);
+  Evaluate(curve.t.data(), n, curve.x.data(), curve.y.data());
+
+  double limit = std::max(x_right - x_left, y_max - y_min) / kResolution;
+  std::vector<double> t, x, y;
+  std::vector<std::size_t> refined;
+  for (int pass = 0; pass < kMaxPasses; ++pass) {
+    refined.clear();
+    t.clear();
+    for (std::size_t i = 0; i + 1 < curve.t.size(); ++i) {
+      double x0 = curve.x[i], y0 = curve.y[i];
+      double x1 = curve.x[i + 1], y1 = curve.y[i + 1];
+      double middle = curve.t[i] + (curve.t[i + 1] - curve.t[i]) / 2;
+      if (!(curve.t[i] < middle && middle < curve.t[i + 1])) continue;
+      bool refine = Finite(x0, y0) != Finite(x1, y1);
+      if (Finite(x0, y0) && Finite(x1, y1))
+        refine = std::hypot(x1 - x0, y1 - y0) > limit &&
+                 std::max(x0, x1) >= x_left && std::min(x0, x1) <= x_right &&
+                 std::max(y0, y1) >= y_min && std::min(y0, y1) <= y_max;
+      if (!refine) continue;
+      if (curve.t.size() + refined.size() >= kMaxSamples) break;
+      refined.push_back(i);
+      t.push_back(middle);
+    }
+    if (refined.empty()) break;
+    x.resize(t.size());
+    y.resize(t.size());
+    Evaluate(t.data(), t.size(), x.data(), y.data());
+
+    Curve merged;
+    std::size_t size = curve.t.size() + t.size();
+    merged.t.reserve(size);
+    merged.x.reserve(size);
+    merged.y.reserve(size);
+    for (std::size_t i = 0, j = 0; i < curve.t.size(); ++i) {
+      merged.t.push_back(curve.t[i]);
+      merged.x.push_back(curve.x[i]);
+      merged.y.push_back(curve.y[i]);
+      if (j < refined.size() && refined[j] == i) {
+        merged.t.push_back(t[j]);
+        merged.x.push_back(x[j]);
+        merged.y.push_back(y[j]);
+        ++j;
+      }
+    }
+    curve = std::move(merged);
+  }
+  return curve;
+}
+
+void CurveSampler::Evaluate(const double* t, std::size_t n, double* x,
+                            double* y) {
+  double* outputs[] = {x, y};
+  program_.Calculate(t, n, outputs);
+  if (kind_ != CurveKind::kPolar) return;
+  for (std::size_t i = 0; i < n; ++i) {
+    double r = x[i];
+    x[i] = r * std::cos(t[i]);
+    y[i] = r * std::sin(t[i]);
+  }
+}
+}  // namespace s21
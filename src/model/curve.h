@@ -0,0 +1,75 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file curve.h
+ * @brief Header file for the CurveSampler class, which samples parametric and
+ * polar curves adaptively.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_CURVE_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_CURVE_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "fusedprogram.h"
+#include "model_interface.h"
+#include "program.h"
+
+namespace s21 {
+/**
+ * @class CurveSampler
+ * @brief Samples a parametric curve (x(t), y(t)) or a polar curve r(t).
+ * @details The components are fused into a single program, so both are
+ * evaluated together in one batched pass over the t values. The curve is
+ * first sampled on a uniform grid of kInitialSamples values; then, in every
+ * pass, the midpoints of the visible steps longer than 1/kResolution of the
+ * view, or with a single finite end, are evaluated in one batch and inserted,
+ * until no step is refined or kMaxSamples is reached.
+ */
+class CurveSampler final {
+ public:
+  static constexpr std::size_t kInitialSamples = 1024;
+  static constexpr std::size_t kMaxSamples = 1 << 16;
+  static constexpr int kMaxPasses = 16;
+  static constexpr double kResolution = 1000;
+
+  /**
+   * @struct Curve
+   * @brief Samples of the curve in the order of t.
+   */
+  struct Curve {
+    std::vector<double> t; /**< Parameter values*/
+    std::vector<double> x; /**< X coordinates*/
+    std::vector<double> y; /**< Y coordinates*/
+  };
+
+  /**
+   * @brief Sets the curve.
+   * @param kind The kind of the curve.
+   * @param components Views of the valid programs of x(t) and y(t) for a
+   * parametric curve, of r(t) for a polar one, compiled with t as the
+   * parameter.
+   */
+  void Set(CurveKind kind, const std::vector<ProgramView>& components);
+
+  /**
+   * @brief Samples the curve.
+   * @param t_min Lower bound of the parameter.
+   * @param t_max Upper bound of the parameter.
+   * @param x_left Left boundary of the view.
+   * @param x_right Right boundary of the view.
+   * @param y_min Lower boundary of the view.
+   * @param y_max Upper boundary of the view.
+   * @return The samples, empty if t_max is less than t_min.
+   */
+  Curve Sample(double t_min, double t_max, double x_left, double x_right,
+               double y_min, double y_max);
+
+ private:
+  void Evaluate(const double* t, std::size_t n, double* x, double* y);
+
+  CurveKind kind_ = CurveKind::kParametric; /**< The kind of the curve*/
+  FusedProgram program_;                    /**< The fused components*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_CURVE_H_
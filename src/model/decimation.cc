@@ -0,0 +1,132 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "decimation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+namespace {
+using Run = std::pair<std::size_t, std::size_t>;
+
+class Decimator final {
+ public:
+  Decimator(const ICalculationModel::set_type& points,
+            const unsigned char* status, ICalculationModel::set_type& dest)
+      : x_(points.first), y_(points.second), status_(status), dest_(dest) {}
+
+  void Column(std::size_t begin, std::size_t end) {
+    runs_.clear();
+    for (std::size_t i = begin; i < end; ++i) {
+      if (Hidden(i)) continue;
+      if (runs_.empty() || runs_.back().second != i)
+        runs_.push_back({i, i + 1});
+      else
+        ++runs_.back().second;
+    }
+    if (runs_.size() <= 2) {
+      for (const Run& run : runs_) EmitRun(run.first, run.second);
+    } else {
+      EmitRun(runs_.front().first, runs_.front().second);
+      Open(runs_[1].first);
+      std::size_t last = runs_[runs_.size() - 2].second;
+      std::size_t low = runs_[1].first, high = runs_[1].first;
+      for (std::size_t i = runs_[1].first; i < last; ++i) {
+        if (!Hidden(i) && y_[i] < y_[low]) low = i;
+        if (!Hidden(i) && y_[i] > y_[high]) high = i;
+      }
+      Emit(std::min(low, high));
+      Emit(std::max(low, high));
+      end_ = last;
+      EmitRun(runs_.back().first, runs_.back().second);
+    }
+  }
+
+ private:
+  bool Hidden(std::size_t i) const noexcept {
+    return status_ ? status_[i] != 0 : !std::isfinite(y_[i]);
+  }
+
+  void Open(std::size_t first) {
+    if (first != end_ && !dest_.first.empty()) {
+      dest_.first.push_back(x_[end_]);
+      dest_.second.push_back(NAN);
+      last_ = kNone;
+    }
+  }
+
+  void EmitRun(std::size_t first, std::size_t end) {
+    Open(first);
+    std::size_t low = first, high = first;
+    for (std::size_t i = first; i < end; ++i) {
+      if (y_[i] < y_[low]) low = i;
+      if (y_[i] > y_[high]) high = i;
+    }
+    Emit(first);
+    Emit(std::min(low, high));
+    Emit(std::max(low, high));
+    Emit(end - 1);
+    end_ = end;
+  }
+
+  void Emit(std::size_t i) {
+    if (i == last_) return;
+    dest_.first.push_back(x_[i]);
+    dest_.second.push_back(y_[i]);
+    last_ = i;
+  }
+
+  static constexpr std::size_t kNone = static_cast<std::size_t>(-1);
+
+  const std::vector<double>& x_;
+  const std::vector<double>& y_;
+  const unsigned char* status_;
+  ICalculationModel::set_type& dest_;
+  std::vector<Run> runs_;
+  std::size_t end_ = 0;
+  std::size_t last_ = kNone;
+};
+ICalculationModel::set_type Reduce(const ICalculationModel::set_type& points,
+                                   const unsigned char* status,
+                                   std::size_t columns) {
+  const std::vector<double>& x = points.first;
+  if (!columns || x.size() <= 4 * columns || !(x.back() > x.front())) {
+    ICalculationModel::set_type result = points;
+    if (status)
+      for (std::size_t i = 0; i < x.size(); ++i)
+        if (status[i]) result.second[i] = NAN;
+    return result;
+  }
+  ICalculationModel::set_type result;
+  result.first.reserve(4 * columns);
+  result.second.reserve(4 * columns);
+  Decimator decimator(points, status, result);
+  double scale = columns / (x.back() - x.front());
+  std::size_t begin = 0;
+  for (std::size_t column = 0; column < columns && begin < x.size();
+       ++column) {
+    std::size_t end = begin;
+    for (; end < x.size() &&
+           (column + 1 == columns ||
+            static_cast<std::size_t>((x[end] - x.front()) * scale) <= column);
+         ++end) {
+    }
+    decimator.Column(begin, end);
+    begin = end;
+  }
+  return result;
+}
+}  // namespace
+
+ICalculationModel::set_type Decimate(const ICalculationModel::set_type& points,
+                                     std::size_t columns) {
+  return Reduce(points, nullptr, columns);
+}
+
+ICalculationModel::set_type Decimate(const ICalculationModel::set_type& points,
+                                     const std::vector<unsigned char>& status,
+                                     std::size_t columns) {
+  return Reduce(points, status.data(), columns);
+}
+}  // namespace s21
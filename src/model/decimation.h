@@ -0,0 +1,47 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file decimation.h
+ * @brief Pixel-aware decimation of plot samples.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_DECIMATION_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_DECIMATION_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "model_interface.h"
+
+namespace s21 {
+/**
+ * @brief Reduces plot samples to the points visible at the given width.
+ * @details The x range of the samples is split into pixel columns. In every
+ * column each continuous run of samples is reduced to its first, minimal,
+ * maximal and last points, which draws the same polyline at that resolution.
+ * Non-finite samples break the line: a single NaN point is kept for each gap.
+ * If a column has more than two runs, the inner ones are merged into a single
+ * vertical segment, so the output never exceeds 12 points per column.
+ * @param points Samples sorted by x, as returned by ICalculationModel::Plot.
+ * @param columns Number of pixel columns of the plot.
+ * @return The decimated samples, still sorted by x.
+ */
+ICalculationModel::set_type Decimate(const ICalculationModel::set_type& points,
+                                     std::size_t columns);
+
+/**
+ * @brief Reduces plot samples to the points visible at the given width,
+ * breaking the line where the samples have a status.
+ * @details Reads the LaneStatus masks produced with the samples instead of
+ * testing the values, so the samples out of the visible range break the line
+ * even if they were not replaced by NaN.
+ * @param points Samples sorted by x, as returned by ICalculationModel::Plot.
+ * @param status LaneStatus masks of the samples, e.g. from
+ * ICalculationModel::PlotStatus.
+ * @param columns Number of pixel columns of the plot.
+ * @return The decimated samples, still sorted by x.
+ */
+ICalculationModel::set_type Decimate(const ICalculationModel::set_type& points,
+                                     const std::vector<unsigned char>& status,
+                                     std::size_t columns);
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_DECIMATION_H_
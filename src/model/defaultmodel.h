@@ -2,15 +2,31 @@
 #ifndef CPP3_SMARTCALC_V2_SRC_MODEL_DEFAULT_MODEL_H_
 #define CPP3_SMARTCALC_V2_SRC_MODEL_DEFAULT_MODEL_H_
 
-#include <list>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "approximation.h"
+#include "badexpression.h"
 #include "calculator.h"
+#include "compiler.h"
+#include "curve.h"
+#include "definitions.h"
+#include "evaluator.h"
+#include "implicit.h"
+#include "fusedprogram.h"
 #include "model_interface.h"
+#include "parseerror.h"
+#include "program.h"
+#include "rangescan.h"
+#include "resultcache.h"
+#include "resultring.h"
 #include "tokenizer.h"
-#include "translator.h"
 
 /*!
 
@@ -29,16 +45,32 @@ class DefaultModel final : public ICalculationModel {
  public:
   using BaseModel = ICalculationModel;
   using set_type = typename ICalculationModel::set_type;
+  using overlay_type = typename ICalculationModel::overlay_type;
 
   /*!
 
 \var DefaultModel::kExprMaxSize
-\brief Maximum size constant for the underlying expression.
+\brief Default maximum size of the underlying expression.
 */
   static constexpr std::size_t kExprMaxSize = 255;
 
   /*!
 
+\var DefaultModel::kNoSizeLimit
+\brief Maximum size that lifts the limit on the expression size.
+*/
+  static constexpr std::size_t kNoSizeLimit =
+      std::numeric_limits<std::size_t>::max();
+
+  /*!
+
+\enum DefaultModel::Precision
+\brief Scalar type of the plot evaluation.
+*/
+  enum class Precision : unsigned char { kSingle, kDouble };
+
+  /*!
+
 \var DefaultModel::kRangeFinesse
 \brief Number of points generated for the plot's range.
 */
@@ -46,48 +78,433 @@ class DefaultModel final : public ICalculationModel {
 
   /*!
 
+\var DefaultModel::kPlotChunk
+\brief Number of plot values published at once by PlotInto.
+*/
+  static constexpr std::size_t kPlotChunk = 2048;
+
+  /*!
+
+\fn DefaultModel::DefaultModel
+\brief Constructs the model accepting expressions up to the given size.
+\details Compilation and evaluation are linear in the expression size, so
+the limit only guards against accidental input.
+\param max_size Maximum size of the expression in bytes.
+*/
+
+  explicit DefaultModel(std::size_t max_size = kExprMaxSize) noexcept
+      : max_size_(max_size) {}
+
+  /*!
+
+\fn void DefaultModel::SetMaxSize
+\brief Changes the maximum size of the expression.
+\param max_size Maximum size of the expression in bytes, kNoSizeLimit to
+accept expressions of any size.
+*/
+
+  void SetMaxSize(std::size_t max_size) noexcept { max_size_ = max_size; }
+
+  /*!
+
+\fn std::size_t DefaultModel::MaxSize
+\brief Returns the maximum size of the expression.
+\return Maximum size of the expression in bytes.
+*/
+
+  std::size_t MaxSize() const noexcept { return max_size_; }
+
+  /*!
+
+\fn void DefaultModel::SetPlotPrecision
+\brief Selects the scalar type of the plot evaluation.
+\details Single precision evaluates twice as many points per vector
+instruction. It is used only if float still resolves every sample of the x
+range and the y range to the same step and every constant of the expression
+is a normal float; wider ranges far from zero, ranges beyond the float limits
+and constants such as 1e50 or 1e-46 are plotted in double precision. The
+default is double precision. There is no long double mode: Evaluator<long
+double> keeps the constants in double.
+\param precision The scalar type.
+*/
+
+  void SetPlotPrecision(Precision precision) noexcept {
+    precision_ = precision;
+  }
+
+  /*!
+
+\fn void DefaultModel::SetApproximation
+\brief Enables the approximation of the expression by piecewise Chebyshev
+polynomials.
+\details The approximation is fitted to the plot domain, widened by its width
+on both sides, so panning reuses it. Later plots and calculations within the
+fitted domain evaluate the polynomials instead of the expression, except near
+poles and discontinuities, which are evaluated exactly.
+\param tolerance Maximum error, relative for values above 1; 0 disables the
+approximation.
+*/
+
+  void SetApproximation(double tolerance) noexcept {
+    tolerance_ = tolerance;
+    approximation_.Clear();
+  }
+
+  /*!
+
+\fn void DefaultModel::SetResultCache
+\brief Enables the memoization of Calculate, see ResultCache.
+\details The cache is enabled by default. Benchmarks disable it to measure
+the evaluation itself.
+\param enabled Whether the results of Calculate are cached.
+*/
+
+  void SetResultCache(bool enabled) noexcept {
+    cache_enabled_ = enabled;
+    cache_.Clear();
+  }
+
+  /*!
+
 \fn double DefaultModel::Calculate
 \brief Overrides the base class Calculate function.
+\details The exact results are memoized by the compiled program and the bits
+of x, so repeating a query does not evaluate the expression again.
 \param x Optional parameter representing the input value for the calculation
 (default is 0).
 \return The result of the calculation.
 */
 
   double Calculate(double x = 0) override {
-    return calc_.Calculate(reverse_polish_notation_, x);
+    double y = 0;
+    if (approximation_.Calculate(x, y)) return y;
+    if (cache_enabled_ && cache_.Find(program_id_, x, y)) return y;
+    y = calc_.Calculate(program_, x);
+    if (cache_enabled_) cache_.Insert(program_id_, x, y);
+    return y;
   };
 
   /*!
 
+\fn void DefaultModel::Calculate
+\brief Evaluates the expression for every argument value at once.
+\param x Array of n variable values.
+\param y Array of n results, filled by the call.
+\param n Number of values.
+\exception BadExpression If the expression was not compiled.
+*/
+
+  void Calculate(const double* x, double* y, std::size_t n) {
+    if (!approximation_.Pieces()) return calc_.Calculate(program_, x, y, n);
+    for (std::size_t i = 0; i < n; ++i) y[i] = Calculate(x[i]);
+  }
+
+  /*!
+
 \fn DefaultModel::set_type DefaultModel::Plot
 \brief Overrides the base class Plot function for generating a set of plot
 points. \details Uses the range [x_left, x_right] and [y_min, y_max] to generate
-the set of points. \param x_left Left boundary of the X range. \param x_right
-Right boundary of the X range. \param y_min Lower boundary of the Y range.
+the set of points. The values are classified into LaneStatus masks as they
+are evaluated, see PlotStatus, and the ones with any status bit are NaN.
+\param x_left Left boundary of the X range.
+\param x_right Right boundary of the X range.
+\param y_min Lower boundary of the Y range.
 \param y_max Upper boundary of the Y range.
 \return A set of points, represented as a set_type object.
 */
 
   set_type Plot(double x_left, double x_right, double y_min,
                 double y_max) override {
+    ScopedStage stage(Stage::kPlot, kRangeFinesse);
+    overlay_plotted_ = false;
     std::vector<double> x_set =
         calc_.GenerateSet(x_left, x_right, kRangeFinesse);
-    std::vector<double> y_set;
-    y_set.reserve(kRangeFinesse);
-    for (double x : x_set) {
-      double tmp_y = calc_.Calculate(reverse_polish_notation_, x);
-      if (tmp_y > y_max || tmp_y < y_min) {
-        y_set.push_back(NAN);
-      } else {
-        y_set.push_back(tmp_y);
-      }
+    std::vector<double> y_set(x_set.size());
+    plot_status_.resize(1);
+    std::vector<unsigned char>& status = plot_status_.front();
+    status.resize(x_set.size());
+    if (tolerance_ > 0 || (precision_ == Precision::kSingle &&
+                           SingleResolves(x_left, x_right) &&
+                           SingleResolves(y_min, y_max) &&
+                           SingleHolds(program_.View()))) {
+      if (tolerance_ > 0)
+        CalculateApproximated(x_set, y_set);
+      else
+        CalculateSingle(x_set, y_set);
+      Evaluator<double>::Classify(y_set.data(), status.data(), y_set.size(),
+                                  y_min, y_max);
+    } else {
+      calc_.Calculate(program_, x_set.data(), y_set.data(), status.data(),
+                      y_min, y_max, x_set.size());
     }
+    Hide(y_set.data(), status.data(), y_set.size());
 
     return std::make_pair(x_set, y_set);
   }
 
   /*!
 
+\fn const DefaultModel::status_type& DefaultModel::PlotStatus
+\brief Overrides the base class PlotStatus function.
+\details The status of a Plot is one mask, of a PlotOverlay one per
+expression; it is kept until the next of them.
+\return LaneStatus masks of the Y coordinates of every set of the last Plot
+or PlotOverlay, 0 for the visible ones.
+*/
+
+  const status_type& PlotStatus() const noexcept override {
+    return plot_status_;
+  }
+
+  /*!
+
+\fn bool DefaultModel::PlotInto
+\brief Plots the expression straight into a shared-memory ring.
+\details Writes a record of kRangeFinesse X coordinates followed by as many
+Y coordinates, evaluated in double precision. The X coordinates and then
+every kPlotChunk values are published as soon as they are written, so the
+consumer can draw the plot progressively.
+\param ring The ring, written by this thread only.
+\param x_left Left boundary of the X range.
+\param x_right Right boundary of the X range.
+\param y_min Lower boundary of the Y range.
+\param y_max Upper boundary of the Y range.
+\return false if the ring has no room for the record yet.
+\exception BadExpression If the expression was not compiled or the range is
+invalid; nothing is written to the ring then.
+*/
+
+  bool PlotInto(ResultRing& ring, double x_left, double x_right, double y_min,
+                double y_max) {
+    if (!program_.Valid()) throw BadExpression(program_.Status());
+    if (x_left > x_right) throw BadExpression("Invalid set borders");
+    ScopedStage stage(Stage::kPlot, kRangeFinesse);
+    double* x = ring.Begin(2 * kRangeFinesse);
+    if (!x) return false;
+    double* y = x + kRangeFinesse;
+    calc_.GenerateSet(x_left, x_right, x, kRangeFinesse);
+    ring.Progress(kRangeFinesse);
+    for (std::size_t i = 0; i < kRangeFinesse; i += kPlotChunk) {
+      std::size_t n = std::min(kPlotChunk, kRangeFinesse - i);
+      unsigned char status[kPlotChunk];
+      Calculate(x + i, y + i, n);
+      Evaluator<double>::Classify(y + i, status, n, y_min, y_max);
+      Hide(y + i, status, n);
+      ring.Progress(kRangeFinesse + i + n);
+    }
+    ring.Commit();
+    return true;
+  }
+
+  /*!
+
+\fn DefaultModel::overlay_type DefaultModel::PlotOverlay
+\brief Overrides the base class PlotOverlay function.
+\details The expressions are merged into a single program that evaluates
+their common subexpressions once, in one pass over the X coordinates. The
+merged program is kept while the same expressions are plotted. The values
+are classified as in Plot, with a mask per expression, see PlotStatus.
+\param expressions The expressions to plot.
+\param x_left Left boundary of the X range.
+\param x_right Right boundary of the X range.
+\param y_min Lower boundary of the Y range.
+\param y_max Upper boundary of the Y range.
+\return A set of points for every expression, in the same order.
+\exception BadExpression If any of the expressions is invalid.
+*/
+
+  overlay_type PlotOverlay(const std::vector<std::string>& expressions,
+                           double x_left, double x_right, double y_min,
+                           double y_max) override {
+    ScopedStage stage(Stage::kPlot, kRangeFinesse * expressions.size());
+    if (expressions != overlay_expressions_) FuseOverlay(expressions);
+    overlay_plotted_ = true;
+    std::vector<double> x_set =
+        calc_.GenerateSet(x_left, x_right, kRangeFinesse);
+    overlay_type sets(expressions.size(),
+                      set_type(x_set, std::vector<double>(x_set.size())));
+    std::vector<double*> y_sets;
+    for (set_type& set : sets) y_sets.push_back(set.second.data());
+    {
+      ScopedStage calculate(Stage::kCalculate, x_set.size() * sets.size());
+      overlay_.Calculate(x_set.data(), x_set.size(), y_sets.data());
+    }
+    plot_status_.resize(sets.size());
+    for (std::size_t i = 0; i < sets.size(); ++i) {
+      std::vector<unsigned char>& status = plot_status_[i];
+      std::vector<double>& y_set = sets[i].second;
+      status.resize(y_set.size());
+      Evaluator<double>::Classify(y_set.data(), status.data(), status.size(),
+                                  y_min, y_max);
+      Hide(y_set.data(), status.data(), status.size());
+    }
+    return sets;
+  }
+
+  /*!
+
+\fn DefaultModel::set_type DefaultModel::PlotCurve
+\brief Overrides the base class PlotCurve function.
+\details The components are written in t and merged into a single program,
+kept while the same curve is plotted, so that both are evaluated in one
+pass. The curve is sampled by CurveSampler, with more values of t where it
+moves fast. The points farther from the Y range than its height are NaN,
+which breaks the curve there; the nearer ones keep the curve running to the
+edge of the view.
+\param kind The kind of the curve.
+\param components The expressions of x(t) and y(t) for a parametric curve, of
+r(t) for a polar one.
+\param t_min Lower bound of the parameter.
+\param t_max Upper bound of the parameter.
+\param x_left Left boundary of the X range.
+\param x_right Right boundary of the X range.
+\param y_min Lower boundary of the Y range.
+\param y_max Upper boundary of the Y range.
+\return The points in the order of t, represented as a set_type object.
+\exception BadExpression If any of the components is invalid, their number
+does not match the kind, or the parameter or the X range is invalid.
+*/
+
+  set_type PlotCurve(CurveKind kind, const std::vector<std::string>& components,
+                     double t_min, double t_max, double x_left, double x_right,
+                     double y_min, double y_max) override {
+    if (!(t_min <= t_max) || !std::isfinite(t_min) || !std::isfinite(t_max))
+      throw BadExpression("Invalid parameter range");
+    if (x_left > x_right) throw BadExpression("Invalid set borders");
+    if (curve_components_.empty() || kind != curve_kind_ ||
+        components != curve_components_)
+      SetCurve(kind, components);
+    ScopedStage stage(Stage::kPlot, CurveSampler::kInitialSamples);
+    CurveSampler::Curve curve =
+        curve_.Sample(t_min, t_max, x_left, x_right, y_min, y_max);
+    double margin = y_max - y_min;
+    for (double& y : curve.y)
+      if (y > y_max + margin || y < y_min - margin) y = NAN;
+    return set_type(std::move(curve.x), std::move(curve.y));
+  }
+
+  /*!
+
+\fn DefaultModel::set_type DefaultModel::PlotImplicit
+\brief Overrides the base class PlotImplicit function.
+\details The expression may use the second variable y. It is compiled once
+while the same expression is plotted, and traced by ImplicitPlotter: a
+coarse grid rejects most of the range, and only the cells crossed by the
+curve are refined.
+\param expression The expression of f, a function of x and y.
+\param x_left Left boundary of the X range.
+\param x_right Right boundary of the X range.
+\param y_min Lower boundary of the Y range.
+\param y_max Upper boundary of the Y range.
+\return The ends of the segments, each segment followed by a NaN point.
+\exception BadExpression If the expression or the range is invalid.
+*/
+
+  set_type PlotImplicit(const std::string& expression, double x_left,
+                        double x_right, double y_min, double y_max) override {
+    if (!(x_left < x_right) || !(y_min < y_max))
+      throw BadExpression("Invalid set borders");
+    if (implicit_expression_.empty() || expression != implicit_expression_) {
+      ParseError error = CheckLength(expression);
+      if (error.Failed()) throw BadExpression(error);
+      implicit_compiler_.AllowY(true);
+      Program program = implicit_compiler_.Compile(expression);
+      if (!program.Valid()) throw BadExpression(program.Status());
+      implicit_program_ = std::move(program);
+      implicit_expression_ = expression;
+    }
+    ScopedStage stage(Stage::kPlot);
+    return implicit_.Plot(implicit_program_.View(), x_left, x_right, y_min,
+                          y_max);
+  }
+
+  /*!
+
+\fn RangeStats DefaultModel::Analyze
+\brief Overrides the base class Analyze function.
+\details The expression is evaluated exactly, in parallel chunks reduced on
+the fly by RangeScanner, so no values are stored.
+\param x_left Left boundary of the range, the first sample.
+\param x_right Right boundary of the range, the last sample.
+\param samples Number of samples, at least 2.
+\return The statistics of the values.
+\exception BadExpression If the expression was not compiled or the range is
+invalid.
+*/
+
+  RangeStats Analyze(double x_left, double x_right,
+                     std::size_t samples) override {
+    if (!program_.Valid()) throw BadExpression(program_.Status());
+    if (!(x_left <= x_right) || !std::isfinite(x_left) ||
+        !std::isfinite(x_right))
+      throw BadExpression("Invalid set borders");
+    if (samples < 2) throw BadExpression("Range needs at least 2 samples");
+    ScopedStage stage(Stage::kCalculate, samples);
+    return scanner_.Scan(program_.View(), x_left, x_right, samples);
+  }
+
+  /*!
+
+\fn void DefaultModel::Define
+\brief Overrides the base class Define function.
+\details The body is compiled with the earlier definitions inlined, and a
+constant is evaluated once, so the expressions using a name get its
+definition at the time they are compiled: redefining a name changes the later
+expressions and the current one, which is compiled again, but not the
+functions defined before. The size limit applies to the body only, not to the
+expressions the definition is inlined into.
+\param name A name accepted by Tokenizer::IsName.
+\param parameter The parameter of the function, x, y or a name accepted by
+Tokenizer::IsName; empty for a constant.
+\param body The expression of the function of the parameter, or of the
+constant.
+\exception BadExpression If the name, the parameter or the body is invalid,
+or the body of a constant depends on x; the definitions are kept then.
+*/
+
+  void Define(const std::string& name, const std::string& parameter,
+              const std::string& body) override {
+    if (!Tokenizer::IsName(name)) throw BadExpression("Invalid name");
+    if (!parameter.empty() && parameter != "x" && parameter != "y" &&
+        !Tokenizer::IsName(parameter))
+      throw BadExpression("Invalid parameter");
+    ParseError error = CheckLength(body);
+    if (error.Failed()) throw BadExpression(error);
+    ShuntingYardCompiler compiler;
+    compiler.UseDefinitions(definitions_);
+    if (!parameter.empty()) compiler.SetParameter(parameter);
+    Program program = compiler.Compile(body);
+    if (!program.Valid()) throw BadExpression(program.Status());
+    auto definitions = std::make_shared<Definitions>();
+    if (definitions_) *definitions = *definitions_;
+    if (!parameter.empty()) {
+      definitions->DefineFunction(name, std::move(program));
+    } else {
+      for (const Instruction& instruction : program.Code())
+        if (instruction.op == Opcode::kArg)
+          throw BadExpression("Constant depends on x");
+      definitions->DefineConstant(
+          name, Evaluator<double>().Calculate(program.View(), 0));
+    }
+    definitions_ = std::move(definitions);
+    compiler_.UseDefinitions(definitions_);
+    curve_compiler_.UseDefinitions(definitions_);
+    implicit_compiler_.UseDefinitions(definitions_);
+    overlay_compiler_.UseDefinitions(definitions_);
+    if (!input_expression_.empty()) {
+      ParseResult result = compiler_.TryCompile(input_expression_);
+      program_ = std::move(result.program);
+      program_.Fail(result.error);
+      ++program_id_;
+    }
+    overlay_expressions_.clear();
+    curve_components_.clear();
+    implicit_expression_.clear();
+    approximation_.Clear();
+  }
+
+  /*!
+
 \fn void DefaultModel::setExpression
 \brief Overrides the setExpression function from the base class.
 \details Updates the expression being used by the DefaultModel.
@@ -96,14 +513,46 @@ Right boundary of the X range. \param y_min Lower boundary of the Y range.
 */
 
   void setExpression(const std::string_view& expression) override {
-    if (!expression.size()) throw BadExpression("Empty expression");
-    if (expression.size() > kExprMaxSize)
-      throw BadExpression("Expression is too long");
-    if (expression.compare(input_expression_.c_str())) {
-      reverse_polish_notation_ =
-          to_polish_.Translate(tokenizer_.Tokenize(expression));
+    Assign(expression, false);
+  }
+
+  /*!
+
+\fn ParseResult DefaultModel::TrySetExpression
+\brief Sets the expression without throwing on invalid input.
+\details The current expression is kept if the new one is rejected.
+\param expression The expression to be set.
+\return The compiled program, or the error and the position of the offending
+token, with the fixes applied to the expression.
+*/
+
+  ParseResult TrySetExpression(const std::string_view& expression) {
+    ParseResult result;
+    result.error = CheckLength(expression);
+    if (result.error.Failed()) return result;
+    result = compiler_.TryCompile(expression);
+    overlay_plotted_ = false;
+    if (result) {
+      program_ = result.program;
+      ++program_id_;
+      approximation_.Clear();
       input_expression_ = std::string(expression.begin(), expression.end());
     }
+    return result;
+  }
+
+  /*!
+
+\fn void DefaultModel::EditExpression
+\brief Overrides the EditExpression function from the base class.
+\details Recompiles only the part of the expression after the first symbol
+that differs from the previously edited expression.
+\param expression The expression to be set.
+\exception BadExpression If the provided expression is empty or too long.
+*/
+
+  void EditExpression(const std::string_view& expression) override {
+    Assign(expression, true);
   }
 
   /*!
@@ -111,16 +560,256 @@ Right boundary of the X range. \param y_min Lower boundary of the Y range.
 \fn bool DefaultModel::ExressionChanged
 \brief Overrides the ExressionChanged function from the base class.
 \details Checks if the input_expression_ has changed since the last calculation.
+After PlotOverlay, checks the plotted expressions instead.
 \return True if the input_expression_ has changed, false otherwise.
 */
 
   bool ExressionChanged() noexcept override {
-    return tokenizer_.ExpressionChanged();
+    return overlay_plotted_ ? overlay_fixed_ : compiler_.ExpressionChanged();
   }
 
+  /*!
+
+\fn PipelineStats DefaultModel::Stats
+\brief Overrides the Stats function from the base class.
+\details Reads the process-wide counters, see CollectStats.
+\return Snapshot of the per-stage counters of the pipeline.
+*/
+
+  PipelineStats Stats() const override { return CollectStats(); }
+
+  /*!
+
+\fn void DefaultModel::ResetStats
+\brief Overrides the ResetStats function from the base class.
+\details Resets the process-wide counters, see s21::ResetStats.
+*/
+
+  void ResetStats() override { s21::ResetStats(); }
+
  private:
   /*!
 
+\private
+\fn void DefaultModel::Assign
+\brief Compiles the expression if it differs from the current one.
+\param expression The expression to be set.
+\param edit Whether to recompile the previously edited expression.
+\exception BadExpression If the provided expression is empty or too long.
+*/
+
+  void Assign(const std::string_view& expression, bool edit) {
+    ParseError error = CheckLength(expression);
+    if (error.Failed()) throw BadExpression(error);
+    overlay_plotted_ = false;
+    if (expression.compare(input_expression_.c_str())) {
+      program_ = edit ? compiler_.Recompile(expression)
+                      : compiler_.Compile(expression);
+      ++program_id_;
+      approximation_.Clear();
+      input_expression_ = std::string(expression.begin(), expression.end());
+    }
+  }
+
+  /*!
+
+\private
+\fn ParseError DefaultModel::CheckLength
+\brief Checks the expression is neither empty nor too long.
+\param expression The expression to be checked.
+\return The error, not set if the length is acceptable.
+*/
+
+  ParseError CheckLength(const std::string_view& expression) const noexcept {
+    if (expression.empty()) return {ErrorCode::kEmpty};
+    if (expression.size() > max_size_)
+      return {ErrorCode::kTooLong, max_size_, expression.size() - max_size_};
+    return {};
+  }
+
+  /*!
+
+\private
+\fn bool DefaultModel::SingleResolves
+\brief Checks if float tells apart the values of the range kRangeFinesse
+steps apart.
+\param low Lower boundary of the range.
+\param high Upper boundary of the range.
+\return true if the range is within the float limits and the float spacing
+is well below the step.
+*/
+
+  static bool SingleResolves(double low, double high) noexcept {
+    double magnitude = std::max(std::fabs(low), std::fabs(high));
+    if (!(magnitude <= std::numeric_limits<float>::max())) return false;
+    double spacing = magnitude * std::numeric_limits<float>::epsilon();
+    return spacing * 16 <= (high - low) / kRangeFinesse;
+  }
+
+  /*!
+
+\private
+\fn bool DefaultModel::SingleHolds
+\brief Checks if every constant of the program is a normal float or zero.
+\details A constant beyond the float limits turns into infinity, and one
+below the normal range loses its digits, so a result that is finite in double
+precision may come out as NaN in single precision.
+\param program The program to plot.
+\return true if every constant keeps its precision in float.
+*/
+
+  static bool SingleHolds(const ProgramView& program) noexcept {
+    for (const Instruction& instruction : program) {
+      if (instruction.op != Opcode::kNumber) continue;
+      double magnitude = std::fabs(instruction.value);
+      if (magnitude != 0 &&
+          !(magnitude >= std::numeric_limits<float>::min() &&
+            magnitude <= std::numeric_limits<float>::max()))
+        return false;
+    }
+    return true;
+  }
+
+  /*!
+
+\private
+\fn void DefaultModel::Hide
+\brief Replaces the values with any LaneStatus bit by NaN, without branches.
+\param y Array of n values.
+\param status Array of n LaneStatus masks of the values.
+\param n Number of values.
+*/
+
+  static void Hide(double* y, const unsigned char* status,
+                   std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) y[i] = status[i] ? NAN : y[i];
+  }
+
+  /*!
+
+\private
+\fn void DefaultModel::CalculateSingle
+\brief Evaluates the program for the plot in single precision.
+\param x The variable values.
+\param y The results, of the same size as x.
+\exception BadExpression If the program carries a compilation error.
+*/
+
+  void CalculateSingle(const std::vector<double>& x, std::vector<double>& y) {
+    if (!program_.Valid()) throw BadExpression(program_.Status());
+    ScopedStage stage(Stage::kCalculate, x.size());
+    std::vector<float> x_single(x.begin(), x.end()), y_single(x.size());
+    single_.Calculate(program_.View(), x_single.data(), y_single.data(),
+                      x.size());
+    std::copy(y_single.begin(), y_single.end(), y.begin());
+  }
+
+  /*!
+
+\private
+\fn void DefaultModel::FuseOverlay
+\brief Compiles the expressions and merges them into the overlay program.
+\details The expressions are compiled by their own compiler, so the
+checkpoints of the input expression are kept for EditExpression.
+\param expressions The expressions to plot.
+\exception BadExpression If any of the expressions is invalid; the previous
+overlay is kept then.
+*/
+
+  void FuseOverlay(const std::vector<std::string>& expressions) {
+    std::vector<Program> programs;
+    bool fixed = false;
+    for (const std::string& expression : expressions) {
+      ParseError error = CheckLength(expression);
+      if (error.Failed()) throw BadExpression(error);
+      ParseResult result = overlay_compiler_.TryCompile(expression);
+      if (!result) throw BadExpression(result.error);
+      fixed |= !result.fixes.empty();
+      programs.push_back(std::move(result.program));
+    }
+    std::vector<ProgramView> views;
+    for (const Program& program : programs) views.push_back(program.View());
+    overlay_.Fuse(views);
+    overlay_expressions_ = expressions;
+    overlay_fixed_ = fixed;
+  }
+
+  /*!
+
+\private
+\fn void DefaultModel::SetCurve
+\brief Compiles the components of a curve and merges them into the sampler.
+\param kind The kind of the curve.
+\param components The expressions of the components in t. The parameter
+shadows a constant t, and x is not a variable of the components.
+\exception BadExpression If any of the components is invalid or their number
+does not match the kind; the previous curve is kept then.
+*/
+
+  void SetCurve(CurveKind kind, const std::vector<std::string>& components) {
+    std::size_t count = kind == CurveKind::kPolar ? 1 : 2;
+    if (components.size() != count)
+      throw BadExpression(kind == CurveKind::kPolar
+                              ? "Polar curve needs one component"
+                              : "Parametric curve needs two components");
+    std::vector<Program> programs;
+    for (const std::string& component : components) {
+      ParseError error = CheckLength(component);
+      if (error.Failed()) throw BadExpression(error);
+      curve_compiler_.SetParameter("t");
+      programs.push_back(curve_compiler_.Compile(component));
+      if (!programs.back().Valid())
+        throw BadExpression(programs.back().Status());
+    }
+    std::vector<ProgramView> views;
+    for (const Program& program : programs) views.push_back(program.View());
+    curve_.Set(kind, views);
+    curve_kind_ = kind;
+    curve_components_ = components;
+  }
+
+  /*!
+
+\private
+\fn void DefaultModel::CalculateApproximated
+\brief Evaluates the plot by the approximation, fitting it first if the
+samples are outside of the fitted domain.
+\param x The variable values, sorted.
+\param y The results, of the same size as x.
+\exception BadExpression If the program carries a compilation error.
+*/
+
+  void CalculateApproximated(const std::vector<double>& x,
+                             std::vector<double>& y) {
+    if (!program_.Valid()) throw BadExpression(program_.Status());
+    if (x.empty()) return;
+    if (!approximation_.Covers(x.front(), x.back())) {
+      double margin = x.back() - x.front();
+      approximation_.Fit(
+          [this](const double* px, double* py, std::size_t n) {
+            calc_.Calculate(program_, px, py, n);
+          },
+          x.front() - margin, x.back() + margin, tolerance_);
+    }
+    std::vector<std::size_t> exact;
+    for (std::size_t i = 0; i < x.size(); ++i)
+      if (!approximation_.Calculate(x[i], y[i])) exact.push_back(i);
+    if (exact.empty()) return;
+    std::vector<double> exact_x(exact.size()), exact_y(exact.size());
+    for (std::size_t i = 0; i < exact.size(); ++i) exact_x[i] = x[exact[i]];
+    calc_.Calculate(program_, exact_x.data(), exact_y.data(), exact.size());
+    for (std::size_t i = 0; i < exact.size(); ++i) y[exact[i]] = exact_y[i];
+  }
+
+  /*!
+
+\private
+\var DefaultModel::max_size_
+\brief Maximum size of the expression in bytes.
+*/
+  std::size_t max_size_;
+  /*!
+
 \private
 \var DefaultModel::input_expression_
 \brief A string representing the input expression for the DefaultModel.
@@ -129,36 +818,188 @@ Right boundary of the X range. \param y_min Lower boundary of the Y range.
   /*!
 
 \private
-\var DefaultModel::reverse_polish_notation_
-\brief A list of strings representing the reverse Polish notation of the input
-expression.
+\var DefaultModel::program_
+\brief The input expression compiled into postfix bytecode.
 */
-  std::list<std::string> reverse_polish_notation_;
+  Program program_;
+  /*!
 
+\private
+\var DefaultModel::program_id_
+\brief The id of program_ in the result cache, bumped on every compilation.
+*/
+  std::uint64_t program_id_ = 0;
+  /*!
+
+\private
+\var DefaultModel::cache_
+\brief The memoized results of Calculate.
+*/
+  ResultCache cache_;
   /*!
 
 \private
-\var DefaultModel::tokenizer_
-\brief Tokenizer object responsible for splitting the input expression into
-smaller tokens.
+\var DefaultModel::cache_enabled_
+\brief Whether the results of Calculate are cached.
 */
-  Tokenizer tokenizer_;
+  bool cache_enabled_ = true;
+
   /*!
 
 \private
-\var DefaultModel::to_polish_
-\brief ShuntingYardTranslator object responsible for translating the tokenized
-expression into the reverse Polish notation.
+\var DefaultModel::compiler_
+\brief ShuntingYardCompiler object responsible for compiling the input
+expression into postfix bytecode in a single pass.
 */
-  ShuntingYardTranslator to_polish_;
+  ShuntingYardCompiler compiler_;
   /*!
 
 \private
 \var DefaultModel::calc_
 \brief RPNCalculator object responsible for performing calculations using the
-reverse Polish notation.
+compiled program.
 */
   RPNCalculator calc_;
+  /*!
+
+\private
+\var DefaultModel::single_
+\brief Evaluator of the plot in single precision.
+*/
+  Evaluator<float> single_;
+  /*!
+
+\private
+\var DefaultModel::precision_
+\brief Scalar type of the plot evaluation.
+*/
+  Precision precision_ = Precision::kDouble;
+  /*!
+
+\private
+\var DefaultModel::tolerance_
+\brief Maximum error of the approximation, 0 if it is disabled.
+*/
+  double tolerance_ = 0;
+  /*!
+
+\private
+\var DefaultModel::approximation_
+\brief Approximation of the expression over the last plot domain.
+*/
+  Approximation approximation_;
+  /*!
+
+\private
+\var DefaultModel::overlay_expressions_
+\brief The expressions merged into the overlay program.
+*/
+  std::vector<std::string> overlay_expressions_;
+  /*!
+
+\private
+\var DefaultModel::plot_status_
+\brief LaneStatus masks of the values of every set of the last plot.
+*/
+  status_type plot_status_;
+  /*!
+
+\private
+\var DefaultModel::overlay_
+\brief The overlay program, evaluating all plotted expressions at once.
+*/
+  FusedProgram overlay_;
+  /*!
+
+\private
+\var DefaultModel::overlay_compiler_
+\brief The compiler of the overlay expressions.
+*/
+  ShuntingYardCompiler overlay_compiler_;
+  /*!
+
+\private
+\var DefaultModel::overlay_fixed_
+\brief Whether any of the overlay expressions had to be fixed.
+*/
+  bool overlay_fixed_ = false;
+  /*!
+
+\private
+\var DefaultModel::overlay_plotted_
+\brief Whether the last plot was an overlay.
+*/
+  bool overlay_plotted_ = false;
+  /*!
+
+\private
+\var DefaultModel::curve_kind_
+\brief The kind of the curve set to the sampler.
+*/
+  CurveKind curve_kind_ = CurveKind::kParametric;
+  /*!
+
+\private
+\var DefaultModel::curve_components_
+\brief The components of the curve set to the sampler.
+*/
+  std::vector<std::string> curve_components_;
+  /*!
+
+\private
+\var DefaultModel::curve_compiler_
+\brief The compiler of the curve components, with t as the variable.
+*/
+  ShuntingYardCompiler curve_compiler_;
+  /*!
+
+\private
+\var DefaultModel::curve_
+\brief The sampler of the last plotted curve.
+*/
+  CurveSampler curve_;
+  /*!
+
+\private
+\var DefaultModel::implicit_expression_
+\brief The expression of the last plotted implicit curve.
+*/
+  std::string implicit_expression_;
+  /*!
+
+\private
+\var DefaultModel::implicit_compiler_
+\brief The compiler of the implicit curves, with y as a variable.
+*/
+  ShuntingYardCompiler implicit_compiler_;
+  /*!
+
+\private
+\var DefaultModel::implicit_program_
+\brief The program of the last plotted implicit curve.
+*/
+  Program implicit_program_;
+  /*!
+
+\private
+\var DefaultModel::implicit_
+\brief The tracer of the implicit curves.
+*/
+  ImplicitPlotter implicit_;
+  /*!
+
+\private
+\var DefaultModel::definitions_
+\brief The user-defined functions and constants, shared with the compilers.
+*/
+  std::shared_ptr<const Definitions> definitions_;
+  /*!
+
+\private
+\var DefaultModel::scanner_
+\brief The scanner of the range statistics.
+*/
+  RangeScanner scanner_;
 };
 }  // namespace s21
 
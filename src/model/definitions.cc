@@ -0,0 +1,37 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "definitions.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace s21 {
+std::pair<const Definitions::Definition*, std::size_t> Definitions::Match(
+    std::string_view text) const noexcept {
+  for (std::size_t size = std::min(longest_, text.size()); size; --size)
+    if (const Definition* definition = Find(text.substr(0, size)))
+      return {definition, size};
+  return {nullptr, 0};
+}
+
+const Definitions::Definition* Definitions::Find(
+    std::string_view name) const noexcept {
+  auto definition = definitions_.find(name);
+  return definition != definitions_.end() ? &definition->second : nullptr;
+}
+
+void Definitions::DefineConstant(const std::string& name, double value) {
+  Definition& definition = definitions_[name];
+  definition.function = false;
+  definition.value = value;
+  definition.body = Program();
+  longest_ = std::max(longest_, name.size());
+}
+
+void Definitions::DefineFunction(const std::string& name, Program body) {
+  Definition& definition = definitions_[name];
+  definition.function = true;
+  definition.value = 0;
+  definition.body = std::move(body);
+  longest_ = std::max(longest_, name.size());
+}
+}  // namespace s21
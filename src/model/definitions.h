@@ -0,0 +1,83 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file definitions.h
+ * @brief Header file for the Definitions class, the user-defined functions
+ * and constants of a session.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_DEFINITIONS_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_DEFINITIONS_H_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "program.h"
+
+namespace s21 {
+/**
+ * @class Definitions
+ * @brief User-defined functions of one variable and constants.
+ * @details A function is kept compiled, with its parameter read as the
+ * variable x, so that the compiler inlines its bytecode into the callers; a
+ * constant is kept as its value. The definitions are shared by the compilers
+ * as immutable snapshots: a new definition makes a new set.
+ */
+class Definitions final {
+ public:
+  /**
+   * @struct Definition
+   * @brief A user-defined function or constant.
+   */
+  struct Definition {
+    bool function = false; /**< Whether it is a function or a constant*/
+    double value = 0;      /**< Value of the constant*/
+    Program body;          /**< Valid program of the function*/
+  };
+
+  /**
+   * @brief Matches the longest defined name at the start of the text.
+   * @param text The text to match.
+   * @return The definition and the length of its name, nullptr and 0 if no
+   * name is defined there.
+   */
+  std::pair<const Definition*, std::size_t> Match(
+      std::string_view text) const noexcept;
+
+  /**
+   * @brief Finds the definition of the name.
+   * @param name The name.
+   * @return The definition, nullptr if the name is not defined.
+   */
+  const Definition* Find(std::string_view name) const noexcept;
+
+  /**
+   * @brief Defines a constant, replacing the previous definition of the name.
+   * @param name A name accepted by Tokenizer::IsName.
+   * @param value The value.
+   */
+  void DefineConstant(const std::string& name, double value);
+
+  /**
+   * @brief Defines a function, replacing the previous definition of the name.
+   * @param name A name accepted by Tokenizer::IsName.
+   * @param body Valid program of the function of x.
+   */
+  void DefineFunction(const std::string& name, Program body);
+
+  /**
+   * @brief Returns the number of definitions.
+   * @return The number of the defined names.
+   */
+  std::size_t Size() const noexcept { return definitions_.size(); }
+
+ private:
+  /** Definitions by name*/
+  std::map<std::string, Definition, std::less<>> definitions_;
+  std::size_t longest_ = 0; /**< Length of the longest name*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_DEFINITIONS_H_
@@ -0,0 +1,303 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file evaluator.h
+ * @brief Header file for the Evaluator class template, which evaluates
+ * compiled programs in the given scalar type.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_EVALUATOR_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_EVALUATOR_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "program.h"
+
+namespace s21 {
+/**
+ * @enum LaneStatus
+ * @brief Bits of the status of an evaluated value, 0 if it is visible.
+ */
+enum LaneStatus : unsigned char {
+  kLaneDomain = 1,    /**< NaN: an argument out of the domain of a function*/
+  kLaneOverflow = 2,  /**< Infinite: a pole or an overflow*/
+  kLaneOutOfRange = 4 /**< Below or above the visible range, or infinite*/
+};
+
+/**
+ * @class Evaluator
+ * @brief Evaluates valid bytecode in float, double or long double.
+ * @details Batches are evaluated a block of kLanes arguments at a time: every
+ * instruction is applied to the whole block before the next one, so the
+ * operation is dispatched once per block and the inner loops can be
+ * vectorized. A narrower type fits more lanes into a vector register. The
+ * immediate constants are stored as double, so long double evaluation is
+ * exact for the arithmetic but not for the literals.
+ * @tparam T The scalar type.
+ */
+template <class T>
+class Evaluator final {
+  static_assert(std::is_floating_point_v<T>,
+                "Evaluator needs a floating point type");
+
+ public:
+  /**
+   * @brief Number of arguments evaluated together in a batch.
+   */
+  static constexpr std::size_t kLanes = 256 / sizeof(T);
+
+  /**
+   * @brief Evaluates the bytecode.
+   * @param program View of a valid program.
+   * @param x The variable value.
+   * @param y The value of the second variable.
+   * @return The result of the evaluation.
+   */
+  T Calculate(const ProgramView& program, T x, T y = 0) {
+    Reserve(program.MaxDepth());
+    T* top = values_.data();
+    for (const Instruction& instruction : program) {
+      if (instruction.op == Opcode::kNumber) {
+        *top++ = static_cast<T>(instruction.value);
+      } else if (instruction.op == Opcode::kArg) {
+        *top++ = x;
+      } else if (instruction.op == Opcode::kArgY) {
+        *top++ = y;
+      } else if (instruction.op == Opcode::kLoad) {
+        *top++ = values_[static_cast<std::size_t>(instruction.value)];
+      } else if (Arity(instruction.op) == 1) {
+        top[-1] = Apply(instruction.op, 0, top[-1]);
+      } else {
+        --top;
+        top[-1] = Apply(instruction.op, top[-1], top[0]);
+      }
+    }
+    return values_.front();
+  }
+
+  /**
+   * @brief Evaluates the bytecode for every argument value.
+   * @details The second variable is 0.
+   * @param program View of a valid program.
+   * @param x Array of n variable values.
+   * @param y Array of n results, filled by the call.
+   * @param n Number of values.
+   */
+  void Calculate(const ProgramView& program, const T* x, T* y,
+                 std::size_t n) {
+    Run(program, x, nullptr, y, n);
+  }
+
+  /**
+   * @brief Evaluates the bytecode of two variables for every pair of values.
+   * @param program View of a valid program.
+   * @param x Array of n variable values.
+   * @param y Array of n values of the second variable.
+   * @param f Array of n results, filled by the call.
+   * @param n Number of values.
+   */
+  void Calculate(const ProgramView& program, const T* x, const T* y, T* f,
+                 std::size_t n) {
+    Run(program, x, y, f, n);
+  }
+
+  /**
+   * @brief Evaluates the bytecode for every argument value, classifying the
+   * results as well.
+   * @details Every block is classified while it is still in the cache, with
+   * no branches, so the callers read the status instead of testing the
+   * values again.
+   * @param program View of a valid program.
+   * @param x Array of n variable values.
+   * @param y Array of n results, filled by the call.
+   * @param status Array of n LaneStatus masks of the results, filled by the
+   * call.
+   * @param y_min Lower boundary of the visible range.
+   * @param y_max Upper boundary of the visible range.
+   * @param n Number of values.
+   */
+  void Calculate(const ProgramView& program, const T* x, T* y,
+                 unsigned char* status, T y_min, T y_max, std::size_t n) {
+    for (std::size_t begin = 0; begin < n; begin += kLanes) {
+      std::size_t lanes = std::min(kLanes, n - begin);
+      Run(program, x + begin, nullptr, y + begin, lanes);
+      Classify(y + begin, status + begin, lanes, y_min, y_max);
+    }
+  }
+
+  /**
+   * @brief Classifies the values without branches.
+   * @param f Array of n values.
+   * @param status Array of n LaneStatus masks, filled by the call.
+   * @param n Number of values.
+   * @param y_min Lower boundary of the visible range.
+   * @param y_max Upper boundary of the visible range.
+   */
+  static void Classify(const T* f, unsigned char* status, std::size_t n,
+                       T y_min, T y_max) noexcept {
+    constexpr T kInfinity = std::numeric_limits<T>::infinity();
+    for (std::size_t i = 0; i < n; ++i) {
+      T value = f[i];
+      status[i] = static_cast<unsigned char>(
+          (value != value) * kLaneDomain |
+          (std::fabs(value) == kInfinity) * kLaneOverflow |
+          ((value < y_min) | (value > y_max)) * kLaneOutOfRange);
+    }
+  }
+
+  /**
+   * @brief Applies the operation to its operands.
+   * @param op The operation to apply.
+   * @param l The left operand, unused by unary operations.
+   * @param r The right (or the only) operand.
+   * @return The result of the operation.
+   */
+  static T Apply(Opcode op, T l, T r) noexcept {
+    switch (op) {
+      case Opcode::kMinus:
+        return -r;
+      case Opcode::kLn:
+        return std::log(r);
+      case Opcode::kSin:
+        return std::sin(r);
+      case Opcode::kCos:
+        return std::cos(r);
+      case Opcode::kTan:
+        return std::tan(r);
+      case Opcode::kCot:
+        return 1 / std::tan(r);
+      case Opcode::kExp:
+        return std::exp(r);
+      case Opcode::kLog:
+        return std::log10(r);
+      case Opcode::kAsin:
+        return std::asin(r);
+      case Opcode::kAcos:
+        return std::acos(r);
+      case Opcode::kAtan:
+        return std::atan(r);
+      case Opcode::kAcot:
+        return std::acos(T(0)) - std::atan(r);
+      case Opcode::kSqrt:
+        return std::sqrt(r);
+      case Opcode::kPow:
+        return std::pow(l, r);
+      case Opcode::kMod:
+        return std::fmod(l, r);
+      case Opcode::kAdd:
+        return l + r;
+      case Opcode::kSub:
+        return l - r;
+      case Opcode::kMul:
+        return l * r;
+      case Opcode::kDiv:
+        return l / r;
+      default:
+        return r;
+    }
+  }
+
+  /**
+   * @brief Applies the operation to every lane of its operands.
+   * @param op The operation to apply.
+   * @param l The left (or the only) operands, replaced by the results.
+   * @param r The right operands, the same as l for unary operations.
+   * @param lanes Number of lanes.
+   */
+  static void ApplyLanes(Opcode op, T* l, const T* r,
+                         std::size_t lanes) noexcept {
+    switch (op) {
+      case Opcode::kMinus:
+        return Map(l, r, lanes, [](T, T b) { return -b; });
+      case Opcode::kAdd:
+        return Map(l, r, lanes, [](T a, T b) { return a + b; });
+      case Opcode::kSub:
+        return Map(l, r, lanes, [](T a, T b) { return a - b; });
+      case Opcode::kMul:
+        return Map(l, r, lanes, [](T a, T b) { return a * b; });
+      case Opcode::kDiv:
+        return Map(l, r, lanes, [](T a, T b) { return a / b; });
+      case Opcode::kSqrt:
+        return Map(l, r, lanes, [](T, T b) { return std::sqrt(b); });
+      case Opcode::kNip:
+        return Map(l, r, lanes, [](T, T b) { return b; });
+      case Opcode::kPlus:
+        return;
+      default:
+        for (std::size_t i = 0; i < lanes; ++i) l[i] = Apply(op, l[i], r[i]);
+    }
+  }
+
+ private:
+  /**
+   * @brief Evaluates the bytecode a block of kLanes values at a time.
+   * @param program View of a valid program.
+   * @param x Array of n variable values.
+   * @param y Array of n values of the second variable, nullptr for 0.
+   * @param f Array of n results, filled by the call.
+   * @param n Number of values.
+   */
+  void Run(const ProgramView& program, const T* x, const T* y, T* f,
+           std::size_t n) {
+    Reserve(program.MaxDepth() * kLanes);
+    for (std::size_t begin = 0; begin < n; begin += kLanes) {
+      std::size_t lanes = std::min(kLanes, n - begin);
+      T* top = values_.data();
+      for (const Instruction& instruction : program) {
+        if (instruction.op == Opcode::kNumber) {
+          std::fill(top, top + lanes, static_cast<T>(instruction.value));
+          top += kLanes;
+        } else if (instruction.op == Opcode::kArg) {
+          std::copy(x + begin, x + begin + lanes, top);
+          top += kLanes;
+        } else if (instruction.op == Opcode::kArgY) {
+          if (y)
+            std::copy(y + begin, y + begin + lanes, top);
+          else
+            std::fill(top, top + lanes, T(0));
+          top += kLanes;
+        } else if (instruction.op == Opcode::kLoad) {
+          const T* slot =
+              values_.data() + static_cast<std::size_t>(instruction.value) *
+                                   kLanes;
+          std::copy(slot, slot + lanes, top);
+          top += kLanes;
+        } else if (Arity(instruction.op) == 1) {
+          ApplyLanes(instruction.op, top - kLanes, top - kLanes, lanes);
+        } else {
+          top -= kLanes;
+          ApplyLanes(instruction.op, top - kLanes, top, lanes);
+        }
+      }
+      std::copy(values_.data(), values_.data() + lanes, f + begin);
+    }
+  }
+
+  /**
+   * @brief Applies the function to every lane of the operands.
+   * @param l The left operands, replaced by the results.
+   * @param r The right operands, the same as l for unary operations.
+   * @param lanes Number of lanes.
+   * @param f The function.
+   */
+  template <class F>
+  static void Map(T* l, const T* r, std::size_t lanes, F f) noexcept {
+    for (std::size_t i = 0; i < lanes; ++i) l[i] = f(l[i], r[i]);
+  }
+
+  /**
+   * @brief Sizes the evaluation stack.
+   * @param size Number of values needed.
+   */
+  void Reserve(std::size_t size) {
+    if (values_.size() < size) values_.resize(size);
+  }
+
+  std::vector<T> values_; /**< Evaluation stack, reused between calls*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_EVALUATOR_H_
@@ -0,0 +1,129 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "fusedprogram.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <utility>
+
+namespace s21 {
+namespace {
+constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+
+struct Node {
+  Opcode op;
+  double value;
+  std::uint32_t left;
+  std::uint32_t right;
+};
+
+using Key = std::tuple<Opcode, std::uint64_t, std::uint32_t, std::uint32_t>;
+}  // namespace
+
+void FusedProgram::Fuse(const std::vector<ProgramView>& programs) {
+  std::vector<Node> nodes;
+  std::map<Key, std::uint32_t> numbers;
+  std::vector<std::uint32_t> results, stack;
+  for (const ProgramView& program : programs) {
+    stack.clear();
+    for (const Instruction& instruction : program) {
+      Opcode op = instruction.op;
+      if (op == Opcode::kLoad) {
+        stack.push_back(stack[static_cast<std::size_t>(instruction.value)]);
+        continue;
+      }
+      std::uint32_t left = kNone, right = kNone;
+      if (Arity(op) == 2) {
+        right = stack.back();
+        stack.pop_back();
+      }
+      if (Arity(op) >= 1) {
+        left = stack.back();
+        stack.pop_back();
+      }
+      if (op == Opcode::kPlus || op == Opcode::kNip) {
+        stack.push_back(op == Opcode::kPlus ? left : right);
+        continue;
+      }
+      if ((op == Opcode::kAdd || op == Opcode::kMul) && right < left)
+        std::swap(left, right);
+      std::uint64_t bits = 0;
+      if (op == Opcode::kNumber)
+        std::memcpy(&bits, &instruction.value, sizeof(bits));
+      auto number = numbers.emplace(Key(op, bits, left, right),
+                                    static_cast<std::uint32_t>(nodes.size()));
+      if (number.second) nodes.push_back({op, instruction.value, left, right});
+      stack.push_back(number.first->second);
+    }
+    results.push_back(stack.back());
+  }
+
+  std::vector<std::uint32_t> last_use(nodes.size());
+  std::vector<std::vector<std::uint32_t>> stores(nodes.size());
+  for (std::uint32_t i = 0; i < nodes.size(); ++i) {
+    last_use[i] = i;
+    if (nodes[i].left != kNone) last_use[nodes[i].left] = i;
+    if (nodes[i].right != kNone) last_use[nodes[i].right] = i;
+  }
+  for (std::uint32_t j = 0; j < results.size(); ++j)
+    stores[results[j]].push_back(j);
+
+  steps_.clear();
+  stores_.clear();
+  slots_ = 0;
+  std::vector<std::uint32_t> slot(nodes.size()), free;
+  for (std::uint32_t i = 0; i < nodes.size(); ++i) {
+    const Node& node = nodes[i];
+    bool reuse = node.left != kNone && last_use[node.left] == i;
+    std::uint32_t out;
+    if (reuse) {
+      out = slot[node.left];
+    } else if (!free.empty()) {
+      out = free.back();
+      free.pop_back();
+    } else {
+      out = static_cast<std::uint32_t>(slots_++);
+    }
+    std::uint32_t first = static_cast<std::uint32_t>(stores_.size());
+    stores_.insert(stores_.end(), stores[i].begin(), stores[i].end());
+    steps_.push_back({node.op, node.value, out,
+                      node.left != kNone ? slot[node.left] : out,
+                      node.right != kNone ? slot[node.right] : out, first,
+                      static_cast<std::uint32_t>(stores_.size())});
+    if (node.right != kNone && node.right != node.left &&
+        last_use[node.right] == i)
+      free.push_back(slot[node.right]);
+    if (node.left != kNone && !reuse && last_use[node.left] == i)
+      free.push_back(slot[node.left]);
+    if (last_use[i] == i) free.push_back(out);
+    slot[i] = out;
+  }
+  outputs_ = programs.size();
+}
+
+void FusedProgram::Calculate(const double* x, std::size_t n, double* const* y) {
+  if (values_.size() < slots_ * kLanes) values_.resize(slots_ * kLanes);
+  for (std::size_t begin = 0; begin < n; begin += kLanes) {
+    std::size_t lanes = std::min(kLanes, n - begin);
+    for (const Step& step : steps_) {
+      double* out = values_.data() + step.out * kLanes;
+      if (step.op == Opcode::kNumber) {
+        std::fill(out, out + lanes, step.value);
+      } else if (step.op == Opcode::kArg) {
+        std::copy(x + begin, x + begin + lanes, out);
+      } else if (step.op == Opcode::kArgY) {
+        std::fill(out, out + lanes, 0.0);
+      } else {
+        const double* left = values_.data() + step.left * kLanes;
+        if (left != out) std::copy(left, left + lanes, out);
+        Evaluator<double>::ApplyLanes(
+            step.op, out, values_.data() + step.right * kLanes, lanes);
+      }
+      for (std::uint32_t k = step.first; k < step.last; ++k)
+        std::copy(out, out + lanes, y[stores_[k]] + begin);
+    }
+  }
+}
+}  // namespace s21
@@ -0,0 +1,90 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file fusedprogram.h
+ * @brief Header file for the FusedProgram class, which evaluates several
+ * programs in a single pass, sharing their common subexpressions.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_FUSEDPROGRAM_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_FUSEDPROGRAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "evaluator.h"
+#include "program.h"
+
+namespace s21 {
+/**
+ * @class FusedProgram
+ * @brief Several programs merged into a single graph of operations.
+ * @details Every operation is numbered by its opcode, immediate value and
+ * operands (sorted for addition and multiplication), so a subexpression
+ * shared by any of the programs, or repeated within one, is computed once.
+ * The operations are evaluated over blocks of kLanes arguments, in slots
+ * reused as soon as their value is dead; the results are written to the
+ * output of every program they belong to as soon as they are computed.
+ */
+class FusedProgram final {
+ public:
+  /**
+   * @brief Number of arguments evaluated together.
+   */
+  static constexpr std::size_t kLanes = Evaluator<double>::kLanes;
+
+  /**
+   * @brief Merges the programs, replacing the previous ones.
+   * @param programs Views of valid programs.
+   */
+  void Fuse(const std::vector<ProgramView>& programs);
+
+  /**
+   * @brief Evaluates every program for every argument value.
+   * @param x Array of n variable values.
+   * @param n Number of values.
+   * @param y Array of output arrays, one per program, of n results each.
+   */
+  void Calculate(const double* x, std::size_t n, double* const* y);
+
+  /**
+   * @brief Returns the number of merged programs.
+   * @return The number of outputs.
+   */
+  std::size_t Outputs() const noexcept { return outputs_; }
+
+  /**
+   * @brief Returns the number of distinct operations.
+   * @return The number of operations evaluated per argument.
+   */
+  std::size_t Operations() const noexcept { return steps_.size(); }
+
+  /**
+   * @brief Returns the number of value slots.
+   * @return The number of blocks of kLanes values kept at once.
+   */
+  std::size_t Slots() const noexcept { return slots_; }
+
+ private:
+  /**
+   * @struct Step
+   * @brief An operation and the slots it reads and writes.
+   */
+  struct Step {
+    Opcode op;           /**< The operation*/
+    double value;        /**< Immediate operand of kNumber*/
+    std::uint32_t out;   /**< Slot of the result*/
+    std::uint32_t left;  /**< Slot of the left (or the only) operand*/
+    std::uint32_t right; /**< Slot of the right operand*/
+    std::uint32_t first; /**< First entry of the step in stores_*/
+    std::uint32_t last;  /**< End of the entries of the step in stores_*/
+  };
+
+  std::vector<Step> steps_;           /**< Operations in evaluation order*/
+  std::vector<std::uint32_t> stores_; /**< Programs receiving a result*/
+  std::size_t outputs_ = 0;           /**< Number of programs*/
+  std::size_t slots_ = 0;             /**< Number of slots*/
+  std::vector<double> values_;        /**< Slots, reused between calls*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_FUSEDPROGRAM_H_
@@ -0,0 +1,205 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "implicit.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <thread>
+
+#include "trace.h"
+
+namespace s21 {
+namespace {
+/**
+ * @struct Cell
+ * @brief Cell of the grid with f at its corners, counterclockwise from the
+ * lower left one.
+ */
+struct Cell {
+  double x;
+  double y;
+  double f[4];
+};
+
+/**
+ * @struct Segment
+ * @brief Piece of the curve inside a cell.
+ */
+struct Segment {
+  double x0;
+  double y0;
+  double x1;
+  double y1;
+};
+
+/**
+ * @brief Edges crossed by the curve for every sign pattern of the corners,
+ * in pairs, -1 terminated. The edges are numbered from the lower one
+ * counterclockwise, edge i joining corners i and (i + 1) % 4. Bit i of the
+ * pattern is set if f is positive at corner i. A saddle cell whose mean is
+ * positive uses the pattern of the opposite saddle.
+ */
+constexpr int kEdges[16][5] = {
+    {-1},          {3, 0, -1},    {0, 1, -1}, {3, 1, -1},
+    {1, 2, -1},    {3, 0, 1, 2},  {0, 2, -1}, {3, 2, -1},
+    {2, 3, -1},    {0, 2, -1},    {0, 1, 2, 3}, {1, 2, -1},
+    {3, 1, -1},    {0, 1, -1},    {3, 0, -1}, {-1}};
+
+bool Active(const Cell& cell) noexcept {
+  int finite = 0, positive = 0;
+  for (double f : cell.f) {
+    finite += std::isfinite(f);
+    positive += f > 0;
+  }
+  return finite && (finite < 4 || (positive && positive < 4));
+}
+
+/**
+ * @brief Adds the segments of a cell of the last level.
+ */
+void March(const Cell& cell, double w, double h,
+           std::vector<Segment>& segments) {
+  int pattern = 0;
+  double mean = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (!std::isfinite(cell.f[i])) return;
+    pattern |= (cell.f[i] > 0) << i;
+    mean += cell.f[i] / 4;
+  }
+  if ((pattern == 5 || pattern == 10) && mean > 0) pattern = 15 - pattern;
+  const double corner_x[] = {cell.x, cell.x + w, cell.x + w, cell.x};
+  const double corner_y[] = {cell.y, cell.y, cell.y + h, cell.y + h};
+  double point[2][2];
+  const int* edges = kEdges[pattern];
+  for (int k = 0; k < 4 && edges[k] >= 0; ++k) {
+    int a = edges[k], b = (a + 1) % 4;
+    double t = std::clamp(cell.f[a] / (cell.f[a] - cell.f[b]), 0.0, 1.0);
+    point[k % 2][0] = corner_x[a] + t * (corner_x[b] - corner_x[a]);
+    point[k % 2][1] = corner_y[a] + t * (corner_y[b] - corner_y[a]);
+    if (k % 2)
+      segments.push_back({point[0][0], point[0][1], point[1][0], point[1][1]});
+  }
+}
+
+/**
+ * @brief Traces a tile of the grid.
+ * @param column First coarse column of the tile.
+ * @param row First coarse row of the tile.
+ * @return The number of evaluations of f.
+ */
+std::size_t Trace(Evaluator<double>& evaluator, const ProgramView& program,
+                  std::size_t column, std::size_t row, double x_left,
+                  double y_min, double w, double h,
+                  std::vector<Segment>& segments) {
+  constexpr std::size_t kSide = ImplicitPlotter::kTileCells + 1;
+  std::vector<double> x, y, f;
+  for (std::size_t j = 0; j < kSide; ++j) {
+    for (std::size_t i = 0; i < kSide; ++i) {
+      x.push_back(x_left + w * static_cast<double>(column + i));
+      y.push_back(y_min + h * static_cast<double>(row + j));
+    }
+  }
+  f.resize(x.size());
+  evaluator.Calculate(program, x.data(), y.data(), f.data(), x.size());
+  std::size_t evaluations = x.size();
+
+  std::vector<Cell> cells, children;
+  for (std::size_t j = 0; j + 1 < kSide; ++j) {
+    for (std::size_t i = 0; i + 1 < kSide; ++i) {
+      std::size_t k = j * kSide + i;
+      Cell cell = {x[k], y[k],
+                   {f[k], f[k + 1], f[k + kSide + 1], f[k + kSide]}};
+      if (Active(cell)) cells.push_back(cell);
+    }
+  }
+  for (int level = 0; level < ImplicitPlotter::kRefinements; ++level) {
+    w /= 2;
+    h /= 2;
+    x.clear();
+    y.clear();
+    for (const Cell& cell : cells) {
+      const double dx[] = {w, 2 * w, w, 0, w};
+      const double dy[] = {0, h, 2 * h, h, h};
+      for (int k = 0; k < 5; ++k) {
+        x.push_back(cell.x + dx[k]);
+        y.push_back(cell.y + dy[k]);
+      }
+    }
+    f.resize(x.size());
+    evaluator.Calculate(program, x.data(), y.data(), f.data(), x.size());
+    evaluations += x.size();
+    children.clear();
+    for (std::size_t c = 0; c < cells.size(); ++c) {
+      const double* corner = cells[c].f;
+      const double* middle = f.data() + 5 * c;
+      double cx = cells[c].x, cy = cells[c].y;
+      const Cell quarters[] = {
+          {cx, cy, {corner[0], middle[0], middle[4], middle[3]}},
+          {cx + w, cy, {middle[0], corner[1], middle[1], middle[4]}},
+          {cx + w, cy + h, {middle[4], middle[1], corner[2], middle[2]}},
+          {cx, cy + h, {middle[3], middle[4], middle[2], corner[3]}}};
+      for (const Cell& quarter : quarters)
+        if (Active(quarter)) children.push_back(quarter);
+    }
+    cells.swap(children);
+  }
+  for (const Cell& cell : cells) March(cell, w, h, segments);
+  return evaluations;
+}
+}  // namespace
+
+ImplicitPlotter::ImplicitPlotter(std::size_t threads) : threads_(threads) {}
+
+std::size_t ImplicitPlotter::Threads() const noexcept {
+  return threads_ ? threads_
+                  : std::max(1u, std::thread::hardware_concurrency());
+}
+
+ImplicitPlotter::set_type ImplicitPlotter::Plot(const ProgramView& program,
+                                                double x_left, double x_right,
+                                                double y_min, double y_max) {
+  if (!threads_) threads_ = Threads();
+  evaluators_.resize(threads_);
+  constexpr std::size_t kTiles = kCoarseCells / kTileCells;
+  double w = (x_right - x_left) / kCoarseCells;
+  double h = (y_max - y_min) / kCoarseCells;
+  std::vector<std::vector<Segment>> tiles(kTiles * kTiles);
+  std::size_t threads = std::min(evaluators_.size(), tiles.size());
+  std::vector<std::exception_ptr> errors(threads);
+  std::atomic<std::size_t> next{0}, evaluations{0};
+
+  auto work = [&](std::size_t self) {
+    try {
+      std::size_t count = 0;
+      for (std::size_t tile = next++; tile < tiles.size(); tile = next++) {
+        ScopedTrace trace("ImplicitTile", "model");
+        count += Trace(evaluators_[self], program, tile % kTiles * kTileCells,
+                       tile / kTiles * kTileCells, x_left, y_min, w, h,
+                       tiles[tile]);
+      }
+      evaluations += count;
+    } catch (...) {
+      errors[self] = std::current_exception();
+      next = tiles.size();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (std::size_t i = 1; i < threads; ++i) pool.emplace_back(work, i);
+  work(0);
+  for (std::thread& thread : pool) thread.join();
+  for (const std::exception_ptr& error : errors)
+    if (error) std::rethrow_exception(error);
+  evaluations_ = evaluations;
+
+  set_type points;
+  for (const std::vector<Segment>& tile : tiles) {
+    for (const Segment& segment : tile) {
+      points.first.insert(points.first.end(), {segment.x0, segment.x1, NAN});
+      points.second.insert(points.second.end(), {segment.y0, segment.y1, NAN});
+    }
+  }
+  return points;
+}
+}  // namespace s21
@@ -0,0 +1,77 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file implicit.h
+ * @brief Header file for the ImplicitPlotter class, which traces the curve
+ * f(x, y) = 0 by marching squares.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_IMPLICIT_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_IMPLICIT_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "evaluator.h"
+#include "model_interface.h"
+#include "program.h"
+
+namespace s21 {
+/**
+ * @class ImplicitPlotter
+ * @brief Traces the curve f(x, y) = 0 over a rectangle of the plane.
+ * @details The rectangle is divided into kCoarseCells x kCoarseCells cells,
+ * grouped into square tiles of kTileCells cells that are traced in parallel,
+ * each thread with its own evaluator. A tile evaluates f at the corners of
+ * its cells in one batch. Only the cells where f changes its sign, or is
+ * defined at some corners only, are split in four, kRefinements times, with
+ * the new corners of all such cells of a level evaluated in one batch. The
+ * cells of the last level are turned into segments by marching squares, the
+ * saddle cells being resolved by the mean of the corners. A closed curve
+ * inside a single coarse cell may be missed.
+ */
+class ImplicitPlotter final {
+ public:
+  static constexpr std::size_t kCoarseCells = 64;
+  static constexpr std::size_t kTileCells = 8;
+  static constexpr int kRefinements = 4;
+
+  using set_type = ICalculationModel::set_type;
+
+  /**
+   * @brief Constructs the plotter.
+   * @param threads Number of threads, 0 for the number of cores.
+   */
+  explicit ImplicitPlotter(std::size_t threads = 0);
+
+  /**
+   * @brief Traces the curve.
+   * @param program View of a valid program of x and y.
+   * @param x_left Left boundary of the rectangle.
+   * @param x_right Right boundary of the rectangle.
+   * @param y_min Lower boundary of the rectangle.
+   * @param y_max Upper boundary of the rectangle.
+   * @return The ends of the segments, each segment followed by a NaN point.
+   */
+  set_type Plot(const ProgramView& program, double x_left, double x_right,
+                double y_min, double y_max);
+
+  /**
+   * @brief Returns the number of threads.
+   * @return The number of threads, including the calling one.
+   */
+  std::size_t Threads() const noexcept;
+
+  /**
+   * @brief Returns the number of evaluations of f by the last Plot.
+   * @return The number of points where f was evaluated.
+   */
+  std::size_t Evaluations() const noexcept { return evaluations_; }
+
+ private:
+  std::size_t threads_; /**< Number of threads, 0 resolved by the first Plot*/
+  /** Evaluators of the threads, created by the first Plot*/
+  std::vector<Evaluator<double>> evaluators_;
+  std::size_t evaluations_ = 0; /**< Evaluations of the last Plot*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_IMPLICIT_H_
@@ -1,11 +1,15 @@
 // Copyright 2023 School21 @gruntmet Snezhana Valeeva
 #ifndef CPP3_SMARTCALC_V2_SRC_MODEL_I_CALCULATION_MODEL_H_
 #define CPP3_SMARTCALC_V2_SRC_MODEL_I_CALCULATION_MODEL_H_
+#include <cmath>
+#include <cstddef>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "badexpression.h"
+#include "stats.h"
 
 /*!
 
@@ -16,6 +20,52 @@
 namespace s21 {
 /*!
 
+\enum CurveKind
+\brief Kinds of the curves given by a parameter t.
+*/
+enum class CurveKind {
+  kParametric, /**< (x(t), y(t))*/
+  kPolar       /**< r(t), with t as the polar angle*/
+};
+
+/*!
+
+\struct RangeStats
+\brief Summary of the values of the expression at equally spaced samples of
+a range.
+\details The statistics skip the non-finite values. The sign changes and the
+local extrema are listed in the order of x, up to kMaxEvents of each.
+*/
+struct RangeStats {
+  static constexpr std::size_t kMaxEvents = 1024;
+
+  /*!
+
+\struct RangeStats::Extremum
+\brief Local extremum of the samples.
+*/
+  struct Extremum {
+    double x;     /**< The sample at the extremum*/
+    double y;     /**< The value at the extremum*/
+    bool maximum; /**< Whether it is a maximum or a minimum*/
+  };
+
+  std::size_t samples = 0; /**< Number of samples*/
+  std::size_t finite = 0;  /**< Number of samples with finite values*/
+  double min = NAN;        /**< Minimal finite value*/
+  double argmin = NAN;     /**< First sample with the minimal value*/
+  double max = NAN;        /**< Maximal finite value*/
+  double argmax = NAN;     /**< First sample with the maximal value*/
+  double mean = NAN;       /**< Mean of the finite values*/
+  double integral = 0;     /**< Trapezoidal integral of the finite parts*/
+  /** Intervals between the neighbouring samples of the opposite signs, and
+   * the samples equal to 0 as empty intervals*/
+  std::vector<std::pair<double, double>> sign_changes;
+  std::vector<Extremum> extrema; /**< Strict local extrema of the samples*/
+};
+
+/*!
+
 \class ICalculationModel
 \brief Interface definition for a generic calculation model.
 */
@@ -31,6 +81,21 @@ of points.
 
   /*!
 
+\typedef ICalculationModel::overlay_type
+\brief Sets of points of several expressions over the same X coordinates.
+*/
+  using overlay_type = std::vector<set_type>;
+
+  /*!
+
+\typedef ICalculationModel::status_type
+\brief LaneStatus masks of the Y coordinates of every set of a plot, see
+PlotStatus.
+*/
+  using status_type = std::vector<std::vector<unsigned char>>;
+
+  /*!
+
 \fn ICalculationModel::~ICalculationModel
 \brief Virtual destructor for the ICalculationModel interface.
 */
@@ -63,6 +128,138 @@ of points.
 
   /*!
 
+\fn ICalculationModel::overlay_type ICalculationModel::PlotOverlay
+\brief Generates sets of points of several expressions in the specified
+range.
+\details The current expression is not changed by models that override it.
+The default implementation plots the expressions one after another, leaving
+the last one set.
+\param expressions The expressions to plot.
+\param x_left Left boundary of the X range.
+\param x_right Right boundary of the X range.
+\param y_min Lower boundary of the Y range.
+\param y_max Upper boundary of the Y range.
+\return A set of points for every expression, in the same order.
+*/
+
+  virtual overlay_type PlotOverlay(const std::vector<std::string>& expressions,
+                                   double x_left, double x_right, double y_min,
+                                   double y_max) {
+    overlay_type sets;
+    for (const std::string& expression : expressions) {
+      setExpression(expression);
+      sets.push_back(Plot(x_left, x_right, y_min, y_max));
+    }
+    return sets;
+  }
+
+  /*!
+
+\fn const ICalculationModel::status_type& ICalculationModel::PlotStatus
+\brief Returns the status of the values of the last Plot or PlotOverlay.
+\details Lets the later stages, e.g. Decimate, tell the domain errors, the
+poles and the clipped values apart without testing the values again. The
+default implementation does not classify the values.
+\return LaneStatus masks of the Y coordinates of every set, in the order of
+the sets, 0 for the visible ones; empty if the values are not classified.
+*/
+
+  virtual const status_type& PlotStatus() const noexcept {
+    static const status_type kUnclassified;
+    return kUnclassified;
+  }
+
+  /*!
+
+\fn ICalculationModel::set_type ICalculationModel::PlotCurve
+\brief Generates the points of a curve given by a parameter t.
+\details The current expression is not changed. The default implementation
+does not support curves.
+\param kind The kind of the curve.
+\param components The expressions of x(t) and y(t) for a parametric curve, of
+r(t) for a polar one.
+\param t_min Lower bound of the parameter.
+\param t_max Upper bound of the parameter.
+\param x_left Left boundary of the X range.
+\param x_right Right boundary of the X range.
+\param y_min Lower boundary of the Y range.
+\param y_max Upper boundary of the Y range.
+\return The points in the order of t, represented as a set_type object.
+\exception BadExpression If the curve is invalid or not supported.
+*/
+
+  virtual set_type PlotCurve(CurveKind /*kind*/,
+                             const std::vector<std::string>& /*components*/,
+                             double /*t_min*/, double /*t_max*/,
+                             double /*x_left*/, double /*x_right*/,
+                             double /*y_min*/, double /*y_max*/) {
+    throw BadExpression("Curves are not supported");
+  }
+
+  /*!
+
+\fn ICalculationModel::set_type ICalculationModel::PlotImplicit
+\brief Generates the segments of the curve f(x, y) = 0 in the specified
+range.
+\details The current expression is not changed. The default implementation
+does not support implicit curves.
+\param expression The expression of f, a function of x and y.
+\param x_left Left boundary of the X range.
+\param x_right Right boundary of the X range.
+\param y_min Lower boundary of the Y range.
+\param y_max Upper boundary of the Y range.
+\return The ends of the segments, each segment followed by a NaN point.
+\exception BadExpression If the expression is invalid or implicit curves are
+not supported.
+*/
+
+  virtual set_type PlotImplicit(const std::string& /*expression*/,
+                                double /*x_left*/, double /*x_right*/,
+                                double /*y_min*/, double /*y_max*/) {
+    throw BadExpression("Implicit curves are not supported");
+  }
+
+  /*!
+
+\fn RangeStats ICalculationModel::Analyze
+\brief Evaluates the expression at equally spaced samples of the range and
+reduces the values to summary statistics on the fly.
+\details The default implementation does not support the statistics.
+\param x_left Left boundary of the range, the first sample.
+\param x_right Right boundary of the range, the last sample.
+\param samples Number of samples, at least 2.
+\return The statistics of the values.
+\exception BadExpression If the expression or the range is invalid, or the
+statistics are not supported.
+*/
+
+  virtual RangeStats Analyze(double /*x_left*/, double /*x_right*/,
+                             std::size_t /*samples*/) {
+    throw BadExpression("Range statistics are not supported");
+  }
+
+  /*!
+
+\fn void ICalculationModel::Define
+\brief Defines a function of one variable or a constant for the later
+expressions.
+\details The default implementation does not support definitions.
+\param name The name of the function or the constant.
+\param parameter The parameter of the function, empty for a constant.
+\param body The expression of the function of the parameter, or of the
+constant.
+\exception BadExpression If the definition is invalid or definitions are not
+supported.
+*/
+
+  virtual void Define(const std::string& /*name*/,
+                      const std::string& /*parameter*/,
+                      const std::string& /*body*/) {
+    throw BadExpression("Definitions are not supported");
+  }
+
+  /*!
+
 \fn void ICalculationModel::setExpression
 \brief Sets the expression for the calculation model.
 \param expr The expression to be used in the calculation model.
@@ -72,12 +269,46 @@ of points.
 
   /*!
 
+\fn void ICalculationModel::EditExpression
+\brief Sets the expression that is an edit of the previous one.
+\details Models may reuse the work done for the unchanged part of the
+expression. The default implementation compiles it from scratch.
+\param expr The expression to be used in the calculation model.
+*/
+
+  virtual void EditExpression(const std::string_view& expr) {
+    setExpression(expr);
+  }
+
+  /*!
+
 \fn bool ICalculationModel::ExressionChanged
 \brief Checks if the expression has changed since the last calculation.
 \return True if the expression has changed, false otherwise.
 */
 
   virtual bool ExressionChanged() noexcept = 0;
+
+  /*!
+
+\fn PipelineStats ICalculationModel::Stats
+\brief Returns per-stage counters of the calculation pipeline.
+\details The counters are process-wide: they sum the stages of every model
+and every thread, not only of this model. The counters are zero if the model
+is built without S21_MODEL_STATS.
+\return Calls, latency, points and heap allocations of every stage.
+*/
+
+  virtual PipelineStats Stats() const = 0;
+
+  /*!
+
+\fn void ICalculationModel::ResetStats
+\brief Resets per-stage counters of the calculation pipeline.
+\details The counters are process-wide, so this resets them for every model.
+*/
+
+  virtual void ResetStats() = 0;
 };
 }  // namespace s21
 
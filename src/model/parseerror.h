@@ -0,0 +1,101 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file parseerror.h
+ * @brief Error codes, source positions and applied fixes reported by the
+ * non-throwing parsing API.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_PARSEERROR_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_PARSEERROR_H_
+
+#include <cstddef>
+#include <string_view>
+
+namespace s21 {
+/**
+ * @enum ErrorCode
+ * @brief Reasons an expression is rejected.
+ */
+enum class ErrorCode : unsigned char {
+  kOk,
+  kEmpty,
+  kTooLong,
+  kUnknownFunction,
+  kMismatchedToken,
+  kNotFinished,
+  kInvalidNumber,
+  kStackUnderflow
+};
+
+/**
+ * @brief Returns the message describing the error code.
+ * @param code The error code.
+ * @return The message, empty for ErrorCode::kOk.
+ */
+constexpr std::string_view ErrorMessage(ErrorCode code) noexcept {
+  switch (code) {
+    case ErrorCode::kEmpty:
+      return "Expression is empty";
+    case ErrorCode::kTooLong:
+      return "Expression is too long";
+    case ErrorCode::kUnknownFunction:
+      return "Expression has unknown function";
+    case ErrorCode::kMismatchedToken:
+      return "Expression has mismatched token";
+    case ErrorCode::kNotFinished:
+      return "Expression is not finished";
+    case ErrorCode::kInvalidNumber:
+      return "Invalid number in expression";
+    case ErrorCode::kStackUnderflow:
+      return "Expression stack underflow";
+    default:
+      return "";
+  }
+}
+
+/**
+ * @struct ParseError
+ * @brief The error and the bytes of the expression it refers to.
+ */
+struct ParseError {
+  ErrorCode code = ErrorCode::kOk; /**< Reason of the failure*/
+  std::size_t offset = 0; /**< Offset of the offending token in bytes*/
+  std::size_t length = 0; /**< Length of the offending token in bytes*/
+
+  /**
+   * @brief Checks if the error is set.
+   * @return true if the code is not ErrorCode::kOk.
+   */
+  constexpr bool Failed() const noexcept { return code != ErrorCode::kOk; }
+
+  /**
+   * @brief Returns the message describing the error.
+   * @return The message, empty if the error is not set.
+   */
+  constexpr std::string_view Message() const noexcept {
+    return ErrorMessage(code);
+  }
+};
+
+/**
+ * @enum FixKind
+ * @brief Corrections the Tokenizer applies to an incomplete expression.
+ */
+enum class FixKind : unsigned char {
+  kSpaceTrimmed,     /**< Leading spaces were skipped*/
+  kBracketOpened,    /**< A bracket was opened after a function name*/
+  kBracketClosed,    /**< A missing closing bracket was added*/
+  kBracketDropped,   /**< An unmatched closing bracket was dropped*/
+  kMultiplyInserted  /**< An omitted multiplication sign was added*/
+};
+
+/**
+ * @struct AppliedFix
+ * @brief A correction and the offset of the expression it was applied at.
+ */
+struct AppliedFix {
+  FixKind kind;       /**< The applied correction*/
+  std::size_t offset; /**< Offset of the symbol before which it applies*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_PARSEERROR_H_
@@ -0,0 +1,295 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file program.h
+ * @brief Header file for the Program class, a compiled expression in postfix
+ * bytecode form.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_PROGRAM_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_PROGRAM_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "parseerror.h"
+
+namespace s21 {
+/**
+ * @enum Opcode
+ * @brief Operations of the postfix bytecode.
+ */
+enum class Opcode : unsigned char {
+  kNumber,
+  kArg,
+  kPlus,
+  kMinus,
+  kLn,
+  kSin,
+  kCos,
+  kTan,
+  kCot,
+  kExp,
+  kLog,
+  kAsin,
+  kAcos,
+  kAtan,
+  kAcot,
+  kSqrt,
+  kPow,
+  kMod,
+  kAdd,
+  kSub,
+  kMul,
+  kDiv,
+  kArgY,
+  kLoad, /**< Pushes the stack slot given by the immediate value*/
+  kNip   /**< Drops the value under the top of the stack*/
+};
+
+/**
+ * @brief Returns the number of stack operands consumed by the operation.
+ * @param op The operation.
+ * @return 0 for operands, 1 for unary and 2 for binary operations.
+ */
+constexpr int Arity(Opcode op) noexcept {
+  if (op == Opcode::kNumber || op == Opcode::kArg || op == Opcode::kArgY ||
+      op == Opcode::kLoad)
+    return 0;
+  return op < Opcode::kPow ? 1 : 2;
+}
+
+/**
+ * @struct Instruction
+ * @brief A single bytecode instruction: an operation and its immediate value.
+ */
+struct Instruction {
+  Opcode op;    /**< The operation to execute*/
+  double value; /**< Immediate operand of kNumber, the slot of kLoad, unused
+                   otherwise*/
+};
+
+/**
+ * @class ProgramView
+ * @brief Non-owning view of valid bytecode, either owned by a Program or
+ * loaded in place from its binary form.
+ */
+class ProgramView final {
+ public:
+  constexpr ProgramView() noexcept = default;
+
+  /**
+   * @brief Constructs a view of the bytecode.
+   * @param code The instructions in postfix order.
+   * @param size The number of instructions.
+   * @param max_depth The number of stack slots needed for the evaluation.
+   */
+  constexpr ProgramView(const Instruction* code, std::size_t size,
+                        int max_depth) noexcept
+      : code_(code), size_(size), max_depth_(max_depth) {}
+
+  /**
+   * @brief Returns the first instruction.
+   * @return Pointer to the first instruction.
+   */
+  constexpr const Instruction* begin() const noexcept { return code_; }
+
+  /**
+   * @brief Returns the end of the instructions.
+   * @return Pointer past the last instruction.
+   */
+  constexpr const Instruction* end() const noexcept { return code_ + size_; }
+
+  /**
+   * @brief Returns the number of instructions.
+   * @return The number of instructions.
+   */
+  constexpr std::size_t size() const noexcept { return size_; }
+
+  /**
+   * @brief Returns the number of stack slots needed for the evaluation.
+   * @return The maximum stack depth reached by the bytecode.
+   */
+  constexpr int MaxDepth() const noexcept { return max_depth_; }
+
+ private:
+  const Instruction* code_ = nullptr; /**< Instructions in postfix order*/
+  std::size_t size_ = 0;              /**< Number of instructions*/
+  int max_depth_ = 0;                 /**< Maximum stack depth*/
+};
+
+/**
+ * @class Program
+ * @brief Expression compiled into postfix bytecode, ready to be evaluated.
+ * @details The stack depth of the bytecode is tracked while it is emitted, so
+ * a valid program never underflows the evaluation stack and needs exactly
+ * MaxDepth() slots. A program may also carry a deferred error (e.g. a
+ * malformed number), which is reported when the program is evaluated.
+ */
+class Program final {
+ public:
+  /**
+   * @brief Maximum number of instructions of a program with inlined
+   * functions.
+   */
+  static constexpr std::size_t kMaxInlined = std::size_t{1} << 20;
+
+  /**
+   * @struct Mark
+   * @brief Position in the program to roll back to.
+   */
+  struct Mark {
+    std::size_t size;
+    int depth;
+    int max_depth;
+    bool failed;
+  };
+
+  /**
+   * @brief Appends an instruction to the program.
+   * @param op The operation.
+   * @param value The immediate value of the operation.
+   */
+  void Emit(Opcode op, double value = 0) {
+    if (depth_ < Arity(op)) Fail({ErrorCode::kStackUnderflow});
+    depth_ += 1 - Arity(op);
+    if (depth_ > max_depth_) max_depth_ = depth_;
+    code_.push_back({op, value});
+  }
+
+  /**
+   * @brief Marks the program as invalid, keeping the first error only.
+   * @param error The error to report on evaluation.
+   */
+  void Fail(const ParseError& error) noexcept {
+    if (!error_.Failed()) error_ = error;
+  }
+
+  /**
+   * @brief Clears the program for reuse.
+   */
+  void Clear() noexcept {
+    code_.clear();
+    error_ = ParseError();
+    depth_ = max_depth_ = 0;
+  }
+
+  /**
+   * @brief Returns the current position in the program.
+   * @return The mark to pass to Rollback.
+   */
+  Mark Save() const noexcept {
+    return {code_.size(), depth_, max_depth_, error_.Failed()};
+  }
+
+  /**
+   * @brief Drops all instructions emitted after the mark.
+   * @param mark A mark returned by Save for this program.
+   */
+  void Rollback(const Mark& mark) {
+    code_.resize(mark.size);
+    depth_ = mark.depth;
+    max_depth_ = mark.max_depth;
+    if (!mark.failed) error_ = ParseError();
+  }
+
+  /**
+   * @brief Replaces the code emitted after the mark, computing a single
+   * value, by the body reading that value for every kArg.
+   * @details Inlines a user-defined function into its caller. An argument
+   * read once, or a single operand, is substituted for kArg. Otherwise the
+   * argument is evaluated once and left on the stack, the body reads it by
+   * kLoad, and kNip drops it under the result, so nested calls grow the code
+   * linearly. The program fails as too long once it would exceed kMaxInlined
+   * instructions.
+   * @param argument A mark returned by Save before the argument was emitted.
+   * @param body Valid bytecode of the function of x.
+   */
+  void Inline(const Mark& argument, const ProgramView& body) {
+    std::size_t uses = 0;
+    for (const Instruction& instruction : body)
+      uses += instruction.op == Opcode::kArg;
+    std::size_t size = code_.size() - argument.size;
+    bool substitute = uses <= 1 || (size == 1 && Arity(code_.back().op) == 0);
+    std::vector<Instruction> code;
+    if (substitute) {
+      code.assign(code_.begin() + argument.size, code_.end());
+      code_.resize(argument.size);
+      depth_ = argument.depth;
+      max_depth_ = argument.max_depth;
+    }
+    std::size_t inlined = substitute ? uses * size : 0;
+    if (code_.size() + body.size() + inlined + 1 > kMaxInlined) {
+      code_.resize(argument.size);
+      depth_ = argument.depth;
+      max_depth_ = argument.max_depth;
+      Fail({ErrorCode::kTooLong});
+      return Emit(Opcode::kNumber);
+    }
+    double slot = argument.depth;
+    double base = depth_;
+    for (const Instruction& instruction : body) {
+      if (instruction.op == Opcode::kLoad) {
+        Emit(Opcode::kLoad, instruction.value + base);
+      } else if (instruction.op != Opcode::kArg) {
+        Emit(instruction.op, instruction.value);
+      } else if (!substitute) {
+        Emit(Opcode::kLoad, slot);
+      } else {
+        for (const Instruction& copy : code) Emit(copy.op, copy.value);
+      }
+    }
+    if (!substitute) Emit(Opcode::kNip);
+  }
+
+  /**
+   * @brief Checks if the program may be evaluated.
+   * @return true if no error was recorded during compilation and the program
+   * leaves exactly one value on the stack.
+   */
+  bool Valid() const noexcept { return !error_.Failed() && depth_ == 1; }
+
+  /**
+   * @brief Returns the error recorded during compilation.
+   * @return The error and its position, not set if the program is valid.
+   */
+  ParseError Status() const noexcept {
+    if (!error_.Failed() && depth_ != 1) return {ErrorCode::kNotFinished};
+    return error_;
+  }
+
+  /**
+   * @brief Returns the message of the error recorded during compilation.
+   * @return The error message, empty if the program is valid.
+   */
+  std::string Error() const { return std::string(Status().Message()); }
+
+  /**
+   * @brief Returns the number of stack slots needed for the evaluation.
+   * @return The maximum stack depth reached by the program.
+   */
+  int MaxDepth() const noexcept { return max_depth_; }
+
+  /**
+   * @brief Returns the bytecode of the program.
+   * @return Instructions in postfix order.
+   */
+  const std::vector<Instruction>& Code() const noexcept { return code_; }
+
+  /**
+   * @brief Returns a view of the bytecode, usable while the program is
+   * neither changed nor destroyed.
+   * @return The view, evaluable only if the program is valid.
+   */
+  ProgramView View() const noexcept {
+    return {code_.data(), code_.size(), max_depth_};
+  }
+
+ private:
+  std::vector<Instruction> code_; /**< Instructions in postfix order*/
+  ParseError error_;              /**< Deferred compilation error*/
+  int depth_ = 0;                 /**< Stack depth after the last instruction*/
+  int max_depth_ = 0;             /**< Maximum stack depth of the program*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_PROGRAM_H_
@@ -0,0 +1,163 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "rangescan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <thread>
+#include <utility>
+
+#include "trace.h"
+
+namespace s21 {
+namespace {
+/**
+ * @struct Partial
+ * @brief Statistics of a chunk, combined into RangeStats.
+ */
+struct Partial {
+  std::size_t finite = 0;
+  double min = INFINITY;
+  double argmin = NAN;
+  double max = -INFINITY;
+  double argmax = NAN;
+  double sum = 0;
+  double integral = 0;
+  std::vector<std::pair<double, double>> sign_changes;
+  std::vector<RangeStats::Extremum> extrema;
+};
+
+/**
+ * @struct Samples
+ * @brief Equally spaced samples of the range.
+ */
+struct Samples {
+  double x_left;
+  double x_right;
+  double step;
+  std::size_t count;
+
+  double operator[](std::size_t i) const noexcept {
+    return i + 1 == count ? x_right : x_left + step * static_cast<double>(i);
+  }
+};
+
+template <class T>
+void Add(std::vector<T>& events, T event) {
+  if (events.size() < RangeStats::kMaxEvents) events.push_back(event);
+}
+
+/**
+ * @brief Folds the samples [begin, end) into the partial statistics.
+ * @details The samples begin - 1 and end are evaluated as well, if there are
+ * any, to find the sign changes and the extrema at the edges of the chunk.
+ */
+void Fold(Evaluator<double>& evaluator, const ProgramView& program,
+          const Samples& samples, std::size_t begin, std::size_t end,
+          Partial& partial) {
+  double x[RangeScanner::kBlock], f[RangeScanner::kBlock];
+  std::size_t first = begin ? begin - 1 : 0;
+  std::size_t last = std::min(end + 1, samples.count);
+  double x1 = NAN, f1 = NAN, f2 = NAN;
+  for (std::size_t block = first; block < last; block += RangeScanner::kBlock) {
+    std::size_t count = std::min(RangeScanner::kBlock, last - block);
+    for (std::size_t i = 0; i < count; ++i) x[i] = samples[block + i];
+    evaluator.Calculate(program, x, f, count);
+    for (std::size_t i = 0; i < count; ++i) {
+      std::size_t j = block + i;
+      double value = f[i];
+      bool finite = std::isfinite(value), previous = std::isfinite(f1);
+      if (j > begin && previous && finite) {
+        partial.integral += (f1 + value) / 2 * (x[i] - x1);
+        if ((f1 < 0 && value > 0) || (f1 > 0 && value < 0))
+          Add(partial.sign_changes, {x1, x[i]});
+      }
+      if (j > begin && j > 1 && previous && finite && std::isfinite(f2) &&
+          ((f1 > f2 && f1 > value) || (f1 < f2 && f1 < value)))
+        Add(partial.extrema, {x1, f1, f1 > value});
+      if (j >= begin && j < end && finite) {
+        ++partial.finite;
+        partial.sum += value;
+        if (value < partial.min) {
+          partial.min = value;
+          partial.argmin = x[i];
+        }
+        if (value > partial.max) {
+          partial.max = value;
+          partial.argmax = x[i];
+        }
+        if (value == 0) Add(partial.sign_changes, {x[i], x[i]});
+      }
+      f2 = f1;
+      x1 = x[i];
+      f1 = value;
+    }
+  }
+}
+}  // namespace
+
+RangeScanner::RangeScanner(std::size_t threads) : threads_(threads) {}
+
+std::size_t RangeScanner::Threads() const noexcept {
+  return threads_ ? threads_
+                  : std::max(1u, std::thread::hardware_concurrency());
+}
+
+RangeStats RangeScanner::Scan(const ProgramView& program, double x_left,
+                              double x_right, std::size_t samples) {
+  if (!threads_) threads_ = Threads();
+  evaluators_.resize(threads_);
+  Samples range = {x_left, x_right,
+                   (x_right - x_left) / static_cast<double>(samples - 1),
+                   samples};
+  std::vector<Partial> partials((samples + kChunk - 1) / kChunk);
+  std::size_t threads = std::min(evaluators_.size(), partials.size());
+  std::vector<std::exception_ptr> errors(threads);
+  std::atomic<std::size_t> next{0};
+
+  auto work = [&](std::size_t self) {
+    try {
+      for (std::size_t chunk = next++; chunk < partials.size();
+           chunk = next++) {
+        ScopedTrace trace("ScanChunk", "model");
+        Fold(evaluators_[self], program, range, chunk * kChunk,
+             std::min(chunk * kChunk + kChunk, samples), partials[chunk]);
+      }
+    } catch (...) {
+      errors[self] = std::current_exception();
+      next = partials.size();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (std::size_t i = 1; i < threads; ++i) pool.emplace_back(work, i);
+  work(0);
+  for (std::thread& thread : pool) thread.join();
+  for (const std::exception_ptr& error : errors)
+    if (error) std::rethrow_exception(error);
+
+  RangeStats stats;
+  stats.samples = samples;
+  double sum = 0;
+  for (const Partial& partial : partials) {
+    stats.finite += partial.finite;
+    sum += partial.sum;
+    stats.integral += partial.integral;
+    if (partial.finite && !(partial.min >= stats.min)) {
+      stats.min = partial.min;
+      stats.argmin = partial.argmin;
+    }
+    if (partial.finite && !(partial.max <= stats.max)) {
+      stats.max = partial.max;
+      stats.argmax = partial.argmax;
+    }
+    for (const auto& change : partial.sign_changes)
+      Add(stats.sign_changes, change);
+    for (const RangeStats::Extremum& extremum : partial.extrema)
+      Add(stats.extrema, extremum);
+  }
+  if (stats.finite) stats.mean = sum / static_cast<double>(stats.finite);
+  return stats;
+}
+}  // namespace s21
@@ -0,0 +1,63 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file rangescan.h
+ * @brief Header file for the RangeScanner class, which reduces the values of
+ * a program over a range to summary statistics.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_RANGESCAN_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_RANGESCAN_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "evaluator.h"
+#include "model_interface.h"
+#include "program.h"
+
+namespace s21 {
+/**
+ * @class RangeScanner
+ * @brief Computes RangeStats in one pass, with no array of the values.
+ * @details The samples are split into chunks of kChunk samples, scanned in
+ * parallel, each thread with its own evaluator. A chunk is evaluated kBlock
+ * samples at a time into a buffer on the stack and folded into a partial
+ * summary; the partial summaries are combined in the order of the chunks.
+ * A chunk also evaluates the sample before and after it, so the sign changes
+ * and the extrema at its edges are found without looking at the neighbours.
+ */
+class RangeScanner final {
+ public:
+  static constexpr std::size_t kBlock = 512;
+  static constexpr std::size_t kChunk = 16 * kBlock;
+
+  /**
+   * @brief Constructs the scanner.
+   * @param threads Number of threads, 0 for the number of cores.
+   */
+  explicit RangeScanner(std::size_t threads = 0);
+
+  /**
+   * @brief Scans the values of the program.
+   * @param program View of a valid program.
+   * @param x_left The first sample.
+   * @param x_right The last sample, not less than x_left.
+   * @param samples Number of samples, at least 2.
+   * @return The statistics of the values.
+   */
+  RangeStats Scan(const ProgramView& program, double x_left, double x_right,
+                  std::size_t samples);
+
+  /**
+   * @brief Returns the number of threads.
+   * @return The number of threads, including the calling one.
+   */
+  std::size_t Threads() const noexcept;
+
+ private:
+  std::size_t threads_; /**< Number of threads, 0 resolved by the first Scan*/
+  /** Evaluators of the threads, created by the first Scan*/
+  std::vector<Evaluator<double>> evaluators_;
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_RANGESCAN_H_
@@ -0,0 +1,87 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file resultcache.h
+ * @brief Header file for the ResultCache class, which memoizes the results
+ * of the repeated evaluations.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_RESULTCACHE_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_RESULTCACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace s21 {
+/**
+ * @class ResultCache
+ * @brief Direct-mapped cache of the values of the programs, keyed by the id
+ * of the program and the exact bits of the argument.
+ * @details The cache takes kEntries entries inside the object and never
+ * allocates. A new result replaces the one in its slot, so the cache keeps
+ * the recent queries. The ids are given by the owner of the programs, which
+ * must not reuse them for another program; id 0 is never found.
+ */
+class ResultCache final {
+ public:
+  static constexpr std::size_t kEntries = 64;
+
+  /**
+   * @brief Looks up the value of the program.
+   * @param program The id of the program.
+   * @param x The argument.
+   * @param y Set to the value if it is found.
+   * @return true if the value is found.
+   */
+  bool Find(std::uint64_t program, double x, double& y) const noexcept {
+    std::uint64_t bits = Bits(x);
+    const Entry& entry = entries_[Slot(program, bits)];
+    if (!program || entry.program != program || entry.x != bits) return false;
+    y = entry.y;
+    return true;
+  }
+
+  /**
+   * @brief Stores the value of the program.
+   * @param program The id of the program.
+   * @param x The argument.
+   * @param y The value.
+   */
+  void Insert(std::uint64_t program, double x, double y) noexcept {
+    std::uint64_t bits = Bits(x);
+    entries_[Slot(program, bits)] = {program, bits, y};
+  }
+
+  /**
+   * @brief Forgets all the values.
+   */
+  void Clear() noexcept { entries_.fill({}); }
+
+ private:
+  /**
+   * @struct Entry
+   * @brief A cached value with its key.
+   */
+  struct Entry {
+    std::uint64_t program = 0; /**< The id of the program, 0 for none*/
+    std::uint64_t x = 0;       /**< The bits of the argument*/
+    double y = 0;              /**< The value*/
+  };
+
+  static std::uint64_t Bits(double x) noexcept {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+  }
+
+  static std::size_t Slot(std::uint64_t program, std::uint64_t bits) noexcept {
+    std::uint64_t hash = (bits ^ (program * 0x9E3779B97F4A7C15u)) *
+                         0xBF58476D1CE4E5B9u;
+    return static_cast<std::size_t>(hash >> 32) % kEntries;
+  }
+
+  std::array<Entry, kEntries> entries_{}; /**< The slots*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_RESULTCACHE_H_
@@ -0,0 +1,235 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "resultring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace s21 {
+namespace {
+constexpr std::uint64_t kMagic = 0x474e495243533231;  // "21SCRING"
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kWord = sizeof(std::uint64_t);
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "The counters are shared between processes");
+static_assert(sizeof(double) == kWord);
+
+[[noreturn]] void ThrowErrno(const char* what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+std::size_t PageSize() {
+  static const std::size_t page = sysconf(_SC_PAGESIZE);
+  return page;
+}
+
+int CreateFile() {
+#ifdef __linux__
+  int fd = memfd_create("smartcalc-results", MFD_CLOEXEC);
+  if (fd < 0) ThrowErrno("memfd_create");
+  return fd;
+#else
+  static std::atomic<unsigned> counter{0};
+  std::string name = "/smartcalc-" + std::to_string(getpid()) + "-" +
+                     std::to_string(counter++);
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) ThrowErrno("shm_open");
+  shm_unlink(name.c_str());
+  return fd;
+#endif
+}
+}  // namespace
+
+/**
+ * @brief Counters shared by the producer and the consumer, each written by
+ * one side only and kept on its own cache line. Positions count words since
+ * the creation of the ring.
+ */
+struct ResultRing::Header {
+  std::uint64_t magic;    /**< kMagic*/
+  std::uint32_t version;  /**< kVersion*/
+  std::uint32_t page;     /**< Size of the header in bytes*/
+  std::uint64_t capacity; /**< Number of words of the ring*/
+  alignas(64) std::atomic<std::uint64_t> written; /**< Published position*/
+  alignas(64) std::atomic<std::uint64_t> sequence; /**< Committed records*/
+  alignas(64) std::atomic<std::uint64_t> read;     /**< Consumed position*/
+  std::atomic<std::uint64_t> consumed;             /**< Consumed records*/
+};
+
+ResultRing ResultRing::Create(std::size_t capacity) {
+  std::size_t page = PageSize();
+  std::size_t bytes = std::max<std::size_t>(capacity, 1) * kWord;
+  bytes = (bytes + page - 1) / page * page;
+  int fd = CreateFile();
+  if (ftruncate(fd, page + bytes) < 0) {
+    int error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(), "ftruncate");
+  }
+  ResultRing ring(fd, bytes / kWord);
+  new (ring.header_) Header{kMagic, kVersion,
+                            static_cast<std::uint32_t>(page),
+                            ring.capacity_, {0}, {0}, {0}, {0}};
+  return ring;
+}
+
+ResultRing ResultRing::Attach(int fd) {
+  std::size_t page = PageSize();
+  struct stat file {};
+  if (fstat(fd, &file) < 0) {
+    int error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(), "fstat");
+  }
+  std::uint64_t capacity = 0;
+  bool valid = static_cast<std::size_t>(file.st_size) > page;
+  if (valid) {
+    void* first = mmap(nullptr, page, PROT_READ, MAP_SHARED, fd, 0);
+    if (first == MAP_FAILED) {
+      int error = errno;
+      close(fd);
+      throw std::system_error(error, std::generic_category(), "mmap");
+    }
+    const Header* header = static_cast<const Header*>(first);
+    capacity = header->capacity;
+    valid = header->magic == kMagic && header->version == kVersion &&
+            header->page == page &&
+            static_cast<std::uint64_t>(file.st_size) ==
+                page + capacity * kWord;
+    munmap(first, page);
+  }
+  if (!valid) {
+    close(fd);
+    throw std::invalid_argument("Not a result ring");
+  }
+  return ResultRing(fd, capacity);
+}
+
+ResultRing::ResultRing(int fd, std::size_t capacity)
+    : fd_(fd), capacity_(capacity) {
+  std::size_t page = PageSize(), bytes = capacity * kWord;
+  length_ = page + 2 * bytes;
+  mapping_ = mmap(nullptr, length_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS,
+                  -1, 0);
+  char* base = static_cast<char*>(mapping_);
+  bool mapped =
+      mapping_ != MAP_FAILED &&
+      mmap(base, page + bytes, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+      mmap(base + page + bytes, bytes, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_FIXED, fd, page) != MAP_FAILED;
+  if (!mapped) {
+    int error = errno;
+    if (mapping_ == MAP_FAILED) mapping_ = nullptr;
+    Release();
+    throw std::system_error(error, std::generic_category(), "mmap");
+  }
+  header_ = reinterpret_cast<Header*>(base);
+  words_ = reinterpret_cast<std::uint64_t*>(base + page);
+}
+
+ResultRing::ResultRing(ResultRing&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      mapping_(std::exchange(other.mapping_, nullptr)),
+      length_(std::exchange(other.length_, 0)),
+      header_(std::exchange(other.header_, nullptr)),
+      words_(std::exchange(other.words_, nullptr)),
+      started_(other.started_),
+      size_(other.size_),
+      writing_(std::exchange(other.writing_, false)) {}
+
+ResultRing& ResultRing::operator=(ResultRing&& other) noexcept {
+  if (this != &other) {
+    Release();
+    fd_ = std::exchange(other.fd_, -1);
+    capacity_ = std::exchange(other.capacity_, 0);
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    length_ = std::exchange(other.length_, 0);
+    header_ = std::exchange(other.header_, nullptr);
+    words_ = std::exchange(other.words_, nullptr);
+    started_ = other.started_;
+    size_ = other.size_;
+    writing_ = std::exchange(other.writing_, false);
+  }
+  return *this;
+}
+
+ResultRing::~ResultRing() { Release(); }
+
+void ResultRing::Release() noexcept {
+  if (mapping_) munmap(mapping_, length_);
+  if (fd_ >= 0) close(fd_);
+  mapping_ = nullptr;
+  header_ = nullptr;
+  words_ = nullptr;
+  fd_ = -1;
+}
+
+double* ResultRing::Begin(std::size_t size) noexcept {
+  if (writing_ || size >= capacity_) return nullptr;
+  std::uint64_t written = header_->written.load(std::memory_order_relaxed);
+  std::uint64_t read = header_->read.load(std::memory_order_acquire);
+  if (capacity_ - (written - read) < size + 1) return nullptr;
+  std::uint64_t* record = words_ + written % capacity_;
+  std::uint64_t word = size;
+  std::memcpy(record, &word, kWord);
+  started_ = written;
+  size_ = size;
+  writing_ = true;
+  header_->written.store(written + 1, std::memory_order_release);
+  return reinterpret_cast<double*>(record + 1);
+}
+
+void ResultRing::Progress(std::size_t ready) noexcept {
+  if (!writing_) return;
+  header_->written.store(started_ + 1 + std::min(ready, size_),
+                         std::memory_order_release);
+}
+
+void ResultRing::Commit() noexcept {
+  if (!writing_) return;
+  Progress(size_);
+  header_->sequence.fetch_add(1, std::memory_order_release);
+  writing_ = false;
+}
+
+std::uint64_t ResultRing::Sequence() const noexcept {
+  return header_->sequence.load(std::memory_order_acquire);
+}
+
+bool ResultRing::Peek(Record& record) const noexcept {
+  std::uint64_t read = header_->read.load(std::memory_order_relaxed);
+  std::uint64_t sequence = header_->sequence.load(std::memory_order_acquire);
+  std::uint64_t written = header_->written.load(std::memory_order_acquire);
+  if (written == read) return false;
+  const std::uint64_t* words = words_ + read % capacity_;
+  record.data = reinterpret_cast<const double*>(words + 1);
+  std::uint64_t size = 0;
+  std::memcpy(&size, words, kWord);
+  record.size = size;
+  record.ready = std::min<std::uint64_t>(written - read - 1, record.size);
+  record.complete =
+      sequence > header_->consumed.load(std::memory_order_relaxed);
+  return true;
+}
+
+void ResultRing::Consume() noexcept {
+  Record record;
+  if (!Peek(record) || !record.complete) return;
+  header_->consumed.fetch_add(1, std::memory_order_relaxed);
+  header_->read.fetch_add(record.size + 1, std::memory_order_release);
+}
+}  // namespace s21
@@ -0,0 +1,136 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file resultring.h
+ * @brief Header file for the ResultRing class, a shared-memory ring buffer
+ * of evaluation results.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_RESULTRING_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_RESULTRING_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace s21 {
+/**
+ * @class ResultRing
+ * @brief Single-producer, single-consumer ring of result records in shared
+ * memory.
+ * @details The ring lives in an anonymous shared-memory file (memfd on Linux,
+ * an unlinked POSIX shm object elsewhere) whose descriptor is passed to the
+ * consumer, in the same or another process, which maps it with Attach. A
+ * record is a size word followed by that many doubles, written in place by
+ * the producer. The data is mapped twice back to back, so every record is
+ * contiguous in memory even where it wraps around the end of the ring.
+ *
+ * Progress and completion are published through atomic counters in the
+ * first page of the file: the producer advances the written position as it
+ * fills a record, letting the consumer read its finished prefix, and bumps
+ * the sequence number once the record is complete. The consumer frees the
+ * record by advancing the read position. No locks are taken on either side.
+ */
+class ResultRing final {
+ public:
+  /**
+   * @struct Record
+   * @brief The oldest record not consumed yet.
+   */
+  struct Record {
+    const double* data = nullptr; /**< The values, contiguous*/
+    std::size_t size = 0;         /**< Number of values of the record*/
+    std::size_t ready = 0;        /**< Number of values written so far*/
+    bool complete = false;        /**< Whether the record is committed*/
+  };
+
+  /**
+   * @brief Creates a ring in a new shared-memory file.
+   * @param capacity Minimum number of 8-byte words, rounded up to a whole
+   * number of pages; a record takes its size plus one word.
+   * @exception std::system_error If the memory cannot be allocated or mapped.
+   */
+  static ResultRing Create(std::size_t capacity);
+
+  /**
+   * @brief Maps the ring created by another ResultRing.
+   * @param fd Descriptor of the shared-memory file, owned by the ring since.
+   * @exception std::system_error If the file cannot be mapped.
+   * @exception std::invalid_argument If the file does not hold a ring.
+   */
+  static ResultRing Attach(int fd);
+
+  ResultRing(ResultRing&& other) noexcept;
+  ResultRing& operator=(ResultRing&& other) noexcept;
+  ResultRing(const ResultRing&) = delete;
+  ResultRing& operator=(const ResultRing&) = delete;
+
+  /**
+   * @brief Unmaps the ring and closes the descriptor.
+   */
+  ~ResultRing();
+
+  /**
+   * @brief Returns the descriptor of the shared-memory file.
+   * @return The descriptor to pass to the consumer.
+   */
+  int Fd() const noexcept { return fd_; }
+
+  /**
+   * @brief Returns the number of words of the ring.
+   */
+  std::size_t Capacity() const noexcept { return capacity_; }
+
+  /**
+   * @brief Starts a record, called by the producer.
+   * @param size Number of values of the record.
+   * @return Space for the values, or nullptr if the consumer has not freed
+   * enough of the ring yet or a record is already started.
+   */
+  double* Begin(std::size_t size) noexcept;
+
+  /**
+   * @brief Publishes the first values of the started record.
+   * @param ready Number of values written, at most the size of the record.
+   */
+  void Progress(std::size_t ready) noexcept;
+
+  /**
+   * @brief Publishes the whole started record and completes it.
+   */
+  void Commit() noexcept;
+
+  /**
+   * @brief Returns the number of records committed since the creation.
+   * @return The sequence number of the next record.
+   */
+  std::uint64_t Sequence() const noexcept;
+
+  /**
+   * @brief Looks at the oldest record, called by the consumer.
+   * @param record Receives the record if there is one.
+   * @return true if a record is started.
+   */
+  bool Peek(Record& record) const noexcept;
+
+  /**
+   * @brief Frees the oldest record, which must be complete.
+   */
+  void Consume() noexcept;
+
+ private:
+  struct Header;
+
+  ResultRing(int fd, std::size_t capacity);
+  void Release() noexcept;
+
+  int fd_ = -1;                    /**< The shared-memory file*/
+  std::size_t capacity_ = 0;       /**< Number of words of the ring*/
+  void* mapping_ = nullptr;        /**< Header page and both data mappings*/
+  std::size_t length_ = 0;         /**< Size of the mapping in bytes*/
+  Header* header_ = nullptr;       /**< Counters, in the first page*/
+  std::uint64_t* words_ = nullptr; /**< The data, mapped twice*/
+  std::uint64_t started_ = 0;      /**< Word of the started record*/
+  std::size_t size_ = 0;           /**< Size of the started record*/
+  bool writing_ = false;           /**< Whether a record is started*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_RESULTRING_H_
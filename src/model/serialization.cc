@@ -0,0 +1,104 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "serialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "badexpression.h"
+
+namespace s21 {
+namespace {
+constexpr char kMagic[4] = {'S', '2', '1', 'P'};
+constexpr std::uint16_t kByteOrder = 0x0102;
+constexpr std::uint32_t kMaxVariables = 2;
+
+struct Header {
+  char magic[4];
+  std::uint16_t version;
+  std::uint16_t byte_order;
+  std::uint32_t size;
+  std::uint32_t max_depth;
+  std::uint32_t variables;
+  std::uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 24 &&
+                  sizeof(Header) % alignof(Instruction) == 0,
+              "The header must keep the instructions aligned");
+static_assert(std::is_standard_layout_v<Instruction> &&
+                  sizeof(Instruction) == 16 &&
+                  offsetof(Instruction, value) == 8,
+              "The instruction layout is part of the format");
+static_assert(std::numeric_limits<double>::is_iec559,
+              "Constants are stored as IEEE 754 doubles");
+
+std::uint32_t Variables(const Program& program) noexcept {
+  for (const Instruction& instruction : program.Code())
+    if (instruction.op == Opcode::kArgY) return 2;
+  return 1;
+}
+
+bool Verify(const Header& header, const Instruction* code) noexcept {
+  int depth = 0, max_depth = 0;
+  for (std::uint32_t i = 0; i < header.size; ++i) {
+    Opcode op = code[i].op;
+    if (op > Opcode::kNip || depth < Arity(op) ||
+        (op == Opcode::kArgY && header.variables == 1) ||
+        (op == Opcode::kLoad &&
+         !(code[i].value >= 0 && code[i].value < depth &&
+           code[i].value == static_cast<int>(code[i].value))))
+      return false;
+    depth += 1 - Arity(op);
+    if (depth > max_depth) max_depth = depth;
+  }
+  return depth == 1 &&
+         static_cast<std::uint32_t>(max_depth) == header.max_depth;
+}
+}  // namespace
+
+void SaveProgram(const Program& program, std::vector<char>& dest) {
+  if (!program.Valid()) throw BadExpression(program.Status());
+  Header header = {{kMagic[0], kMagic[1], kMagic[2], kMagic[3]},
+                   kProgramFormatVersion,
+                   kByteOrder,
+                   static_cast<std::uint32_t>(program.Code().size()),
+                   static_cast<std::uint32_t>(program.MaxDepth()),
+                   Variables(program),
+                   0};
+  std::size_t offset = dest.size();
+  dest.resize(offset + sizeof(Header) + header.size * sizeof(Instruction));
+  char* out = dest.data() + offset;
+  std::memcpy(out, &header, sizeof(Header));
+  out += sizeof(Header);
+  for (const Instruction& instruction : program.Code()) {
+    std::memcpy(out + offsetof(Instruction, op), &instruction.op,
+                sizeof(instruction.op));
+    std::memcpy(out + offsetof(Instruction, value), &instruction.value,
+                sizeof(instruction.value));
+    out += sizeof(Instruction);
+  }
+}
+
+std::optional<ProgramView> LoadProgram(const char* data, std::size_t size,
+                                       std::size_t* used,
+                                       std::uint32_t variables) noexcept {
+  Header header;
+  if (size < sizeof(Header) ||
+      reinterpret_cast<std::uintptr_t>(data) % alignof(Instruction))
+    return std::nullopt;
+  std::memcpy(&header, data, sizeof(Header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) ||
+      header.version != kProgramFormatVersion ||
+      header.byte_order != kByteOrder || header.variables < 1 ||
+      header.variables > std::min(variables, kMaxVariables) ||
+      header.size > (size - sizeof(Header)) / sizeof(Instruction))
+    return std::nullopt;
+  const Instruction* code =
+      reinterpret_cast<const Instruction*>(data + sizeof(Header));
+  if (!Verify(header, code)) return std::nullopt;
+  if (used) *used = sizeof(Header) + header.size * sizeof(Instruction);
+  return ProgramView(code, header.size, static_cast<int>(header.max_depth));
+}
+}  // namespace s21
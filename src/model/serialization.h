@@ -0,0 +1,56 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file serialization.h
+ * @brief Versioned binary form of compiled programs, loadable in place.
+ * @details A record is a 24-byte header followed by the instructions in their
+ * in-memory layout, so a loaded program points straight into the buffer
+ * (e.g. a memory-mapped file) and evaluates without parsing or copying.
+ * Records are multiples of 8 bytes and may be stored back to back. The
+ * format uses the host byte order, which is recorded in the header.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_SERIALIZATION_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_SERIALIZATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "program.h"
+
+namespace s21 {
+/**
+ * @brief Version of the binary format written by SaveProgram.
+ */
+constexpr std::uint16_t kProgramFormatVersion = 1;
+
+/**
+ * @brief Appends the binary form of the program to the buffer.
+ * @details The header records whether the program reads the second variable
+ * y (Opcode::kArgY), so that a loader binding x alone refuses it.
+ * @param program The program to store.
+ * @param dest The buffer, whose size stays a multiple of 8 bytes if it was.
+ * @exception BadExpression If the program carries a compilation error.
+ */
+void SaveProgram(const Program& program, std::vector<char>& dest);
+
+/**
+ * @brief Loads the program stored at the beginning of the buffer in place.
+ * @details The header and the bytecode are checked (opcodes and stack depth)
+ * in a single pass, so a corrupted record is rejected rather than evaluated.
+ * @param data The buffer, aligned to 8 bytes.
+ * @param size Size of the buffer in bytes.
+ * @param used If not null, receives the size of the record, i.e. the offset of
+ * the next one.
+ * @param variables The number of variables the caller binds: 1 for x alone,
+ * 2 for x and y.
+ * @return The view of the program, pointing into the buffer, or nothing if
+ * the record is invalid, truncated, misaligned, of another version or byte
+ * order, or reads more variables than the caller binds.
+ */
+std::optional<ProgramView> LoadProgram(const char* data, std::size_t size,
+                                       std::size_t* used = nullptr,
+                                       std::uint32_t variables = 1) noexcept;
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_SERIALIZATION_H_
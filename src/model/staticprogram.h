@@ -0,0 +1,476 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file staticprogram.h
+ * @brief Compilation of expression literals at compile time, for formulas
+ * hard-coded in C++.
+ * @details A literal is compiled into bytecode while the program is built:
+ * @code
+ * static constexpr auto kParabola = s21::StaticCompile("x^2-2x+1");
+ * double y = s21::StaticCalculate<kParabola>(x);
+ * @endcode
+ * A malformed literal fails the build. StaticCalculate expands the bytecode
+ * into straight-line code, so nothing is parsed or dispatched at run time.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_STATICPROGRAM_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_STATICPROGRAM_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+#include "badexpression.h"
+#include "compiler.h"
+#include "evaluator.h"
+#include "parseerror.h"
+#include "program.h"
+#include "tokenizer.h"
+
+namespace s21 {
+/**
+ * @struct StaticProgram
+ * @brief Bytecode of an expression literal, built at compile time.
+ * @tparam N Capacity in instructions.
+ */
+template <std::size_t N>
+struct StaticProgram {
+  std::array<Instruction, N> code{}; /**< Instructions in postfix order*/
+  std::size_t size = 0;              /**< Number of instructions*/
+  int max_depth = 0;                 /**< Maximum stack depth*/
+
+  /**
+   * @brief Returns the view of the bytecode, to be evaluated by the
+   * Evaluator or the RPNCalculator.
+   * @return The view of the instructions.
+   */
+  constexpr ProgramView View() const noexcept {
+    return ProgramView(code.data(), size, max_depth);
+  }
+
+  /**
+   * @brief Returns the stack depth reached before the instruction.
+   * @param index Index of the instruction.
+   * @return The number of values on the stack.
+   */
+  constexpr int DepthBefore(std::size_t index) const noexcept {
+    int depth = 0;
+    for (std::size_t i = 0; i < index; ++i) depth += 1 - Arity(code[i].op);
+    return depth;
+  }
+};
+
+/**
+ * @brief Reports a syntax error found by StaticCompile.
+ * @details The function is not constexpr, so reaching it while a literal is
+ * compiled at compile time is not a constant expression: the build fails and
+ * the diagnostic shows the error code and the offset.
+ * @param code The error.
+ * @param offset Offset of the offending token.
+ * @param length Length of the offending token.
+ * @exception BadExpression Always, if StaticCompile runs at run time.
+ */
+[[noreturn]] inline void StaticSyntaxError(ErrorCode code, std::size_t offset,
+                                           std::size_t length) {
+  throw BadExpression(ParseError{code, offset, length});
+}
+
+/**
+ * @class StaticCompiler
+ * @brief The shunting-yard algorithm over fixed-size stacks, usable in
+ * constant expressions.
+ * @details The grammar and the priorities are those of the
+ * ShuntingYardCompiler, including the omitted multiplication signs and the
+ * brackets left open at the end. A function name without a bracket and an
+ * unmatched closing bracket are errors here rather than fixed. Numbers are
+ * exact in the range of Clinger's fast path (up to 2^53 scaled by up to
+ * 10^22) and within an ulp of strtod elsewhere.
+ * @tparam N Size of the literal, including the terminating null.
+ */
+template <std::size_t N>
+class StaticCompiler final {
+ public:
+  using TokenType = Tokenizer::TokenType;
+
+  /**
+   * @brief Upper bound of the number of instructions: a token emits at most
+   * one instruction and an omitted multiplication sign.
+   */
+  static constexpr std::size_t kCapacity = 2 * N;
+
+  /**
+   * @brief Constructs the compiler of the expression.
+   * @param expression The expression of at most N - 1 symbols.
+   */
+  constexpr explicit StaticCompiler(std::string_view expression) noexcept
+      : expression_(expression) {}
+
+  /**
+   * @brief Compiles the expression.
+   * @return The compiled program.
+   * @exception BadExpression If the expression is malformed and the call is
+   * evaluated at run time; at compile time the error fails the build.
+   */
+  constexpr StaticProgram<kCapacity> Compile() {
+    while (pos_ < expression_.size()) {
+      char symbol = expression_[pos_];
+      TokenType type = Tokenizer::GetTokenType(symbol);
+      if (symbol == ' ') {
+        ++pos_;
+        continue;
+      }
+      Check(prev_ != TokenType::kFunction || type == TokenType::kOpenBracket,
+            ErrorCode::kMismatchedToken, pos_, 1);
+      if (type == TokenType::kFunction && expression_.substr(pos_, 3) == "mod")
+        ReadOperator('%', 3);
+      else if (type == TokenType::kDigit)
+        ReadNumber();
+      else if (type == TokenType::kArg)
+        ReadArg(symbol);
+      else if (type == TokenType::kOperator)
+        ReadOperator(symbol, 1);
+      else if (type == TokenType::kOpenBracket)
+        OpenBracket();
+      else if (type == TokenType::kCloseBracket)
+        CloseBracket();
+      else if (type == TokenType::kFunction)
+        ReadFunction();
+      else
+        Check(false, ErrorCode::kMismatchedToken, pos_, 1);
+    }
+    Check(program_.size, ErrorCode::kEmpty, 0, 0);
+    Check(Finished(), ErrorCode::kNotFinished, pos_, 0);
+    while (operators_) PopToOut();
+    return program_;
+  }
+
+ private:
+  /**
+   * @struct Pending
+   * @brief Operator stack entry, as in the ShuntingYardCompiler.
+   */
+  struct Pending {
+    char symbol;
+    Opcode op;
+  };
+
+  /**
+   * @brief Reports the error unless the condition holds.
+   * @param ok The condition.
+   * @param code The error.
+   * @param offset Offset of the offending token.
+   * @param length Length of the offending token.
+   */
+  static constexpr void Check(bool ok, ErrorCode code, std::size_t offset,
+                              std::size_t length) {
+    if (!ok) StaticSyntaxError(code, offset, length);
+  }
+
+  /**
+   * @brief Checks if the last token can end an operand.
+   * @return true after a number, the variable or a closing bracket.
+   */
+  constexpr bool Finished() const noexcept {
+    return Tokenizer::IsNumeric(prev_) || prev_ == TokenType::kCloseBracket;
+  }
+
+  /**
+   * @brief Inserts the multiplication sign omitted before an operand.
+   */
+  constexpr void Multiply() {
+    if (Finished()) PushOperator('*');
+  }
+
+  /**
+   * @brief Reads a number literal.
+   */
+  constexpr void ReadNumber() {
+    Multiply();
+    std::size_t begin = pos_;
+    std::uint64_t mantissa = 0;
+    int exponent = 0, digits = 0, dots = 0;
+    bool valid = false;
+    for (; pos_ < expression_.size() &&
+           Tokenizer::GetTokenType(expression_[pos_]) == TokenType::kDigit;
+         ++pos_) {
+      char symbol = expression_[pos_];
+      if (symbol == '.') {
+        ++dots;
+        continue;
+      }
+      valid = true;
+      if (!mantissa && symbol == '0') {
+        if (dots) --exponent;
+      } else if (digits < std::numeric_limits<std::uint64_t>::digits10) {
+        mantissa = mantissa * 10 + (symbol - '0');
+        ++digits;
+        if (dots) --exponent;
+      } else if (!dots) {
+        ++exponent;
+      }
+    }
+    if (pos_ < expression_.size() && expression_[pos_] == 'e') {
+      int sign = 1, power = 0;
+      if (++pos_ < expression_.size() &&
+          (expression_[pos_] == '+' || expression_[pos_] == '-'))
+        sign = expression_[pos_++] == '-' ? -1 : 1;
+      valid = valid && IsDecimal(pos_);
+      for (; IsDecimal(pos_); ++pos_)
+        if (power < 100000) power = power * 10 + (expression_[pos_] - '0');
+      exponent += sign * power;
+    }
+    double value = 0;
+    valid = valid && dots <= 1 && Scale(mantissa, exponent, value);
+    Check(valid && (value || !mantissa), ErrorCode::kInvalidNumber, begin,
+          pos_ - begin);
+    Emit(Opcode::kNumber, value);
+    prev_ = TokenType::kDigit;
+  }
+
+  /**
+   * @brief Checks if the symbol is a decimal digit.
+   * @param offset Offset of the symbol, may be past the end.
+   * @return true for a digit other than the decimal point.
+   */
+  constexpr bool IsDecimal(std::size_t offset) const noexcept {
+    return offset < expression_.size() && '0' <= expression_[offset] &&
+           expression_[offset] <= '9';
+  }
+
+  /**
+   * @brief Computes mantissa * 10^exponent.
+   * @param mantissa The significant digits.
+   * @param exponent The decimal exponent.
+   * @param value Receives the result.
+   * @return false if the result overflows a double.
+   */
+  static constexpr bool Scale(std::uint64_t mantissa, int exponent,
+                              double& value) noexcept {
+    if (mantissa < (std::uint64_t{1} << 53) && -22 <= exponent &&
+        exponent <= 22) {
+      double power = 1;
+      for (int i = 0; i < exponent || i < -exponent; ++i) power *= 10;
+      value = exponent < 0 ? mantissa / power : mantissa * power;
+      return true;
+    }
+    long double scaled = mantissa;
+    for (; scaled && exponent > 0; --exponent) {
+      if (scaled > std::numeric_limits<double>::max() / 10) return false;
+      scaled *= 10;
+    }
+    for (; scaled && exponent < 0; ++exponent) scaled /= 10;
+    value = static_cast<double>(scaled);
+    return true;
+  }
+
+  /**
+   * @brief Reads the variable.
+   * @param symbol The variable symbol, only x is supported.
+   */
+  constexpr void ReadArg(char symbol) {
+    Check(symbol == 'x', ErrorCode::kInvalidNumber, pos_, 1);
+    Multiply();
+    Emit(Opcode::kArg);
+    ++pos_;
+    prev_ = TokenType::kArg;
+  }
+
+  /**
+   * @brief Reads an operator, unary unless it follows an operand.
+   * @param symbol The operator symbol.
+   * @param width Length of the operator in the expression.
+   */
+  constexpr void ReadOperator(char symbol, std::size_t width) {
+    char op = '\0';
+    if (Finished())
+      op = symbol == '#' ? '+' : symbol == '~' ? '-' : symbol;
+    else if (symbol == '+' || symbol == '#')
+      op = '#';
+    else if (symbol == '-' || symbol == '~')
+      op = '~';
+    Check(op, ErrorCode::kMismatchedToken, pos_, width);
+    PushOperator(op);
+    pos_ += width;
+    prev_ = TokenType::kOperator;
+  }
+
+  /**
+   * @brief Reads a function name.
+   */
+  constexpr void ReadFunction() {
+    std::string_view rest = expression_.substr(pos_);
+    for (const auto& function : ShuntingYardCompiler::kFunctionCodes) {
+      if (rest.substr(0, function.first.size()) != function.first) continue;
+      Multiply();
+      Push({rest.front(), function.second});
+      pos_ += function.first.size();
+      prev_ = TokenType::kFunction;
+      return;
+    }
+    std::size_t length = 0;
+    while (length < rest.size() &&
+           Tokenizer::GetTokenType(rest[length]) == TokenType::kFunction)
+      ++length;
+    Check(false, ErrorCode::kUnknownFunction, pos_, length);
+  }
+
+  /**
+   * @brief Reads an opening bracket.
+   */
+  constexpr void OpenBracket() {
+    Multiply();
+    Push({'(', Opcode::kNumber});
+    ++open_;
+    ++pos_;
+    prev_ = TokenType::kOpenBracket;
+  }
+
+  /**
+   * @brief Reads a closing bracket and emits the operators it encloses.
+   */
+  constexpr void CloseBracket() {
+    Check(open_ && Finished(), ErrorCode::kMismatchedToken, pos_, 1);
+    while (Top().symbol != '(') PopToOut();
+    --operators_;
+    --open_;
+    if (operators_ &&
+        Tokenizer::GetTokenType(Top().symbol) == TokenType::kFunction)
+      PopToOut();
+    ++pos_;
+    prev_ = TokenType::kCloseBracket;
+  }
+
+  /**
+   * @brief Pushes an operator, emitting the operators it takes over first.
+   * @param symbol The collapsed operator symbol.
+   */
+  constexpr void PushOperator(char symbol) {
+    while (operators_ &&
+           Tokenizer::GetPriority(symbol) <=
+               Tokenizer::GetPriority(Top().symbol) &&
+           Tokenizer::isLeftWise(symbol))
+      PopToOut();
+    Push({symbol, ShuntingYardCompiler::OperatorCode(symbol)});
+  }
+
+  /**
+   * @brief Returns the top of the operator stack.
+   * @return The last pushed entry.
+   */
+  constexpr const Pending& Top() const noexcept {
+    return operators_stack_[operators_ - 1];
+  }
+
+  /**
+   * @brief Pushes an entry onto the operator stack.
+   * @param pending The entry.
+   */
+  constexpr void Push(Pending pending) noexcept {
+    operators_stack_[operators_++] = pending;
+  }
+
+  /**
+   * @brief Pops the top operator, emitting it unless it is a bracket.
+   */
+  constexpr void PopToOut() noexcept {
+    Pending top = operators_stack_[--operators_];
+    if (top.symbol != '(') Emit(top.op);
+  }
+
+  /**
+   * @brief Appends an instruction, tracking the stack depth.
+   * @param op The operation.
+   * @param value The immediate value of the operation.
+   */
+  constexpr void Emit(Opcode op, double value = 0) noexcept {
+    program_.code[program_.size++] = {op, value};
+    depth_ += 1 - Arity(op);
+    if (depth_ > program_.max_depth) program_.max_depth = depth_;
+  }
+
+  std::string_view expression_;              /**< The expression*/
+  std::size_t pos_ = 0;                      /**< Current offset*/
+  TokenType prev_ = TokenType::kUndefined;   /**< The last token read*/
+  std::array<Pending, N> operators_stack_{}; /**< Pending operators*/
+  std::size_t operators_ = 0;                /**< Operator stack size*/
+  std::size_t open_ = 0;                     /**< Open brackets*/
+  int depth_ = 0;                            /**< Current stack depth*/
+  StaticProgram<kCapacity> program_;         /**< The program being built*/
+};
+
+/**
+ * @brief Compiles an expression literal.
+ * @param expression The literal, or a null-terminated array.
+ * @return The program, a constant if the result initializes a constexpr
+ * variable.
+ * @exception BadExpression If the expression is malformed and the call is
+ * evaluated at run time.
+ */
+template <std::size_t N>
+constexpr StaticProgram<2 * N> StaticCompile(const char (&expression)[N]) {
+  return StaticCompiler<N>(std::string_view(expression)).Compile();
+}
+
+/**
+ * @class StaticEvaluator
+ * @brief Evaluates a constant program as straight-line code.
+ * @details Every instruction and the stack slot it works on are template
+ * arguments, so the evaluation stack is a fixed-size local array that the
+ * compiler keeps in registers, and the operations are inlined without a
+ * dispatch.
+ * @tparam kProgram The program, a constexpr variable with static storage.
+ * @tparam T The scalar type.
+ */
+template <const auto& kProgram, class T>
+class StaticEvaluator final {
+ public:
+  /**
+   * @brief Evaluates the program.
+   * @param x The variable value.
+   * @return The result of the evaluation.
+   */
+  static T Calculate(T x) noexcept {
+    return Run(x, std::make_index_sequence<kProgram.size>());
+  }
+
+ private:
+  template <std::size_t... kIndex>
+  static T Run(T x, std::index_sequence<kIndex...>) noexcept {
+    T values[kProgram.max_depth] = {};
+    (Step<kIndex>(values, x), ...);
+    return values[0];
+  }
+
+  template <std::size_t kIndex>
+  static void Step(T* values, T x) noexcept {
+    constexpr Instruction kInstruction = kProgram.code[kIndex];
+    constexpr int kTop = kProgram.DepthBefore(kIndex);
+    if constexpr (kInstruction.op == Opcode::kNumber)
+      values[kTop] = static_cast<T>(kInstruction.value);
+    else if constexpr (kInstruction.op == Opcode::kArg)
+      values[kTop] = x;
+    else if constexpr (Arity(kInstruction.op) == 1)
+      values[kTop - 1] =
+          Evaluator<T>::Apply(kInstruction.op, 0, values[kTop - 1]);
+    else
+      values[kTop - 2] = Evaluator<T>::Apply(kInstruction.op, values[kTop - 2],
+                                             values[kTop - 1]);
+  }
+};
+
+/**
+ * @brief Evaluates a constant program as straight-line code.
+ * @tparam kProgram The program returned by StaticCompile, a constexpr variable
+ * with static storage.
+ * @tparam T The scalar type.
+ * @param x The variable value.
+ * @return The result of the evaluation.
+ */
+template <const auto& kProgram, class T>
+T StaticCalculate(T x) noexcept {
+  return StaticEvaluator<kProgram, T>::Calculate(x);
+}
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_STATICPROGRAM_H_
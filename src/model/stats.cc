@@ -0,0 +1,136 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "stats.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace s21 {
+namespace {
+struct AtomicStageStats {
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> total_ns{0};
+  std::atomic<std::uint64_t> points{0};
+  std::atomic<std::uint64_t> allocations{0};
+  std::array<std::atomic<std::uint64_t>, kLatencyBuckets> latency_histogram{};
+};
+
+AtomicStageStats registry[kStageCount];
+
+constexpr std::array<std::string_view, kStageCount> kStageNames = {
+    "tokenize", "translate", "compile", "calculate", "plot", "render"};
+
+#ifdef S21_MODEL_STATS
+thread_local std::uint64_t thread_allocations = 0;
+
+std::size_t LatencyBucket(std::uint64_t ns) noexcept {
+  std::size_t bucket = 0;
+  for (; ns > 1 && bucket + 1 < kLatencyBuckets; ns >>= 1) ++bucket;
+  return bucket;
+}
+#endif
+}  // namespace
+
+PipelineStats CollectStats() noexcept {
+  PipelineStats stats;
+  for (std::size_t i = 0; i < kStageCount; ++i) {
+    stats[i].calls = registry[i].calls.load(std::memory_order_relaxed);
+    stats[i].total_ns = registry[i].total_ns.load(std::memory_order_relaxed);
+    stats[i].points = registry[i].points.load(std::memory_order_relaxed);
+    stats[i].allocations =
+        registry[i].allocations.load(std::memory_order_relaxed);
+    for (std::size_t j = 0; j < kLatencyBuckets; ++j)
+      stats[i].latency_histogram[j] =
+          registry[i].latency_histogram[j].load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void ResetStats() noexcept {
+  for (auto& stage : registry) {
+    stage.calls.store(0, std::memory_order_relaxed);
+    stage.total_ns.store(0, std::memory_order_relaxed);
+    stage.points.store(0, std::memory_order_relaxed);
+    stage.allocations.store(0, std::memory_order_relaxed);
+    for (auto& bucket : stage.latency_histogram)
+      bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::string_view StageName(Stage stage) noexcept {
+  return kStageNames[static_cast<std::size_t>(stage)];
+}
+
+std::string FormatStats(const PipelineStats& stats) {
+  std::string report;
+  char line[128];
+  for (std::size_t i = 0; i < kStageCount; ++i) {
+    const StageStats& stage = stats[i];
+    std::snprintf(line, sizeof(line),
+                  "%-10s calls %10llu  total %12.3f ms  mean %10.3f us  "
+                  "points %10llu  allocs %8llu\n",
+                  kStageNames[i].data(),
+                  static_cast<unsigned long long>(stage.calls),
+                  stage.total_ns / 1e6,
+                  stage.calls ? stage.total_ns / 1e3 / stage.calls : 0.0,
+                  static_cast<unsigned long long>(stage.points),
+                  static_cast<unsigned long long>(stage.allocations));
+    report += line;
+  }
+  return report;
+}
+
+std::uint64_t ThreadAllocations() noexcept {
+#ifdef S21_MODEL_STATS
+  return thread_allocations;
+#else
+  return 0;
+#endif
+}
+
+#ifdef S21_MODEL_STATS
+ScopedStage::ScopedStage(Stage stage, std::uint64_t points) noexcept
+    : trace_(StageName(stage).data(), StageCategory(stage)),
+      stage_(stage),
+      points_(points),
+      allocations_(thread_allocations),
+      start_(std::chrono::steady_clock::now()) {}
+
+ScopedStage::~ScopedStage() {
+  std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start_)
+                         .count();
+  AtomicStageStats& stage = registry[static_cast<std::size_t>(stage_)];
+  stage.calls.fetch_add(1, std::memory_order_relaxed);
+  stage.total_ns.fetch_add(ns, std::memory_order_relaxed);
+  stage.points.fetch_add(points_, std::memory_order_relaxed);
+  stage.allocations.fetch_add(thread_allocations - allocations_,
+                              std::memory_order_relaxed);
+  stage.latency_histogram[LatencyBucket(ns)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+#endif
+}  // namespace s21
+
+#ifdef S21_MODEL_STATS
+void* operator new(std::size_t size) {
+  ++s21::thread_allocations;
+  while (true) {
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    std::new_handler handler = std::get_new_handler();
+    if (!handler) throw std::bad_alloc();
+    handler();
+  }
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
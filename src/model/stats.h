@@ -0,0 +1,143 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file stats.h
+ * @brief Per-stage counters of the model pipeline: call counts, latency and
+ * heap allocations.
+ * @details Collection is enabled by the S21_MODEL_STATS definition. Without
+ * it ScopedStage only emits trace events and the snapshot is always zero.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_STATS_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_STATS_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "trace.h"
+
+namespace s21 {
+/**
+ * @enum Stage
+ * @brief Instrumented stages of the calculation pipeline.
+ */
+enum class Stage : unsigned char {
+  kTokenize,
+  kTranslate,
+  kCompile,
+  kCalculate,
+  kPlot,
+  kRender
+};
+
+/**
+ * @brief Number of instrumented stages.
+ */
+constexpr std::size_t kStageCount = 6;
+
+/**
+ * @brief Number of latency histogram buckets. Bucket i counts calls that took
+ * [2^i, 2^(i+1)) nanoseconds, the last bucket also counts everything slower.
+ */
+constexpr std::size_t kLatencyBuckets = 32;
+
+/**
+ * @struct StageStats
+ * @brief Counters of a single stage.
+ */
+struct StageStats {
+  std::uint64_t calls = 0;       /**< Number of completed calls*/
+  std::uint64_t total_ns = 0;    /**< Cumulative latency in nanoseconds*/
+  std::uint64_t points = 0;      /**< Number of points evaluated*/
+  std::uint64_t allocations = 0; /**< Heap allocations made by the stage*/
+  std::array<std::uint64_t, kLatencyBuckets> latency_histogram{}; /**<
+                                                  Log2 latency histogram*/
+};
+
+/**
+ * @brief Snapshot of all stages, indexed by Stage.
+ */
+using PipelineStats = std::array<StageStats, kStageCount>;
+
+/**
+ * @brief Returns a snapshot of the counters of all stages.
+ * @return The counters collected since the start or the last reset.
+ */
+PipelineStats CollectStats() noexcept;
+
+/**
+ * @brief Resets the counters of all stages.
+ */
+void ResetStats() noexcept;
+
+/**
+ * @brief Returns the number of heap allocations made by the current thread.
+ * @return The allocations since the thread started, 0 without S21_MODEL_STATS.
+ */
+std::uint64_t ThreadAllocations() noexcept;
+
+/**
+ * @brief Returns the human readable name of the stage.
+ * @param stage The stage.
+ * @return The stage name.
+ */
+std::string_view StageName(Stage stage) noexcept;
+
+/**
+ * @brief Returns the trace category of the stage.
+ * @param stage The stage.
+ * @return "view" for the render stage, "model" otherwise.
+ */
+constexpr const char* StageCategory(Stage stage) noexcept {
+  return stage == Stage::kRender ? "view" : "model";
+}
+
+/**
+ * @brief Formats the snapshot as a plain text table.
+ * @param stats The snapshot to format.
+ * @return One line per stage with calls, latency, points and allocations.
+ */
+std::string FormatStats(const PipelineStats& stats);
+
+/**
+ * @class ScopedStage
+ * @brief Records one call of the stage: its latency and the heap allocations
+ * made by the current thread during the object's lifetime. The call is also
+ * traced while the Tracer is enabled, under the "view" category for the
+ * render stage and the "model" category otherwise.
+ */
+class ScopedStage final {
+ public:
+  ScopedStage(const ScopedStage&) = delete;
+  ScopedStage& operator=(const ScopedStage&) = delete;
+#ifdef S21_MODEL_STATS
+  /**
+   * @brief Starts recording the stage call.
+   * @param stage The stage being called.
+   * @param points Number of points the call evaluates.
+   */
+  explicit ScopedStage(Stage stage, std::uint64_t points = 0) noexcept;
+  /**
+   * @brief Adds the call to the counters of the stage.
+   */
+  ~ScopedStage();
+
+ private:
+  ScopedTrace trace_;
+  Stage stage_;
+  std::uint64_t points_;
+  std::uint64_t allocations_;
+  std::chrono::steady_clock::time_point start_;
+#else
+  explicit ScopedStage(Stage stage, std::uint64_t = 0) noexcept
+      : trace_(StageName(stage).data(), StageCategory(stage)) {}
+
+ private:
+  ScopedTrace trace_;
+#endif
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_STATS_H_
@@ -4,41 +4,123 @@
 #include <algorithm>
 
 #include "badexpression.h"
+#include "stats.h"
 
 namespace s21 {
+namespace {
+bool StartsWith(std::string_view text, std::string_view word) noexcept {
+  return text.substr(0, word.size()) == word;
+}
+
+class ListSink final : public Tokenizer::Sink {
+ public:
+  explicit ListSink(std::list<std::string>& tokens) : tokens_(tokens) {}
+  void Push(Tokenizer::TokenType, std::string_view token) override {
+    tokens_.emplace_back(token);
+  }
+
+ private:
+  std::list<std::string>& tokens_;
+};
+}  // namespace
+
 std::list<std::string> Tokenizer::Tokenize(const std::string_view& expression) {
-  if (expression.begin() == expression.end())
-    throw BadExpression("Expression is empty");
+  ScopedStage stage(Stage::kTokenize);
   std::list<std::string> tokens;
-  pos_ = expression.begin();
+  ListSink sink(tokens);
+  Tokenize(expression, sink);
+  return tokens;
+}
+
+void Tokenizer::Tokenize(const std::string_view& expression, Sink& tokens) {
+  Parse(expression, tokens);
+  if (error_.Failed()) throw BadExpression(error_);
+}
+
+void Tokenizer::Tokenize(const std::string_view& expression, Sink& tokens,
+                         const Snapshot& from) {
+  Parse(expression, tokens, from);
+  if (error_.Failed()) throw BadExpression(error_);
+}
+
+void Tokenizer::Parse(const std::string_view& expression, Sink& tokens) {
+  begin_ = pos_ = expression.begin();
   end_ = expression.end();
   prev_token_ = TokenType::kUndefined;
   current_token_ = TokenType::kUndefined;
-  fixed_ = false;
+  last_token_ = TokenType::kUndefined;
+  fixes_.clear();
+  error_ = ParseError();
   for (; !brackets_.empty(); brackets_.pop()) {
   }
-  for (; pos_ != end_ && *pos_ == ' '; ++pos_, fixed_ = true) {
+  for (; pos_ != end_ && *pos_ == ' '; ++pos_) {
   }
+  if (pos_ == end_) {
+    error_.code = ErrorCode::kEmpty;
+    return;
+  }
+  if (pos_ != begin_) AddFix(FixKind::kSpaceTrimmed, begin_);
+  Run(tokens);
+}
+
+void Tokenizer::Parse(const std::string_view& expression, Sink& tokens,
+                      const Snapshot& from) {
+  begin_ = expression.begin();
+  pos_ = begin_ + from.offset_;
+  end_ = expression.end();
+  prev_token_ = from.prev_token_;
+  current_token_ = from.current_token_;
+  last_token_ = from.last_token_;
+  brackets_ = from.brackets_;
+  fixes_.resize(from.fixes_);
+  error_ = ParseError();
+  Run(tokens);
+}
+
+Tokenizer::Snapshot Tokenizer::Save() const {
+  Snapshot snapshot(Brackets(brackets_, resource_));
+  snapshot.offset_ = std::distance(begin_, pos_);
+  snapshot.prev_token_ = prev_token_;
+  snapshot.current_token_ = current_token_;
+  snapshot.last_token_ = last_token_;
+  snapshot.fixes_ = fixes_.size();
+  return snapshot;
+}
+
+void Tokenizer::Run(Sink& tokens) {
   do {
+    tokens.Checkpoint();
     push_ = State::kPush;
-    current_token_ = GetTokenType(*pos_);
+    ReadToken(tokens);
     Fix(tokens);
   } while (PushToken(tokens) && ValidState());
-  ThrowErrors(tokens);
-  for (; !brackets_.empty(); brackets_.pop(), fixed_ = true)
-    tokens.push_back(")");
-  return tokens;
+  SetError();
+  if (error_.Failed()) return;
+  for (; !brackets_.empty(); brackets_.pop()) {
+    AddFix(FixKind::kBracketClosed, end_);
+    Emit(tokens, TokenType::kCloseBracket, ")");
+  }
+}
+
+void Tokenizer::AddFix(FixKind kind, position at) {
+  fixes_.push_back({kind, static_cast<std::size_t>(at - begin_)});
+}
+
+void Tokenizer::Emit(Sink& dest, TokenType type, std::string_view token) {
+  last_token_ = type;
+  dest.Push(type, token);
 }
 
-void Tokenizer::Fix(std::list<std::string>& dest) {
+void Tokenizer::Fix(Sink& dest) {
   if (BracketSkipped()) {
-    dest.push_back("(");
+    AddFix(FixKind::kBracketOpened, pos_);
+    Emit(dest, TokenType::kOpenBracket, "(");
     brackets_.push(-')');
-    fixed_ = true;
   } else if (BracketFinished()) {
-    for (; !brackets_.empty() && brackets_.top() < 0;
-         brackets_.pop(), fixed_ = true)
-      dest.push_back(")");
+    for (; !brackets_.empty() && brackets_.top() < 0; brackets_.pop()) {
+      AddFix(FixKind::kBracketClosed, pos_);
+      Emit(dest, TokenType::kCloseBracket, ")");
+    }
   }
 
   if (current_token_ == TokenType::kOperator) {
@@ -50,40 +132,40 @@ void Tokenizer::Fix(std::list<std::string>& dest) {
   }
 
   if (MultiplySkipped()) {
-    fixed_ = true;
-    dest.push_back("*");
+    AddFix(FixKind::kMultiplyInserted, pos_);
+    Emit(dest, TokenType::kOperator, "*");
   } else if (BracketsBroken()) {
     push_ = State::kMismatch;
   }
 }
 
-void Tokenizer::CloseBracket() noexcept {
+void Tokenizer::CloseBracket() {
   if (brackets_.empty()) {
-    fixed_ = true;
+    AddFix(FixKind::kBracketDropped, pos_);
     push_ = State::kDiscard;
   } else {
     brackets_.pop();
   }
 }
 
-void Tokenizer::CollapseOperator(std::list<std::string>& dest) {
+void Tokenizer::CollapseOperator(Sink& dest) {
   push_ = State::kDiscard;
-  if (OpBinary(pos_)) {
-    dest.push_back(std::string(1, OpBinary(pos_)));
-  } else if (OpUnary(pos_)) {
-    dest.push_back(std::string(1, OpUnary(pos_)));
+  char op = OpBinary(symbol_) ? OpBinary(symbol_) : OpUnary(symbol_);
+  if (op) {
+    Emit(dest, TokenType::kOperator, std::string_view(&op, 1));
   } else {
     push_ = State::kMismatch;
   }
   prev_token_ = current_token_;
 }
 
-bool Tokenizer::PushToken(std::list<std::string>& dest) {
+bool Tokenizer::PushToken(Sink& dest) {
   position start = pos_;
   AdvancePosition();
   if (start == pos_) push_ = State::kFunctionErr;
   if (push_ == State::kPush) {
-    dest.push_back(std::string(start, pos_));
+    Emit(dest, current_token_,
+         std::string_view(&*start, std::distance(start, pos_)));
     prev_token_ = current_token_;
   }
   for (; pos_ != end_ && *pos_ == ' '; ++pos_) {
@@ -91,22 +173,22 @@ bool Tokenizer::PushToken(std::list<std::string>& dest) {
   return pos_ != end_;
 }
 
-char Tokenizer::OpUnary(const position& op) const noexcept {
-  if (*op == '+' || *op == '#')
+char Tokenizer::OpUnary(char op) const noexcept {
+  if (op == '+' || op == '#')
     return '#';
-  else if (*op == '-' || *op == '~')
+  else if (op == '-' || op == '~')
     return '~';
   return '\0';
 }
 
-char Tokenizer::OpBinary(const position& op) const noexcept {
+char Tokenizer::OpBinary(char op) const noexcept {
   if (!IsNumeric(prev_token_) && prev_token_ != TokenType::kCloseBracket)
     return '\0';
-  if (*op == '+' || *op == '#')
+  if (op == '+' || op == '#')
     return '+';
-  else if (*op == '-' || *op == '~')
+  else if (op == '-' || op == '~')
     return '-';
-  return *op;
+  return op;
 }
 
 constexpr bool Tokenizer::ValidState() const noexcept {
@@ -148,18 +230,29 @@ constexpr bool Tokenizer::ExprFinished(TokenType last_token) const noexcept {
   return last_token == TokenType::kCloseBracket || IsNumeric(last_token);
 }
 
+void Tokenizer::ReadToken(const Sink& names) noexcept {
+  token_ = pos_;
+  current_token_ = GetTokenType(*pos_);
+  symbol_ = *pos_;
+  width_ = 1;
+  if (current_token_ != TokenType::kFunction) return;
+  std::string_view rest(&*pos_, std::distance(pos_, end_));
+  auto keyword = std::find_if(
+      kKeywords.begin(), kKeywords.end(),
+      [rest](const Keyword& k) { return StartsWith(rest, k.word); });
+  if (keyword != kKeywords.end()) {
+    current_token_ = TokenType::kOperator;
+    symbol_ = keyword->symbol;
+    width_ = keyword->word.size();
+    return;
+  }
+  width_ = Reserved(rest);
+  if (!width_) width_ = names.Match(rest, current_token_);
+}
+
 void Tokenizer::AdvancePosition() noexcept {
-  if (OneSymboled()) {
-    ++pos_;
-  } else if (current_token_ == TokenType::kFunction) {
-    std::size_t rem = std::distance(pos_, end_);
-    auto func = kFunctions.begin();
-    for (;
-         func != kFunctions.end() &&
-         func->compare(std::string_view(&pos_[0], std::min(func->size(), rem)));
-         ++func) {
-    }
-    pos_ += std::min(func->size(), rem) * (func != kFunctions.end());
+  if (OneSymboled() || current_token_ == TokenType::kFunction) {
+    pos_ += width_;
   } else {
     for (; pos_ != end_ && (GetTokenType(*pos_) == TokenType::kDigit); ++pos_) {
     }
@@ -173,14 +266,37 @@ void Tokenizer::AdvancePosition() noexcept {
   }
 }
 
-void Tokenizer::ThrowErrors(const std::list<std::string>& tokens) const {
-  if (push_ == State::kFunctionErr)
-    throw BadExpression("Expression has unknown function");
-  else if (push_ == State::kMismatch)
-    throw BadExpression("Expression has mismatched token");
-  else if (tokens.empty() ||
-           !ExprFinished(
-               GetTokenType(*std::string_view(tokens.back().c_str()).begin())))
-    throw BadExpression("Expression is not finished");
+std::size_t Tokenizer::Reserved(std::string_view text) noexcept {
+  for (const Keyword& keyword : kKeywords)
+    if (StartsWith(text, keyword.word)) return keyword.word.size();
+  for (std::string_view function : kFunctions)
+    if (StartsWith(text, function)) return function.size();
+  return 0;
+}
+
+bool Tokenizer::IsName(std::string_view text) noexcept {
+  return !text.empty() && !Reserved(text) &&
+         std::all_of(text.begin(), text.end(), [](char symbol) {
+           return (('a' <= symbol && symbol <= 'z') ||
+                   ('A' <= symbol && symbol <= 'Z')) &&
+                  GetTokenType(symbol) == TokenType::kFunction;
+         });
+}
+
+void Tokenizer::SetError() noexcept {
+  std::size_t offset = token_ - begin_;
+  if (push_ == State::kFunctionErr) {
+    position word = token_;
+    for (; word != end_ && GetTokenType(*word) == TokenType::kFunction;
+         ++word) {
+    }
+    error_ = {ErrorCode::kUnknownFunction, offset,
+              static_cast<std::size_t>(word - token_)};
+  } else if (push_ == State::kMismatch) {
+    error_ = {ErrorCode::kMismatchedToken, offset, width_};
+  } else if (!ExprFinished(last_token_)) {
+    error_ = {ErrorCode::kNotFinished,
+              static_cast<std::size_t>(end_ - begin_), 0};
+  }
 }
 }  // namespace s21
@@ -4,8 +4,14 @@
 
 #include <array>
 #include <list>
+#include <memory_resource>
 #include <stack>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "parseerror.h"
 
 /*!
 
@@ -106,6 +112,26 @@ higher priority.
 
   /*!
 
+\fn std::size_t Tokenizer::Reserved
+\brief Matches a function or an operator keyword at the start of the text.
+\param text The text to match.
+\return The length of the function name or the keyword, 0 if none.
+*/
+  static std::size_t Reserved(std::string_view text) noexcept;
+
+  /*!
+
+\fn bool Tokenizer::IsName
+\brief Checks if the text may name a user-defined function or constant.
+\details A name consists of letters other than the variables x and y, and
+does not start with a function or a keyword, which would be matched first.
+\param text The name to check.
+\return True if the text is a valid name.
+*/
+  static bool IsName(std::string_view text) noexcept;
+
+  /*!
+
 \fn bool Tokenizer::IsOperation
 \brief Determines if the TokenType is of operation type.
 \param token A TokenType to be checked.
@@ -117,6 +143,74 @@ higher priority.
 
   /*!
 
+\class Tokenizer::Sink
+\brief Receiver of the tokens produced by the Tokenizer.
+\details Lets consumers (e.g. a compiler) process every token as soon as it
+is recognized, without materializing the token list.
+*/
+  class Sink {
+   public:
+    virtual ~Sink() = default;
+    /*!
+
+  \fn void Tokenizer::Sink::Push
+  \brief Accepts the next token of the expression.
+  \param type TokenType classification of the token.
+  \param token Text of the token, valid only during the call.
+  */
+    virtual void Push(TokenType type, std::string_view token) = 0;
+    /*!
+
+  \fn void Tokenizer::Sink::Checkpoint
+  \brief Called before the Tokenizer reads every next token from the input,
+  the only moments when Tokenizer::Save may be used.
+  */
+    virtual void Checkpoint() {}
+    /*!
+
+  \fn std::size_t Tokenizer::Sink::Match
+  \brief Matches a name defined by the receiver at the start of the text.
+  \details Called for the words that are neither functions nor keywords.
+  \param text The rest of the expression, starting with the word.
+  \param type Set to kFunction for a function or kArg for an operand.
+  \return The length of the name, 0 if no name is defined there.
+  */
+    virtual std::size_t Match(std::string_view /*text*/,
+                              TokenType& /*type*/) const noexcept {
+      return 0;
+    }
+  };
+
+  class Snapshot;
+
+  /*!
+
+\typedef Tokenizer::Brackets
+\brief A stack of the closing brackets expected, negative for the brackets
+opened by the Tokenizer itself.
+*/
+  using Brackets = std::stack<char, std::pmr::vector<char>>;
+
+  /*!
+
+\fn Tokenizer::Tokenizer
+\brief Constructs the Tokenizer.
+\param resource The memory of the bracket stack and of the snapshots.
+*/
+  explicit Tokenizer(std::pmr::memory_resource* resource =
+                         std::pmr::get_default_resource())
+      : brackets_(resource), resource_(resource) {}
+
+  /*!
+
+\fn void Tokenizer::Release
+\brief Gives the memory of the bracket stack back to the resource, so that
+the resource may be released.
+*/
+  void Release() { brackets_ = Brackets(resource_); }
+
+  /*!
+
 \fn std::liststd::string Tokenizer::Tokenize
 \brief Tokenizes the input expression.
 \param expression A string_view of the input expression.
@@ -127,12 +221,90 @@ higher priority.
 
   /*!
 
+\fn void Tokenizer::Tokenize
+\brief Tokenizes the input expression, streaming tokens into the sink.
+\param expression A string_view of the input expression.
+\param sink Receiver of the tokens, in expression order.
+\exception BadExpression If the expression is invalid.
+*/
+
+  void Tokenize(const std::string_view& expression, Sink& sink);
+
+  /*!
+
+\fn void Tokenizer::Parse
+\brief Tokenizes the input expression without throwing on invalid input.
+\details Tokenizing stops at the first error, which is available through
+Error() along with its position.
+\param expression A string_view of the input expression.
+\param sink Receiver of the tokens, in expression order.
+*/
+
+  void Parse(const std::string_view& expression, Sink& sink);
+
+  /*!
+
+\fn void Tokenizer::Tokenize
+\brief Resumes tokenizing of the input expression from the snapshot.
+\details The snapshot must be saved while tokenizing an expression that has
+the same prefix up to and including the symbol at the snapshot offset.
+\param expression A string_view of the input expression.
+\param sink Receiver of the tokens after the snapshot offset.
+\param from The state saved by Save.
+\exception BadExpression If the expression is invalid.
+*/
+
+  void Tokenize(const std::string_view& expression, Sink& sink,
+                const Snapshot& from);
+
+  /*!
+
+\fn void Tokenizer::Parse
+\brief Resumes tokenizing of the input expression from the snapshot without
+throwing on invalid input.
+\param expression A string_view of the input expression.
+\param sink Receiver of the tokens after the snapshot offset.
+\param from The state saved by Save.
+*/
+
+  void Parse(const std::string_view& expression, Sink& sink,
+             const Snapshot& from);
+
+  /*!
+
+\fn Tokenizer::Snapshot Tokenizer::Save
+\brief Saves the tokenizing state, valid inside Sink::Checkpoint only.
+\return The state needed to resume tokenizing from the current symbol.
+*/
+
+  Snapshot Save() const;
+
+  /*!
+
 \fn bool Tokenizer::ExpressionChanged
 \brief Check if the input expression has changed since last tokenizing
 operation. \return True if the expression has changed, false otherwise.
 */
 
-  bool ExpressionChanged() noexcept { return fixed_; }
+  bool ExpressionChanged() noexcept { return !fixes_.empty(); }
+
+  /*!
+
+\fn const ParseError& Tokenizer::Error
+\brief Returns the error of the last tokenizing operation.
+\return The error and the position of the offending token.
+*/
+
+  const ParseError& Error() const noexcept { return error_; }
+
+  /*!
+
+\fn const std::vector<AppliedFix>& Tokenizer::Fixes
+\brief Returns the fixes applied by the last tokenizing operation.
+\return The fixes in expression order.
+*/
+
+  const std::vector<AppliedFix>& Fixes() const noexcept { return fixes_; }
 
  private:
   using position = std::string_view::const_iterator;
@@ -154,34 +326,71 @@ operation. \return True if the expression has changed, false otherwise.
 
   /*!
 
+\struct Tokenizer::Keyword
+\brief A word-form alias of an operator symbol.
+*/
+  struct Keyword {
+    std::string_view word;
+    char symbol;
+  };
+
+  /*!
+
+\var Tokenizer::kKeywords
+\brief An array of the operator aliases, matched like the function names.
+*/
+  static constexpr std::array<Keyword, 1> kKeywords = {{{"mod", '%'}}};
+
+  /*!
+
 \enum Tokenizer::State
 \brief Enumeration for various states of the token parsing process.
 */
 
   enum class State { kPush, kDiscard, kFunctionErr, kMismatch };
   /**
-   * @brief Fixes the current token in the tokens list.
-   * @param dest The list of tokens to modify.
+   * @brief Tokenizes the rest of the expression from the current state.
+   * @param tokens The receiver of the tokens.
+   */
+  void Run(Sink& tokens);
+  /**
+   * @brief Fixes the current token in the tokens stream.
+   * @param dest The receiver of the tokens.
    */
-  void Fix(std::list<std::string>& dest);
+  void Fix(Sink& dest);
 
   /**
    * @brief Handles closing brackets in the tokenization process.
    */
-  void CloseBracket() noexcept;
+  void CloseBracket();
   /**
-   * @brief Collapses operator tokens and appends them to the list of tokens.
-   * @param dest The list of tokens.
+   * @brief Collapses operator tokens and appends them to the tokens stream.
+   * @param dest The receiver of the tokens.
    */
-  void CollapseOperator(std::list<std::string>& dest);
+  void CollapseOperator(Sink& dest);
 
   /**
-   * @brief Pushes tokens into the result list if they are part of a valid
+   * @brief Pushes tokens into the result stream if they are part of a valid
    * expression.
-   * @param dest The list of tokens.
+   * @param dest The receiver of the tokens.
    * @return true if the tokenizer position is not at the end of the expression.
    */
-  bool PushToken(std::list<std::string>& dest);
+  bool PushToken(Sink& dest);
+
+  /**
+   * @brief Passes a token to the sink and remembers its type.
+   * @param dest The receiver of the tokens.
+   * @param type TokenType classification of the token.
+   * @param token Text of the token.
+   */
+  void Emit(Sink& dest, TokenType type, std::string_view token);
+
+  /**
+   * @brief Classifies the token at the current position, recognizing the
+   * operator keywords, the functions and the names defined by the sink.
+   * @param names The sink, matching the user-defined names.
+   */
+  void ReadToken(const Sink& names) noexcept;
 
   /**
    * @brief Advances the position in the given input expression and handles
@@ -190,26 +399,33 @@ operation. \return True if the expression has changed, false otherwise.
   void AdvancePosition() noexcept;
 
   /**
-   * @brief Throws errors based on invalid states in the tokenization process.
-   * @param tokens The list of tokens.
+   * @brief Records the error based on invalid states in the tokenization
+   * process.
    */
-  void ThrowErrors(const std::list<std::string>& tokens) const;
+  void SetError() noexcept;
+
+  /**
+   * @brief Records a fix applied before the given position.
+   * @param kind The applied fix.
+   * @param at The position of the fix in the expression.
+   */
+  void AddFix(FixKind kind, position at);
 
   /**
    * @brief Returns the unary operation symbol based on the given operator
    * character.
-   * @param op The position of the operator character.
+   * @param op The operator character.
    * @return The unary operation symbol as a char.
    */
-  char OpUnary(const position& op) const noexcept;
+  char OpUnary(char op) const noexcept;
 
   /**
    * @brief Returns the binary operation symbol based on the given operator
    * character.
-   * @param op The position of the operator character.
+   * @param op The operator character.
    * @return The binary operation symbol as a char.
    */
-  char OpBinary(const position& op) const noexcept;
+  char OpBinary(char op) const noexcept;
 
   /**
    * @brief Checks if the tokenizer is in a valid state.
@@ -274,6 +490,13 @@ operation. \return True if the expression has changed, false otherwise.
   ;
   /*!
 
+\private
+\var Tokenizer::last_token_
+\brief The TokenType of the last token passed to the sink.
+*/
+  TokenType last_token_ = TokenType::kUndefined;
+  /*!
+
 \private
 \var Tokenizer::push_
 \brief The current parsing state of the tokenizing process.
@@ -281,11 +504,33 @@ operation. \return True if the expression has changed, false otherwise.
   State push_ = State::kPush;
   /*!
 
+\private
+\var Tokenizer::symbol_
+\brief The operator symbol of the current token.
+*/
+  char symbol_ = '\0';
+  /*!
+
+\private
+\var Tokenizer::token_
+\brief The position of the current token in the input expression.
+*/
+  position token_ = std::string_view("").begin();
+  /*!
+
+\private
+\var Tokenizer::width_
+\brief The length of the current token if it is one symbol, a keyword or a
+name, 0 for an unknown word.
+*/
+  std::size_t width_ = 1;
+  /*!
+
 \private
 \var Tokenizer::brackets_
 \brief A stack for tracking open brackets.
 */
-  std::stack<char> brackets_ = std::stack<char>();
+  Brackets brackets_;
   /*!
 
 \private
@@ -296,6 +541,13 @@ expression.
   position pos_ = std::string_view("").begin();
   /*!
 
+\private
+\var Tokenizer::begin_
+\brief A position iterator pointing to the beginning of the input expression.
+*/
+  position begin_ = std::string_view("").begin();
+  /*!
+
 \private
 \var Tokenizer::end_
 \brief A position iterator pointing to the end of the input expression.
@@ -305,11 +557,56 @@ expression.
   /*!
 
 \private
-\var Tokenizer::fixed_
-\brief A boolean flag indicating if the expression has changed since the last
-tokenizing operation.
+\var Tokenizer::fixes_
+\brief The fixes applied to the expression since the last tokenizing
+operation.
+*/
+  std::vector<AppliedFix> fixes_;
+
+  /*!
+
+\private
+\var Tokenizer::resource_
+\brief The memory of the bracket stack and of the snapshots.
+*/
+  std::pmr::memory_resource* resource_;
+
+  /*!
+
+\private
+\var Tokenizer::error_
+\brief The error of the last tokenizing operation.
 */
-  bool fixed_ = false;
+  ParseError error_;
+};
+
+/*!
+
+\class Tokenizer::Snapshot
+\brief Saved state of the Tokenizer between two tokens, used to resume
+tokenizing of an edited expression without re-reading its unchanged prefix.
+*/
+class Tokenizer::Snapshot final {
+ public:
+  /*!
+
+\fn std::size_t Tokenizer::Snapshot::Offset
+\brief Returns the offset of the next symbol to be read.
+\return Offset from the beginning of the expression.
+*/
+  std::size_t Offset() const noexcept { return offset_; }
+
+ private:
+  friend class Tokenizer;
+
+  explicit Snapshot(Brackets brackets) : brackets_(std::move(brackets)) {}
+
+  std::size_t offset_ = 0;
+  TokenType prev_token_ = TokenType::kUndefined;
+  TokenType current_token_ = TokenType::kUndefined;
+  TokenType last_token_ = TokenType::kUndefined;
+  Brackets brackets_;
+  std::size_t fixes_ = 0;
 };
 }  // namespace s21
 
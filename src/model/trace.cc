@@ -0,0 +1,109 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace s21 {
+namespace {
+struct Event {
+  const char* name;
+  const char* category;
+  Tracer::clock::time_point start;
+  Tracer::clock::time_point end;
+  int tid;
+};
+
+std::mutex registry_mutex;
+std::vector<Event> retired_events;
+std::atomic<int> next_tid{0};
+
+class ThreadBuffer;
+std::vector<ThreadBuffer*> live_buffers;
+
+class ThreadBuffer final {
+ public:
+  ThreadBuffer() : tid_(++next_tid) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    live_buffers.push_back(this);
+  }
+  ~ThreadBuffer() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    MoveTo(retired_events);
+    live_buffers.erase(
+        std::find(live_buffers.begin(), live_buffers.end(), this));
+  }
+
+  void Push(const char* name, const char* category,
+            Tracer::clock::time_point start, Tracer::clock::time_point end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back({name, category, start, end, tid_});
+  }
+
+  void MoveTo(std::vector<Event>& dest) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dest.insert(dest.end(), events_.begin(), events_.end());
+    events_.clear();
+  }
+
+ private:
+  int tid_;
+  std::mutex mutex_;
+  std::vector<Event> events_;
+};
+
+thread_local ThreadBuffer thread_buffer;
+
+std::vector<Event> TakeEvents() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  std::vector<Event> events;
+  events.swap(retired_events);
+  for (ThreadBuffer* buffer : live_buffers) buffer->MoveTo(events);
+  return events;
+}
+
+double Microseconds(Tracer::clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+}  // namespace
+
+Tracer& Tracer::Instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+void Tracer::Start(const std::string& path) {
+  TakeEvents();
+  path_ = path;
+  origin_ = clock::now();
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+bool Tracer::Stop() {
+  if (!enabled_.exchange(false)) return false;
+  std::vector<Event> events = TakeEvents();
+  std::sort(events.begin(), events.end(),
+            [](const Event& l, const Event& r) { return l.start < r.start; });
+  std::FILE* file = std::fopen(path_.c_str(), "w");
+  if (!file) return false;
+  std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    const Event& event = events[i];
+    std::fprintf(file,
+                 "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                 "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                 i ? "," : "", event.name, event.category,
+                 Microseconds(event.start - origin_),
+                 Microseconds(event.end - event.start), event.tid);
+  }
+  std::fputs("\n]}\n", file);
+  return std::fclose(file) == 0;
+}
+
+void Tracer::Record(const char* name, const char* category,
+                    clock::time_point start, clock::time_point end) {
+  thread_buffer.Push(name, category, start, end);
+}
+}  // namespace s21
@@ -0,0 +1,108 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file trace.h
+ * @brief Scoped trace events written as Chrome trace-event JSON, viewable in
+ * chrome://tracing or Perfetto.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_MODEL_TRACE_H_
+#define CPP3_SMARTCALC_V2_SRC_MODEL_TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace s21 {
+/**
+ * @class Tracer
+ * @brief Process-wide collector of complete ("X") trace events.
+ * @details Events are buffered per thread and merged when the trace is
+ * stopped, so recording does not contend on a lock. While the tracer is not
+ * started every ScopedTrace costs a single relaxed atomic load.
+ */
+class Tracer final {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Returns the process-wide tracer.
+   * @return The tracer instance.
+   */
+  static Tracer& Instance();
+
+  /**
+   * @brief Starts recording events to be written to the file.
+   * @param path The file the JSON is written to when the trace is stopped.
+   */
+  void Start(const std::string& path);
+
+  /**
+   * @brief Stops recording and writes the collected events.
+   * @return false if the trace was not started or the file cannot be written.
+   */
+  bool Stop();
+
+  /**
+   * @brief Checks if events are being recorded.
+   * @return true between Start and Stop.
+   */
+  bool Enabled() const noexcept {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Records a complete event of the calling thread.
+   * @param name Event name, a string literal.
+   * @param category Event category, a string literal.
+   * @param start The moment the event started.
+   * @param end The moment the event finished.
+   */
+  void Record(const char* name, const char* category, clock::time_point start,
+              clock::time_point end);
+
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+ private:
+  Tracer() = default;
+
+  std::atomic<bool> enabled_{false}; /**< Recording flag*/
+  std::string path_;                 /**< Output file of the trace*/
+  clock::time_point origin_;         /**< Zero timestamp of the trace*/
+};
+
+/**
+ * @class ScopedTrace
+ * @brief Records a complete trace event covering the object's lifetime.
+ */
+class ScopedTrace final {
+ public:
+  /**
+   * @brief Starts the event if the tracer is enabled.
+   * @param name Event name, a string literal.
+   * @param category Event category, a string literal.
+   */
+  ScopedTrace(const char* name, const char* category) noexcept
+      : name_(Tracer::Instance().Enabled() ? name : nullptr),
+        category_(category) {
+    if (name_) start_ = Tracer::clock::now();
+  }
+  /**
+   * @brief Finishes the event.
+   */
+  ~ScopedTrace() {
+    if (name_)
+      Tracer::Instance().Record(name_, category_, start_,
+                                Tracer::clock::now());
+  }
+
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+ private:
+  const char* name_;
+  const char* category_;
+  Tracer::clock::time_point start_;
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_MODEL_TRACE_H_
@@ -3,9 +3,12 @@
 
 #include <string>
 
+#include "stats.h"
+
 namespace s21 {
 std::list<std::string> ShuntingYardTranslator::Translate(
     const std::list<std::string>& tokens) {
+  ScopedStage stage(Stage::kTranslate);
   std::list<std::string> reverse_polish_notation;
   for (auto token : tokens) {
     current_token_ = Tokenizer::GetTokenType(token.at(0));
@@ -13,10 +16,10 @@ std::list<std::string> ShuntingYardTranslator::Translate(
       reverse_polish_notation.push_back(token);
     } else if (current_token_ == TokenType::kFunction ||
                current_token_ == TokenType::kOpenBracket) {
-      operator_stack_.push(token);
+      operator_stack_.emplace(token);
     } else if (current_token_ == TokenType::kOperator) {
       while (PriorityLess(token)) PushToOut(reverse_polish_notation);
-      operator_stack_.push(token);
+      operator_stack_.emplace(token);
     } else if (current_token_ == TokenType::kCloseBracket) {
       while (NotOpenBracket()) PushToOut(reverse_polish_notation);
       operator_stack_.pop();
@@ -26,6 +29,8 @@ std::list<std::string> ShuntingYardTranslator::Translate(
   while (!operator_stack_.empty()) {
     PushToOut(reverse_polish_notation);
   }
+  operator_stack_ = decltype(operator_stack_)(resource_);
+  if (resource_ == arena_.Resource()) arena_.Release();
   return reverse_polish_notation;
 }
 }  // namespace s21
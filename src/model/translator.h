@@ -8,9 +8,12 @@
 #define CPP3_SMARTCALC_V2_SRC_MODEL_TRANSLATOR_H_
 
 #include <list>
+#include <memory_resource>
 #include <stack>
 #include <string>
+#include <vector>
 
+#include "arena.h"
 #include "tokenizer.h"
 
 namespace s21 {
@@ -18,11 +21,25 @@ namespace s21 {
  * @class ShuntingYardTranslator
  * @brief This class is responsible for translating tokens obtained with the
  * Tokenizer into Reverse Polish Notation (RPN).
+ * @details The operator stack is allocated from a ScratchArena released after
+ * every translation, unless another memory resource is given.
  */
 class ShuntingYardTranslator final {
  public:
   using TokenType = Tokenizer::TokenType;
 
+  /**
+   * @brief Constructs the translator.
+   * @param resource The memory of the operator stack, kept until the
+   * translator is destroyed; nullptr for the arena of the translator.
+   */
+  explicit ShuntingYardTranslator(
+      std::pmr::memory_resource* resource = nullptr)
+      : resource_(resource ? resource : arena_.Resource()),
+        operator_stack_(resource_) {}
+  ShuntingYardTranslator(const ShuntingYardTranslator&) = delete;
+  ShuntingYardTranslator& operator=(const ShuntingYardTranslator&) = delete;
+
   /**
    * @brief Translates a list of tokens into Reverse Polish Notation (RPN)
    * format
@@ -77,9 +94,11 @@ class ShuntingYardTranslator final {
                TokenType::kFunction;
   }
 
-  std::stack<std::string> operator_stack_ =
-      std::stack<std::string>(); /**< Stack for holding operators and
-                                    functions*/
+  ScratchArena arena_; /**< Default memory of the operator stack*/
+  std::pmr::memory_resource* resource_; /**< The memory of the operator
+                                           stack*/
+  std::stack<std::pmr::string, std::pmr::vector<std::pmr::string>>
+      operator_stack_; /**< Stack for holding operators and functions*/
   TokenType current_token_ =
       TokenType(); /**< The current TokenType being processed*/
 };
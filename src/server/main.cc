@@ -0,0 +1,31 @@
+#include <clocale>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#include "server.h"
+
+namespace {
+s21::Server *server = nullptr;
+
+void Stop(int) { server->Stop(); }
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  std::setlocale(LC_NUMERIC, "C");
+  std::string path = argc > 1 ? argv[1] : "/tmp/smartcalc.sock";
+  try {
+    s21::Server instance(path);
+    server = &instance;
+    std::signal(SIGINT, Stop);
+    std::signal(SIGTERM, Stop);
+    instance.Run();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+  } catch (const std::system_error &e) {
+    std::cerr << "smartcalc-server: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,47 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "protocol.h"
+
+#include <cstring>
+
+namespace s21 {
+FrameState SplitFrame(std::string_view input, Frame& frame,
+                      std::size_t& used) noexcept {
+  std::uint32_t size = 0;
+  if (input.size() < sizeof(size)) return FrameState::kIncomplete;
+  std::memcpy(&size, input.data(), sizeof(size));
+  if (size > kMaxFrameSize || size < kFrameHeaderSize - sizeof(size))
+    return FrameState::kOversized;
+  if (input.size() - sizeof(size) < size) return FrameState::kIncomplete;
+  std::memcpy(&frame.id, input.data() + sizeof(size), sizeof(frame.id));
+  frame.kind = static_cast<std::uint8_t>(input[kFrameHeaderSize - 1]);
+  frame.body = input.substr(kFrameHeaderSize, size + sizeof(size) -
+                                                  kFrameHeaderSize);
+  used = size + sizeof(size);
+  return FrameState::kComplete;
+}
+
+FrameWriter::FrameWriter(std::string& out, std::uint32_t id,
+                         std::uint8_t kind)
+    : out_(out), start_(out.size()) {
+  out_.resize(start_ + sizeof(std::uint32_t));
+  U32(id);
+  U8(kind);
+}
+
+FrameWriter::~FrameWriter() {
+  auto size = static_cast<std::uint32_t>(out_.size() - start_ -
+                                         sizeof(std::uint32_t));
+  std::memcpy(&out_[start_], &size, sizeof(size));
+}
+
+void FrameWriter::Raw(const void* data, std::size_t size) {
+  out_.append(static_cast<const char*>(data), size);
+}
+
+bool BodyReader::Raw(void* data, std::size_t size) noexcept {
+  if (body_.size() < size) return false;
+  std::memcpy(data, body_.data(), size);
+  body_.remove_prefix(size);
+  return true;
+}
+}  // namespace s21
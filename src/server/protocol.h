@@ -0,0 +1,153 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file protocol.h
+ * @brief Binary protocol of the evaluation server.
+ * @details Requests and replies are frames of the same layout, in the host
+ * byte order since clients run on the same host:
+ *
+ * | field | type     | contents                                         |
+ * |-------|----------|--------------------------------------------------|
+ * | size  | uint32   | size of the rest of the frame in bytes           |
+ * | id    | uint32   | chosen by the client, echoed by the reply        |
+ * | kind  | uint8    | RequestType of a request, ReplyStatus of a reply |
+ * | body  | size - 5 | depends on the kind                              |
+ *
+ * Request bodies:
+ * - kCompile: the expression; the reply carries its uint32 handle.
+ * - kEvaluate: uint32 handle, then the double arguments; the reply carries
+ *   a double result per argument.
+ * - kPlot: uint32 handle, then double x_left, x_right, y_min, y_max; the
+ *   reply carries uint32 n, then n double x and n double y. A range that is
+ *   not finite or not ordered is kMalformed.
+ * - kRelease: uint32 handle; the reply is empty.
+ *
+ * A kBadExpression reply carries uint8 ErrorCode, uint32 offset, uint32
+ * length and the message; other failures carry the message only. Replies to
+ * the requests of a connection may come in any order.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_SERVER_PROTOCOL_H_
+#define CPP3_SMARTCALC_V2_SRC_SERVER_PROTOCOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace s21 {
+/**
+ * @brief Kind of a request frame.
+ */
+enum class RequestType : std::uint8_t {
+  kCompile = 1,
+  kEvaluate = 2,
+  kPlot = 3,
+  kRelease = 4,
+};
+
+/**
+ * @brief Kind of a reply frame.
+ */
+enum class ReplyStatus : std::uint8_t {
+  kOk = 0,
+  kBadExpression = 1, /**< The expression was rejected*/
+  kUnknownHandle = 2, /**< The handle is not held by the connection*/
+  kMalformed = 3,     /**< Unknown kind or truncated body*/
+};
+
+/**
+ * @brief Size of the frame fields preceding the body.
+ */
+constexpr std::size_t kFrameHeaderSize = 9;
+
+/**
+ * @brief Maximum value of the size field; larger frames close the
+ * connection.
+ */
+constexpr std::uint32_t kMaxFrameSize = 64u << 20;
+
+/**
+ * @struct Frame
+ * @brief A frame split from the input, pointing into it.
+ */
+struct Frame {
+  std::uint32_t id = 0;   /**< Id of the request*/
+  std::uint8_t kind = 0;  /**< RequestType or ReplyStatus*/
+  std::string_view body;  /**< The body*/
+};
+
+/**
+ * @brief Outcome of splitting a frame from the input.
+ */
+enum class FrameState { kIncomplete, kComplete, kOversized };
+
+/**
+ * @brief Splits the first frame from the input.
+ * @param input Received bytes.
+ * @param frame Receives the frame if it is complete.
+ * @param used Receives the size of the frame if it is complete.
+ * @return kComplete if a frame was split, kIncomplete if more bytes are
+ * needed, kOversized if the size field exceeds kMaxFrameSize or is too
+ * small to hold the id and the kind.
+ */
+FrameState SplitFrame(std::string_view input, Frame& frame,
+                      std::size_t& used) noexcept;
+
+/**
+ * @class FrameWriter
+ * @brief Appends a frame to a buffer, field by field.
+ */
+class FrameWriter final {
+ public:
+  /**
+   * @brief Starts the frame, whose size is set by the destructor.
+   * @param out The buffer.
+   * @param id Id of the request.
+   * @param kind RequestType or ReplyStatus.
+   */
+  FrameWriter(std::string& out, std::uint32_t id, std::uint8_t kind);
+  FrameWriter(const FrameWriter&) = delete;
+  FrameWriter& operator=(const FrameWriter&) = delete;
+  ~FrameWriter();
+
+  void U8(std::uint8_t value) { out_.push_back(static_cast<char>(value)); }
+  void U32(std::uint32_t value) { Raw(&value, sizeof(value)); }
+  void F64(double value) { Raw(&value, sizeof(value)); }
+  void Doubles(const double* values, std::size_t n) {
+    Raw(values, n * sizeof(double));
+  }
+  void Bytes(std::string_view bytes) { out_.append(bytes); }
+
+ private:
+  void Raw(const void* data, std::size_t size);
+
+  std::string& out_;  /**< The buffer*/
+  std::size_t start_; /**< Offset of the size field*/
+};
+
+/**
+ * @class BodyReader
+ * @brief Reads the fields of a frame body with bounds checks.
+ */
+class BodyReader final {
+ public:
+  explicit BodyReader(std::string_view body) noexcept : body_(body) {}
+
+  bool U8(std::uint8_t& value) noexcept { return Raw(&value, 1); }
+  bool U32(std::uint32_t& value) noexcept {
+    return Raw(&value, sizeof(value));
+  }
+  bool F64(double& value) noexcept { return Raw(&value, sizeof(value)); }
+
+  /**
+   * @brief Returns the unread bytes.
+   */
+  std::string_view Rest() const noexcept { return body_; }
+
+ private:
+  bool Raw(void* data, std::size_t size) noexcept;
+
+  std::string_view body_; /**< The unread bytes*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_SERVER_PROTOCOL_H_
@@ -0,0 +1,362 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include "server.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <utility>
+
+namespace s21 {
+namespace {
+constexpr int kMaxEvents = 64;
+constexpr std::size_t kReadSize = 64 * 1024;
+
+[[noreturn]] void ThrowErrno(const char* what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+void Watch(int epoll, int op, int fd, std::uint32_t events) {
+  epoll_event event{};
+  event.events = events;
+  event.data.fd = fd;
+  if (epoll_ctl(epoll, op, fd, &event) < 0) ThrowErrno("epoll_ctl");
+}
+}  // namespace
+
+Server::Server(std::string path) : path_(std::move(path)) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path_.size() >= sizeof(address.sun_path))
+    throw std::system_error(ENAMETOOLONG, std::generic_category(), path_);
+  std::memcpy(address.sun_path, path_.c_str(), path_.size() + 1);
+  try {
+    listener_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener_ < 0) ThrowErrno("socket");
+    unlink(path_.c_str());
+    if (bind(listener_, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) < 0)
+      ThrowErrno("bind");
+    if (listen(listener_, SOMAXCONN) < 0) ThrowErrno("listen");
+    epoll_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_ < 0) ThrowErrno("epoll_create1");
+    wakeup_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_ < 0) ThrowErrno("eventfd");
+    Watch(epoll_, EPOLL_CTL_ADD, listener_, EPOLLIN);
+    Watch(epoll_, EPOLL_CTL_ADD, wakeup_, EPOLLIN);
+  } catch (...) {
+    Shutdown();
+    throw;
+  }
+}
+
+Server::~Server() { Shutdown(); }
+
+void Server::Stop() noexcept {
+  std::uint64_t one = 1;
+  [[maybe_unused]] ssize_t written = write(wakeup_, &one, sizeof(one));
+}
+
+void Server::Run() {
+  epoll_event events[kMaxEvents];
+  for (bool stopped = false; !stopped;) {
+    int count = epoll_wait(epoll_, events, kMaxEvents, -1);
+    if (count < 0) {
+      if (errno == EINTR) continue;
+      ThrowErrno("epoll_wait");
+    }
+    for (int i = 0; i < count; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == wakeup_) {
+        std::uint64_t value = 0;
+        stopped = read(wakeup_, &value, sizeof(value)) > 0;
+      } else if (fd == listener_) {
+        Accept();
+      } else if (auto it = connections_.find(fd); it != connections_.end()) {
+        if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+          Receive(fd, it->second);
+        if (events[i].events & EPOLLOUT) Send(fd, it->second);
+      }
+    }
+    Evaluate();
+    Release();
+    for (auto it = connections_.begin(); it != connections_.end();) {
+      Connection& connection = it->second;
+      if (connection.finished) Send(it->first, connection);
+      if (connection.closed ||
+          (connection.finished && connection.output.empty())) {
+        Close(it->first, connection);
+        it = connections_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (auto& [fd, connection] : connections_) Send(fd, connection);
+  }
+}
+
+void Server::Accept() {
+  for (;;) {
+    int fd = accept4(listener_, nullptr, nullptr,
+                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      return;
+    }
+    Watch(epoll_, EPOLL_CTL_ADD, fd, EPOLLIN);
+    connections_[fd];
+  }
+}
+
+void Server::Receive(int fd, Connection& connection) {
+  if (connection.closed || connection.finished) return;
+  for (;;) {
+    std::size_t size = connection.input.size();
+    connection.input.resize(size + kReadSize);
+    ssize_t got = read(fd, &connection.input[size], kReadSize);
+    connection.input.resize(size + std::max<ssize_t>(got, 0));
+    if (got > 0) continue;
+    if (got < 0 && errno == EINTR) continue;
+    if (got == 0) {
+      connection.finished = true;
+      Watch(epoll_, EPOLL_CTL_MOD, fd, connection.writing ? EPOLLOUT : 0u);
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      connection.closed = true;
+    }
+    break;
+  }
+  std::string_view input = connection.input;
+  Frame frame;
+  std::size_t used = 0;
+  for (FrameState state; !connection.closed;) {
+    state = SplitFrame(input, frame, used);
+    if (state == FrameState::kIncomplete) break;
+    if (state == FrameState::kOversized) {
+      connection.closed = true;
+      break;
+    }
+    Handle(fd, connection, frame);
+    input.remove_prefix(used);
+  }
+  connection.input.erase(0, connection.input.size() - input.size());
+}
+
+void Server::Send(int fd, Connection& connection) {
+  if (connection.closed) return;
+  while (connection.sent < connection.output.size()) {
+    ssize_t put = send(fd, connection.output.data() + connection.sent,
+                       connection.output.size() - connection.sent,
+                       MSG_NOSIGNAL);
+    if (put > 0) {
+      connection.sent += put;
+    } else if (put < 0 && errno == EINTR) {
+      continue;
+    } else {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) connection.closed = true;
+      break;
+    }
+  }
+  if (connection.sent == connection.output.size()) {
+    connection.output.clear();
+    connection.sent = 0;
+  }
+  bool writing = !connection.output.empty() && !connection.closed;
+  if (writing != connection.writing) {
+    std::uint32_t events = connection.finished ? 0u : EPOLLIN;
+    Watch(epoll_, EPOLL_CTL_MOD, fd, writing ? events | EPOLLOUT : events);
+    connection.writing = writing;
+  }
+}
+
+void Server::Handle(int fd, Connection& connection, const Frame& frame) {
+  BodyReader body(frame.body);
+  Deferred request{fd, frame.id, 0};
+  switch (static_cast<RequestType>(frame.kind)) {
+    case RequestType::kCompile:
+      return Compile(connection, frame);
+    case RequestType::kPlot:
+      return Plot(connection, frame);
+    case RequestType::kEvaluate:
+      if (body.U32(request.handle) &&
+          body.Rest().size() % sizeof(double) == 0) {
+        request.first = x_.size();
+        request.count = body.Rest().size() / sizeof(double);
+        x_.resize(request.first + request.count);
+        std::memcpy(x_.data() + request.first, body.Rest().data(),
+                    body.Rest().size());
+        return evaluates_.push_back(request);
+      }
+      break;
+    case RequestType::kRelease:
+      if (body.U32(request.handle) && body.Rest().empty())
+        return releases_.push_back(request);
+      break;
+  }
+  Fail(connection.output, frame.id, ReplyStatus::kMalformed,
+       "Malformed request");
+}
+
+void Server::Compile(Connection& connection, const Frame& frame) {
+  std::string expression(frame.body);
+  auto known = by_text_.find(expression);
+  std::uint32_t handle = 0;
+  if (known != by_text_.end()) {
+    handle = known->second;
+  } else {
+    auto model = std::make_unique<DefaultModel>(DefaultModel::kNoSizeLimit);
+    ParseResult result = model->TrySetExpression(expression);
+    if (!result)
+      return Reject(connection.output, frame.id, result.error,
+                    result.error.Message());
+    while (!next_handle_ || entries_.count(next_handle_)) ++next_handle_;
+    handle = next_handle_++;
+    by_text_[expression] = handle;
+    entries_[handle] = {std::move(model), std::move(expression), 0};
+    live_handles_.store(entries_.size());
+  }
+  ++entries_[handle].references;
+  ++connection.handles[handle];
+  FrameWriter reply(connection.output, frame.id,
+                    static_cast<std::uint8_t>(ReplyStatus::kOk));
+  reply.U32(handle);
+}
+
+void Server::Plot(Connection& connection, const Frame& frame) {
+  BodyReader body(frame.body);
+  std::uint32_t handle = 0;
+  double x_left = 0, x_right = 0, y_min = 0, y_max = 0;
+  if (!body.U32(handle) || !body.F64(x_left) || !body.F64(x_right) ||
+      !body.F64(y_min) || !body.F64(y_max) || !body.Rest().empty())
+    return Fail(connection.output, frame.id, ReplyStatus::kMalformed,
+                "Malformed request");
+  if (!connection.handles.count(handle))
+    return Fail(connection.output, frame.id, ReplyStatus::kUnknownHandle,
+                "Unknown handle");
+  if (!std::isfinite(x_left) || !std::isfinite(x_right) ||
+      !(x_left <= x_right) || !(y_min <= y_max))
+    return Fail(connection.output, frame.id, ReplyStatus::kMalformed,
+                "Invalid plot range");
+  DefaultModel::set_type set;
+  try {
+    set = entries_[handle].model->Plot(x_left, x_right, y_min, y_max);
+  } catch (const BadExpression& error) {
+    return Reject(connection.output, frame.id, error.error(), error.what());
+  } catch (const std::bad_alloc&) {
+    return Fail(connection.output, frame.id, ReplyStatus::kMalformed,
+                "Plot is too large");
+  }
+  FrameWriter reply(connection.output, frame.id,
+                    static_cast<std::uint8_t>(ReplyStatus::kOk));
+  reply.U32(static_cast<std::uint32_t>(set.first.size()));
+  reply.Doubles(set.first.data(), set.first.size());
+  reply.Doubles(set.second.data(), set.second.size());
+}
+
+void Server::Evaluate() {
+  std::stable_sort(
+      evaluates_.begin(), evaluates_.end(),
+      [](const Deferred& a, const Deferred& b) { return a.handle < b.handle; });
+  for (auto group = evaluates_.begin(); group != evaluates_.end();) {
+    auto end = std::find_if(group, evaluates_.end(), [&](const Deferred& d) {
+      return d.handle != group->handle;
+    });
+    auto entry = entries_.find(group->handle);
+    batch_.clear();
+    for (auto it = group; it != end; ++it) {
+      Connection& connection = connections_.find(it->fd)->second;
+      if (connection.closed) continue;
+      if (entry == entries_.end() || !connection.handles.count(it->handle)) {
+        Fail(connection.output, it->id, ReplyStatus::kUnknownHandle,
+             "Unknown handle");
+        continue;
+      }
+      batch_.insert(batch_.end(), x_.begin() + it->first,
+                    x_.begin() + it->first + it->count);
+    }
+    if (!batch_.empty()) {
+      y_.resize(batch_.size());
+      entry->second.model->Calculate(batch_.data(), y_.data(), batch_.size());
+      evaluations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::size_t offset = 0;
+    for (auto it = group; it != end && entry != entries_.end(); ++it) {
+      Connection& connection = connections_.find(it->fd)->second;
+      if (connection.closed || !connection.handles.count(it->handle)) continue;
+      FrameWriter reply(connection.output, it->id,
+                        static_cast<std::uint8_t>(ReplyStatus::kOk));
+      reply.Doubles(y_.data() + offset, it->count);
+      offset += it->count;
+    }
+    group = end;
+  }
+  evaluates_.clear();
+  x_.clear();
+}
+
+void Server::Release() {
+  for (const Deferred& request : releases_) {
+    Connection& connection = connections_.find(request.fd)->second;
+    if (connection.closed) continue;
+    auto held = connection.handles.find(request.handle);
+    if (held == connection.handles.end()) {
+      Fail(connection.output, request.id, ReplyStatus::kUnknownHandle,
+           "Unknown handle");
+      continue;
+    }
+    if (!--held->second) connection.handles.erase(held);
+    Drop(request.handle);
+    FrameWriter reply(connection.output, request.id,
+                      static_cast<std::uint8_t>(ReplyStatus::kOk));
+  }
+  releases_.clear();
+}
+
+void Server::Shutdown() noexcept {
+  for (auto& [fd, connection] : connections_) close(fd);
+  connections_.clear();
+  for (int* fd : {&listener_, &epoll_, &wakeup_}) {
+    if (*fd >= 0) close(*fd);
+    *fd = -1;
+  }
+  unlink(path_.c_str());
+}
+
+void Server::Close(int fd, Connection& connection) {
+  for (auto [handle, count] : connection.handles)
+    while (count--) Drop(handle);
+  connection.handles.clear();
+  close(fd);
+}
+
+void Server::Drop(std::uint32_t handle) {
+  auto entry = entries_.find(handle);
+  if (entry == entries_.end() || --entry->second.references) return;
+  by_text_.erase(entry->second.expression);
+  entries_.erase(entry);
+  live_handles_.store(entries_.size());
+}
+
+void Server::Fail(std::string& out, std::uint32_t id, ReplyStatus status,
+                  std::string_view message) {
+  FrameWriter reply(out, id, static_cast<std::uint8_t>(status));
+  reply.Bytes(message);
+}
+
+void Server::Reject(std::string& out, std::uint32_t id,
+                    const ParseError& error, std::string_view message) {
+  FrameWriter reply(out, id,
+                    static_cast<std::uint8_t>(ReplyStatus::kBadExpression));
+  reply.U8(static_cast<std::uint8_t>(error.code));
+  reply.U32(static_cast<std::uint32_t>(error.offset));
+  reply.U32(static_cast<std::uint32_t>(error.length));
+  reply.Bytes(message);
+}
+}  // namespace s21
@@ -0,0 +1,149 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+/**
+ * @file server.h
+ * @brief Header file for the Server class, which serves the model to local
+ * processes over a Unix domain socket.
+ */
+#ifndef CPP3_SMARTCALC_V2_SRC_SERVER_SERVER_H_
+#define CPP3_SMARTCALC_V2_SRC_SERVER_SERVER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../model/defaultmodel.h"
+#include "protocol.h"
+
+namespace s21 {
+/**
+ * @class Server
+ * @brief Single-threaded epoll event loop answering protocol.h requests.
+ * @details Compiled expressions are kept by handle, shared by the
+ * connections compiling the same text and released once no connection holds
+ * them. The requests received in one wake-up of the loop are answered
+ * together: the kEvaluate requests of every connection are grouped by
+ * handle and each group is evaluated by a single batch call. Releases are
+ * applied after the evaluations of the same wake-up. A client that shuts
+ * down its writing side still gets the replies to the requests it sent; the
+ * connection is closed once they are written.
+ */
+class Server final {
+ public:
+  /**
+   * @brief Binds and listens on the socket, replacing a stale socket file.
+   * @param path Path of the socket.
+   * @exception std::system_error If the socket cannot be set up.
+   */
+  explicit Server(std::string path);
+  Server(const Server&) = delete;
+  Server& operator=(const Server&) = delete;
+
+  /**
+   * @brief Closes the connections and removes the socket file.
+   */
+  ~Server();
+
+  /**
+   * @brief Serves the requests until Stop is called.
+   * @exception std::system_error If waiting for events fails.
+   */
+  void Run();
+
+  /**
+   * @brief Makes Run return; safe to call from other threads and signal
+   * handlers.
+   */
+  void Stop() noexcept;
+
+  /**
+   * @brief Returns the number of batch evaluations done.
+   * @return The number of groups of kEvaluate requests evaluated.
+   */
+  std::size_t Evaluations() const noexcept { return evaluations_.load(); }
+
+  /**
+   * @brief Returns the number of kept expressions.
+   * @return The number of live handles.
+   */
+  std::size_t Handles() const noexcept { return live_handles_.load(); }
+
+ private:
+  /**
+   * @struct Entry
+   * @brief A compiled expression.
+   */
+  struct Entry {
+    std::unique_ptr<DefaultModel> model; /**< Holds the compiled program*/
+    std::string expression;              /**< The source text*/
+    std::size_t references = 0;          /**< Connections holding it*/
+  };
+
+  /**
+   * @struct Connection
+   * @brief A client and its buffers.
+   */
+  struct Connection {
+    std::string input;           /**< Received bytes not yet split*/
+    std::string output;          /**< Replies not yet sent*/
+    std::size_t sent = 0;        /**< Bytes of output already sent*/
+    bool writing = false;        /**< Registered for EPOLLOUT*/
+    bool closed = false;         /**< Closed, erased after the wake-up*/
+    bool finished = false;       /**< Peer shut down its writing side*/
+    /** Handles held, with the number of times each was compiled*/
+    std::unordered_map<std::uint32_t, std::size_t> handles;
+  };
+
+  /**
+   * @struct Deferred
+   * @brief A kEvaluate or kRelease request waiting for the end of the
+   * wake-up.
+   */
+  struct Deferred {
+    int fd;                /**< Connection of the request*/
+    std::uint32_t id;      /**< Id of the request*/
+    std::uint32_t handle;  /**< The handle*/
+    std::size_t first = 0; /**< First argument in the batch*/
+    std::size_t count = 0; /**< Number of arguments*/
+  };
+
+  void Accept();
+  void Receive(int fd, Connection& connection);
+  void Send(int fd, Connection& connection);
+  void Handle(int fd, Connection& connection, const Frame& frame);
+  void Compile(Connection& connection, const Frame& frame);
+  void Plot(Connection& connection, const Frame& frame);
+  void Evaluate();
+  void Release();
+  void Close(int fd, Connection& connection);
+  void Shutdown() noexcept;
+  void Drop(std::uint32_t handle);
+  static void Fail(std::string& out, std::uint32_t id, ReplyStatus status,
+                   std::string_view message);
+  static void Reject(std::string& out, std::uint32_t id,
+                     const ParseError& error, std::string_view message);
+
+  std::string path_;      /**< Path of the socket*/
+  int listener_ = -1;     /**< Listening socket*/
+  int epoll_ = -1;        /**< The epoll instance*/
+  int wakeup_ = -1;       /**< eventfd signalled by Stop*/
+  /** Clients by fd*/
+  std::unordered_map<int, Connection> connections_;
+  /** Compiled expressions by handle*/
+  std::unordered_map<std::uint32_t, Entry> entries_;
+  /** Handles by expression*/
+  std::unordered_map<std::string, std::uint32_t> by_text_;
+  std::uint32_t next_handle_ = 1;   /**< Handle of the next expression*/
+  std::vector<Deferred> evaluates_; /**< kEvaluate of the wake-up*/
+  std::vector<Deferred> releases_;  /**< kRelease of the wake-up*/
+  std::vector<double> x_;           /**< Arguments of the wake-up*/
+  std::vector<double> batch_, y_;   /**< Arguments and results of a batch*/
+  std::atomic<std::size_t> evaluations_{0};  /**< Batch evaluations done*/
+  std::atomic<std::size_t> live_handles_{0}; /**< Size of entries_*/
+};
+}  // namespace s21
+
+#endif  // CPP3_SMARTCALC_V2_SRC_SERVER_SERVER_H_
@@ -0,0 +1,91 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "../src/model/approximation.h"
+#include "../src/model/calculator.h"
+#include "../src/model/compiler.h"
+
+class ApproximationTest : public ::testing::Test {
+ protected:
+  void Fit(const char* expression, double left, double right,
+           double tolerance) {
+    program = compiler.Compile(expression);
+    approximation.Fit(
+        [this](const double* x, double* y, std::size_t n) {
+          calc.Calculate(program, x, y, n);
+        },
+        left, right, tolerance);
+  }
+
+  double MaxError(double left, double right, std::size_t* exact = nullptr) {
+    double error = 0;
+    for (int i = 0; i <= 10000; ++i) {
+      double x = left + (right - left) * i / 10000, y = 0;
+      double expected = calc.Calculate(program, x);
+      if (!approximation.Calculate(x, y)) {
+        if (exact) ++*exact;
+        continue;
+      }
+      error = std::max(error, std::fabs(y - expected) /
+                                  std::max(1.0, std::fabs(expected)));
+    }
+    return error;
+  }
+
+  s21::ShuntingYardCompiler compiler;
+  s21::RPNCalculator calc;
+  s21::Program program;
+  s21::Approximation approximation;
+};
+
+TEST_F(ApproximationTest, case_smooth) {
+  Fit("sin(x)*exp(-x/10)+ln(x+20)", -10, 10, 1e-12);
+  EXPECT_LE(MaxError(-10, 10), 1e-11);
+  EXPECT_EQ(approximation.ExactPieces(), 0u);
+  EXPECT_LE(approximation.Pieces(), 4u);
+  EXPECT_TRUE(approximation.Covers(-5, 10));
+  EXPECT_FALSE(approximation.Covers(-5, 11));
+  double y = 0;
+  EXPECT_FALSE(approximation.Calculate(10.5, y));
+}
+
+TEST_F(ApproximationTest, case_trimmed) {
+  Fit("3x^2-2x+1", -100, 100, 1e-12);
+  ASSERT_EQ(approximation.Pieces(), 1u);
+  EXPECT_EQ(approximation.Coefficients(), 3u);
+  Fit("5", -1, 1, 1e-12);
+  EXPECT_EQ(approximation.Coefficients(), 1u);
+  double y = 0;
+  EXPECT_TRUE(approximation.Calculate(0.3, y));
+  EXPECT_DOUBLE_EQ(y, 5);
+}
+
+TEST_F(ApproximationTest, case_singularities) {
+  Fit("1/x+tan(x)", -4, 4, 1e-9);
+  std::size_t exact = 0;
+  EXPECT_LE(MaxError(-4, 4, &exact), 1e-8);
+  EXPECT_GT(approximation.ExactPieces(), 0u);
+  EXPECT_LT(exact, 100u);
+  double y = 0;
+  EXPECT_FALSE(approximation.Calculate(0, y));
+  EXPECT_FALSE(approximation.Calculate(std::acos(0), y));
+  EXPECT_TRUE(approximation.Calculate(1, y));
+}
+
+TEST_F(ApproximationTest, case_domain_edge) {
+  Fit("sqrt(x)+ln(x)", -1, 3, 1e-10);
+  std::size_t exact = 0;
+  EXPECT_LE(MaxError(-1, 3, &exact), 1e-9);
+  approximation.Clear();
+  double y = 0;
+  EXPECT_FALSE(approximation.Calculate(1, y));
+  EXPECT_EQ(approximation.Pieces(), 0u);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
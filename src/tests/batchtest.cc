@@ -0,0 +1,142 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../src/model/batch.h"
+#include "../src/model/defaultmodel.h"
+
+namespace {
+std::vector<double> Inputs(std::size_t n) {
+  std::vector<double> x(n);
+  for (std::size_t i = 0; i < n; ++i) x[i] = i * 0.25 - 3;
+  return x;
+}
+
+void ExpectSame(const std::vector<s21::BatchJob>& jobs,
+                const std::vector<s21::BatchResult>& results) {
+  ASSERT_EQ(results.size(), jobs.size());
+  s21::DefaultModel model(s21::DefaultModel::kNoSizeLimit);
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    ASSERT_TRUE(results[i]) << i << ": " << results[i].message;
+    model.setExpression(jobs[i].expression);
+    ASSERT_EQ(results[i].outputs.size(), jobs[i].inputs.size());
+    for (std::size_t j = 0; j < jobs[i].inputs.size(); ++j) {
+      double expected = model.Calculate(jobs[i].inputs[j]);
+      if (std::isnan(expected))
+        EXPECT_TRUE(std::isnan(results[i].outputs[j])) << i << " " << j;
+      else
+        EXPECT_EQ(expected, results[i].outputs[j]) << i << " " << j;
+    }
+  }
+}
+
+/**
+ * @brief Counts the models created and throws from Calculate on x = 13.
+ */
+class ThrowingModel final : public s21::ICalculationModel {
+ public:
+  explicit ThrowingModel(std::atomic<int>& created) { ++created; }
+
+  double Calculate(double x) override {
+    if (x == 13) throw std::runtime_error("unlucky");
+    return model_.Calculate(x);
+  }
+  set_type Plot(double x_left, double x_right, double y_min,
+                double y_max) override {
+    return model_.Plot(x_left, x_right, y_min, y_max);
+  }
+  void setExpression(const std::string_view& expr) override {
+    model_.setExpression(expr);
+  }
+  bool ExressionChanged() noexcept override {
+    return model_.ExressionChanged();
+  }
+  s21::PipelineStats Stats() const override { return model_.Stats(); }
+  void ResetStats() override { model_.ResetStats(); }
+
+ private:
+  s21::DefaultModel model_;
+};
+}  // namespace
+
+TEST(BatchTest, case_order) {
+  std::vector<s21::BatchJob> jobs;
+  for (int i = 0; i < 500; ++i)
+    jobs.push_back({"x*" + std::to_string(i) + "+sin(x)", Inputs(i % 17)});
+  s21::BatchEvaluator batch(4);
+  EXPECT_EQ(batch.Threads(), 4u);
+  std::vector<s21::BatchResult> results = batch.Run(jobs);
+  ExpectSame(jobs, results);
+  for (int i = 0; i < 500; ++i) {
+    if (!jobs[i].inputs.empty()) {
+      EXPECT_DOUBLE_EQ(results[i].outputs[0], -3 * i + std::sin(-3));
+    }
+  }
+}
+
+TEST(BatchTest, case_errors) {
+  std::vector<s21::BatchJob> jobs = {{"2+x", {1, 2}},
+                                     {"2+", {1}},
+                                     {"sqrt(x", {4}},
+                                     {"x$", {1}},
+                                     {"log(x)", {100, -1}}};
+  std::vector<s21::BatchResult> results = s21::BatchEvaluator(3).Run(jobs);
+  ASSERT_EQ(results.size(), 5u);
+  EXPECT_TRUE(results[0]);
+  EXPECT_EQ(results[0].outputs, (std::vector<double>{3, 4}));
+  EXPECT_FALSE(results[1]);
+  EXPECT_TRUE(results[1].outputs.empty());
+  EXPECT_FALSE(results[1].message.empty());
+  EXPECT_TRUE(results[2]);
+  EXPECT_EQ(results[2].outputs, (std::vector<double>{2}));
+  EXPECT_FALSE(results[3]);
+  EXPECT_EQ(results[3].error.offset, 1u);
+  EXPECT_TRUE(results[4]);
+  EXPECT_EQ(results[4].outputs[0], 2);
+  EXPECT_TRUE(std::isnan(results[4].outputs[1]));
+}
+
+TEST(BatchTest, case_uneven) {
+  std::vector<s21::BatchJob> jobs(301, {"x^2-2*x", {}});
+  jobs[0].inputs = Inputs(100000);
+  jobs[150].inputs = Inputs(50000);
+  for (std::size_t i = 1; i < jobs.size(); i += 7) jobs[i].inputs = Inputs(3);
+  s21::BatchEvaluator batch(8);
+  ExpectSame(jobs, batch.Run(jobs));
+  EXPECT_TRUE(batch.Run({}).empty());
+}
+
+TEST(BatchTest, case_factory) {
+  std::atomic<int> created{0};
+  s21::BatchEvaluator batch(
+      2, [&created] { return std::make_unique<ThrowingModel>(created); });
+  std::vector<s21::BatchJob> jobs(64, {"x+1", {1, 2, 3}});
+  for (int run = 0; run < 3; ++run) ExpectSame(jobs, batch.Run(jobs));
+  EXPECT_LE(created.load(), 2);
+
+  jobs[40].inputs.push_back(13);
+  EXPECT_THROW(batch.Run(jobs), std::runtime_error);
+  jobs[40].inputs.pop_back();
+  ExpectSame(jobs, batch.Run(jobs));
+  EXPECT_LE(created.load(), 2);
+}
+
+TEST(BatchTest, case_single_thread) {
+  std::vector<s21::BatchJob> jobs = {{"1/x", {2, 4}}, {"x mod 3", {7}}};
+  std::vector<s21::BatchResult> results = s21::BatchEvaluator(1).Run(jobs);
+  ExpectSame(jobs, results);
+  EXPECT_EQ(results[0].outputs, (std::vector<double>{0.5, 0.25}));
+  EXPECT_EQ(results[1].outputs, (std::vector<double>{1}));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
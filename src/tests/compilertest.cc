@@ -0,0 +1,327 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+#include "../model/badexpression.h"
+#include "../src/model/calculator.h"
+#include "../src/model/compiler.h"
+#include "../src/model/translator.h"
+
+class CountingResource final : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations = 0;
+  std::size_t outstanding = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+class CompilerTest : public ::testing::Test {
+ protected:
+  void ExpectSameAsTranslator(const std::string& expression) {
+    s21::Tokenizer tokenizer;
+    s21::ShuntingYardTranslator translator;
+    std::list<std::string> rpn =
+        translator.Translate(tokenizer.Tokenize(expression));
+    s21::Program program = compiler.Compile(expression);
+    EXPECT_EQ(tokenizer.ExpressionChanged(), compiler.ExpressionChanged());
+    for (double x : {-2.5, -1.0, 0.0, 0.5, 3.0}) {
+      double expected = calc.Calculate(rpn, x);
+      double returned = calc.Calculate(program, x);
+      if (std::isnan(expected))
+        EXPECT_TRUE(std::isnan(returned)) << expression;
+      else
+        EXPECT_DOUBLE_EQ(expected, returned) << expression;
+    }
+  }
+
+  s21::ShuntingYardCompiler compiler;
+  s21::RPNCalculator calc;
+};
+
+TEST_F(CompilerTest, case_operators) {
+  ExpectSameAsTranslator("1+2*3-4/5");
+  ExpectSameAsTranslator("2^3^2");
+  ExpectSameAsTranslator("-2^2");
+  ExpectSameAsTranslator("3-+-4");
+  ExpectSameAsTranslator("5+5%2*x");
+  ExpectSameAsTranslator("8^-x");
+}
+
+TEST_F(CompilerTest, case_functions) {
+  ExpectSameAsTranslator("sin(cos(tan(2+3^6)))");
+  ExpectSameAsTranslator("log(-1*(sin(5) ^ 2 * cos(2) - 1))");
+  ExpectSameAsTranslator("ln(x)+tg(x)-ctg(x)*cot(x)/atg(x)");
+  ExpectSameAsTranslator("asin(x/4)+acos(x/4)+atan(x)+acot(x)+actg(x)");
+  ExpectSameAsTranslator("sqrt(exp(x))");
+}
+
+TEST_F(CompilerTest, case_fixes) {
+  ExpectSameAsTranslator("4(1+2)cos(x*7-2)+sin2x");
+  ExpectSameAsTranslator("cos-xcosx-sinxcossqrtsin(1-xx+sqrt(1+cossin2x))");
+  ExpectSameAsTranslator("((cos(x-tgcossinsin(xsin(1-xx))+xcosx");
+  ExpectSameAsTranslator(")))0))00)0(sin(0)x");
+  ExpectSameAsTranslator("  sin  ~(2~xx     -sin  (0 ))    ");
+}
+
+TEST_F(CompilerTest, case_scientific) {
+  ExpectSameAsTranslator("exp(-9.1e-31*xx/(2*1.38e-23*10e6))");
+  ExpectSameAsTranslator("9.1e-31*1.6e-19");
+}
+
+TEST_F(CompilerTest, case_bytecode) {
+  s21::Program program = compiler.Compile("2x+1");
+  ASSERT_EQ(program.Code().size(), 5u);
+  EXPECT_EQ(program.Code()[0].op, s21::Opcode::kNumber);
+  EXPECT_EQ(program.Code()[0].value, 2);
+  EXPECT_EQ(program.Code()[1].op, s21::Opcode::kArg);
+  EXPECT_EQ(program.Code()[2].op, s21::Opcode::kMul);
+  EXPECT_EQ(program.Code()[3].op, s21::Opcode::kNumber);
+  EXPECT_EQ(program.Code()[4].op, s21::Opcode::kAdd);
+  EXPECT_EQ(program.MaxDepth(), 2);
+  EXPECT_TRUE(compiler.ExpressionChanged());
+}
+
+TEST_F(CompilerTest, case_stack_depth) {
+  EXPECT_EQ(compiler.Compile("x").MaxDepth(), 1);
+  EXPECT_EQ(compiler.Compile("1+2*3").MaxDepth(), 3);
+  EXPECT_EQ(compiler.Compile("1*2+3").MaxDepth(), 2);
+  EXPECT_EQ(compiler.Compile("2^3^2").MaxDepth(), 3);
+  EXPECT_EQ(compiler.Compile("sin(cos(tan(x)))").MaxDepth(), 1);
+  EXPECT_EQ(compiler.Compile("((((1+2)+3)+4)+5)").MaxDepth(), 2);
+  EXPECT_EQ(compiler.Compile("1+(2+(3+(4+5)))").MaxDepth(), 5);
+}
+
+TEST_F(CompilerTest, case_unbalanced) {
+  s21::Program program;
+  EXPECT_FALSE(program.Valid());
+  EXPECT_THROW(calc.Calculate(program), s21::BadExpression);
+  program.Emit(s21::Opcode::kAdd);
+  EXPECT_FALSE(program.Valid());
+  EXPECT_THROW(calc.Calculate(program), s21::BadExpression);
+  program.Clear();
+  program.Emit(s21::Opcode::kArg);
+  program.Emit(s21::Opcode::kArg);
+  EXPECT_FALSE(program.Valid());
+  program.Emit(s21::Opcode::kMul);
+  EXPECT_TRUE(program.Valid());
+  EXPECT_NEAR(calc.Calculate(program, 3), 9, 1e-7);
+}
+
+TEST_F(CompilerTest, case_broken_number) {
+  s21::Program program = compiler.Compile("2.33.4cos(x0)");
+  EXPECT_FALSE(program.Valid());
+  EXPECT_THROW(calc.Calculate(program), s21::BadExpression);
+}
+
+TEST_F(CompilerTest, case_error) {
+  EXPECT_THROW(compiler.Compile("sin(cos())"), s21::BadExpression);
+  EXPECT_THROW(compiler.Compile("2@3"), s21::BadExpression);
+  EXPECT_NEAR(calc.Calculate(compiler.Compile("2+2")), 4, 1e-7);
+}
+
+TEST_F(CompilerTest, case_second_variable) {
+  EXPECT_FALSE(compiler.Compile("x*y").Valid());
+  compiler.AllowY(true);
+  s21::Program program = compiler.Compile("x*y");
+  ASSERT_TRUE(program.Valid());
+  EXPECT_EQ(program.Code()[1].op, s21::Opcode::kArgY);
+  compiler.AllowY(false);
+  EXPECT_FALSE(compiler.Recompile("x*y").Valid());
+}
+
+TEST_F(CompilerTest, case_try_compile) {
+  s21::ParseResult result = compiler.TryCompile("2sin(x");
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.fixes.size(), 2u);
+  EXPECT_NEAR(calc.Calculate(result.program, 1), 2 * std::sin(1), 1e-7);
+  result = compiler.TryCompile("2+sin(cos())");
+  EXPECT_FALSE(result);
+  EXPECT_EQ(result.error.code, s21::ErrorCode::kMismatchedToken);
+  EXPECT_EQ(result.error.offset, 10u);
+}
+
+TEST_F(CompilerTest, case_try_compile_number) {
+  s21::ParseResult result = compiler.TryCompile("x+2.33.4cos(x)");
+  EXPECT_FALSE(result);
+  EXPECT_EQ(result.error.code, s21::ErrorCode::kInvalidNumber);
+  EXPECT_EQ(result.error.offset, 2u);
+  EXPECT_EQ(result.error.length, 6u);
+  EXPECT_EQ(compiler.TryCompile("1e999").error.code,
+            s21::ErrorCode::kInvalidNumber);
+}
+
+TEST_F(CompilerTest, case_try_compile_blank) {
+  std::unique_ptr<char[]> blank(new char[3]{' ', ' ', ' '});
+  s21::ParseResult result =
+      compiler.TryCompile(std::string_view(blank.get(), 3));
+  EXPECT_FALSE(result);
+  EXPECT_EQ(result.error.code, s21::ErrorCode::kEmpty);
+  EXPECT_EQ(compiler.TryCompile(" ").error.code, s21::ErrorCode::kEmpty);
+  EXPECT_EQ(compiler.TryCompile("").error.code, s21::ErrorCode::kEmpty);
+}
+
+TEST_F(CompilerTest, case_large) {
+  std::size_t depth = 50000;
+  std::string nested =
+      std::string(depth, '(') + "x+1" + std::string(depth, ')');
+  EXPECT_NEAR(calc.Calculate(compiler.Compile(nested), 2), 3, 1e-7);
+  std::string functions;
+  for (std::size_t i = 0; i < depth; ++i) functions += "sqrt(";
+  functions += "x" + std::string(depth, ')');
+  EXPECT_NEAR(calc.Calculate(compiler.Compile(functions), 1), 1, 1e-7);
+  std::string sum = "0";
+  for (int i = 0; sum.size() < 100 * 1024; ++i) sum += i % 2 ? "+x" : "-x";
+  s21::Program program = compiler.Compile(sum);
+  EXPECT_EQ(program.MaxDepth(), 2);
+  EXPECT_NEAR(calc.Calculate(program, 5), 0, 1e-7);
+}
+
+class RecompileTest : public ::testing::Test {
+ protected:
+  void ExpectSameAsCompile(const std::string& expression) {
+    s21::ShuntingYardCompiler reference;
+    bool thrown = false;
+    s21::Program expected;
+    try {
+      expected = reference.Compile(expression);
+    } catch (s21::BadExpression&) {
+      thrown = true;
+    }
+    if (thrown) {
+      EXPECT_THROW(compiler.Recompile(expression), s21::BadExpression)
+          << expression;
+      return;
+    }
+    s21::Program returned = compiler.Recompile(expression);
+    EXPECT_EQ(reference.ExpressionChanged(), compiler.ExpressionChanged())
+        << expression;
+    EXPECT_EQ(expected.Valid(), returned.Valid()) << expression;
+    EXPECT_EQ(expected.MaxDepth(), returned.MaxDepth()) << expression;
+    ASSERT_EQ(expected.Code().size(), returned.Code().size()) << expression;
+    for (std::size_t i = 0; i < expected.Code().size(); ++i) {
+      EXPECT_EQ(expected.Code()[i].op, returned.Code()[i].op) << expression;
+      if (expected.Code()[i].op == s21::Opcode::kNumber && expected.Valid()) {
+        EXPECT_EQ(expected.Code()[i].value, returned.Code()[i].value)
+            << expression;
+      }
+    }
+  }
+
+  void Type(const std::string& expression) {
+    for (std::size_t i = 1; i <= expression.size(); ++i)
+      ExpectSameAsCompile(expression.substr(0, i));
+  }
+
+  s21::ShuntingYardCompiler compiler;
+};
+
+TEST_F(RecompileTest, case_typing) {
+  Type("sin(2xx(1+x))cos2x(1-x)");
+  Type("exp(-9.1e-31*xx/(2*1.38e-23*10e6))");
+  Type("  sin  ~(2~xx     -sin  (0 ))    ");
+}
+
+TEST_F(RecompileTest, case_backspace) {
+  std::string expression = "((cos(x-tgcossinsin(xsin(1-xx))+xcosx";
+  for (std::size_t i = expression.size(); i > 0; --i)
+    ExpectSameAsCompile(expression.substr(0, i));
+}
+
+TEST_F(RecompileTest, case_edit_middle) {
+  ExpectSameAsCompile("1+2*sin(x)-3");
+  ExpectSameAsCompile("1+25*sin(x)-3");
+  ExpectSameAsCompile("1+25^sin(x)-3");
+  ExpectSameAsCompile("1+25^sinx-3");
+  ExpectSameAsCompile("7+25^sinx-3");
+  ExpectSameAsCompile("7+25^sinx-3.");
+  ExpectSameAsCompile("2.33.4cos(x0)");
+  ExpectSameAsCompile("2.33*4cos(x0)");
+}
+
+TEST_F(RecompileTest, case_deep_nesting) {
+  Type("sin(cos(2*(1+(x-(3^(x/(4+sqrt(x*(5-ln(x)))))))))");
+  std::string nested = std::string(200, '(') + "x+1" + std::string(200, ')');
+  ExpectSameAsCompile(nested);
+  ExpectSameAsCompile(nested.replace(150, 1, "2*("));
+  ExpectSameAsCompile(nested.replace(210, 1, "-"));
+  ExpectSameAsCompile(nested.erase(100, 10));
+}
+
+TEST_F(RecompileTest, case_mixed_with_compile) {
+  ExpectSameAsCompile("1+2*x");
+  compiler.Compile("3-x");
+  ExpectSameAsCompile("1+2*x^2");
+}
+
+TEST(CompilerMemoryTest, case_resource) {
+  CountingResource resource;
+  s21::ShuntingYardCompiler compiler(&resource);
+  s21::RPNCalculator calc;
+  std::string nested = std::string(100, '(') + "x+1" + std::string(100, ')');
+  EXPECT_DOUBLE_EQ(calc.Calculate(compiler.Compile("sin(" + nested + ")"), 1),
+                   std::sin(2));
+  EXPECT_GT(resource.allocations, 0u);
+  EXPECT_EQ(resource.outstanding, 0u);
+  compiler.Recompile(nested + "*2");
+  EXPECT_GT(resource.outstanding, 0u);
+  EXPECT_DOUBLE_EQ(calc.Calculate(compiler.Recompile(nested + "*3"), 1), 6);
+  compiler.Compile("x");
+  EXPECT_EQ(resource.outstanding, 0u);
+
+  s21::ShuntingYardTranslator translator(&resource);
+  s21::Tokenizer tokenizer;
+  EXPECT_EQ(translator.Translate(tokenizer.Tokenize("sin(x)+2")).size(), 4u);
+  EXPECT_EQ(resource.outstanding, 0u);
+}
+
+TEST(CompilerMemoryTest, case_arena) {
+  CountingResource upstream;
+  std::pmr::memory_resource* previous =
+      std::pmr::set_default_resource(&upstream);
+  {
+    s21::ShuntingYardCompiler compiler;
+    s21::RPNCalculator calc;
+    EXPECT_DOUBLE_EQ(calc.Calculate(compiler.Compile("sin(x)*(1+x)"), 0), 0);
+    EXPECT_EQ(upstream.allocations, 0u);
+    std::string nested =
+        std::string(5000, '(') + "x" + std::string(5000, ')');
+    EXPECT_DOUBLE_EQ(calc.Calculate(compiler.Compile(nested), 2), 2);
+    EXPECT_GT(upstream.allocations, 0u);
+    EXPECT_EQ(upstream.outstanding, 0u);
+    compiler.Recompile(nested);
+    std::size_t first = upstream.outstanding;
+    for (std::size_t i = 0; i < 300; ++i) {
+      std::string edited = nested;
+      edited[i * 7919 % 5000] = '-';
+      compiler.Recompile(edited);
+    }
+    EXPECT_LE(upstream.outstanding, 2 * first);
+  }
+  EXPECT_EQ(upstream.outstanding, 0u);
+  std::pmr::set_default_resource(previous);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
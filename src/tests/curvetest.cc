@@ -0,0 +1,140 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../src/controller/controller.h"
+#include "../src/model/curve.h"
+#include "../src/model/defaultmodel.h"
+
+TEST(CurveTest, case_parameter) {
+  s21::DefaultModel model;
+  auto curve = model.PlotCurve(s21::CurveKind::kParametric,
+                               {"tan(t)+sqrt(t)", "2t"}, 0, 1, -5, 5, -5, 5);
+  ASSERT_FALSE(curve.first.empty());
+  EXPECT_DOUBLE_EQ(curve.first.back(), std::tan(1) + 1);
+  EXPECT_DOUBLE_EQ(curve.second.back(), 2);
+  model.Define("t", "", "100");
+  curve = model.PlotCurve(s21::CurveKind::kParametric, {"t", "t*t"}, 0, 1, -5,
+                          5, -5, 5);
+  ASSERT_FALSE(curve.first.empty());
+  EXPECT_DOUBLE_EQ(curve.first.back(), 1);
+  EXPECT_DOUBLE_EQ(curve.second.back(), 1);
+  EXPECT_THROW(model.PlotCurve(s21::CurveKind::kParametric, {"x*t", "t"}, 0,
+                               1, -5, 5, -5, 5),
+               s21::BadExpression);
+  EXPECT_THROW(model.PlotCurve(s21::CurveKind::kPolar, {"x"}, 0, 1, -5, 5,
+                               -5, 5),
+               s21::BadExpression);
+  model.setExpression("x*t");
+  EXPECT_EQ(model.Calculate(2), 200);
+}
+
+TEST(CurveTest, case_parametric) {
+  s21::DefaultModel model;
+  model.setExpression("x^2");
+  auto curve = model.PlotCurve(s21::CurveKind::kParametric,
+                               {"cos(t)", "sin(2*t)"}, 0, 1, -2, 2, -2, 2);
+  ASSERT_GE(curve.first.size(), s21::CurveSampler::kInitialSamples);
+  ASSERT_EQ(curve.first.size(), curve.second.size());
+  EXPECT_DOUBLE_EQ(curve.first.front(), 1);
+  EXPECT_DOUBLE_EQ(curve.second.front(), 0);
+  EXPECT_DOUBLE_EQ(curve.first.back(), std::cos(1));
+  EXPECT_DOUBLE_EQ(curve.second.back(), std::sin(2));
+  for (std::size_t i = 0; i < curve.first.size(); ++i) {
+    double t = std::acos(curve.first[i]);
+    EXPECT_NEAR(curve.second[i], std::sin(2 * t), 1e-9) << i;
+  }
+  EXPECT_EQ(model.Calculate(3), 9);
+
+  EXPECT_THROW(model.PlotCurve(s21::CurveKind::kParametric, {"t"}, 0, 1, -2,
+                               2, -2, 2),
+               s21::BadExpression);
+  EXPECT_THROW(model.PlotCurve(s21::CurveKind::kParametric, {"t", "t+"}, 0,
+                               1, -2, 2, -2, 2),
+               s21::BadExpression);
+  EXPECT_THROW(model.PlotCurve(s21::CurveKind::kParametric, {"t", "t"}, 1, 0,
+                               -2, 2, -2, 2),
+               s21::BadExpression);
+}
+
+TEST(CurveTest, case_polar) {
+  s21::DefaultModel model;
+  auto curve = model.PlotCurve(s21::CurveKind::kPolar, {"2"}, 0, 2 * M_PI,
+                               -3, 3, -3, 3);
+  ASSERT_FALSE(curve.first.empty());
+  for (std::size_t i = 0; i < curve.first.size(); ++i)
+    EXPECT_NEAR(std::hypot(curve.first[i], curve.second[i]), 2, 1e-12) << i;
+  EXPECT_NEAR(curve.first.back(), 2, 1e-12);
+  EXPECT_NEAR(curve.second.back(), 0, 1e-12);
+
+  curve = model.PlotCurve(s21::CurveKind::kPolar, {"t"}, 0, 4 * M_PI, -20, 20,
+                          -1, 1);
+  for (double y : curve.second) {
+    if (!std::isnan(y)) {
+      EXPECT_LE(std::fabs(y), 3);
+    }
+  }
+  EXPECT_TRUE(std::any_of(curve.second.begin(), curve.second.end(),
+                          [](double y) { return std::isnan(y); }));
+}
+
+TEST(CurveTest, case_refinement) {
+  s21::DefaultModel model;
+  auto slow = model.PlotCurve(s21::CurveKind::kParametric, {"t", "t"}, 0, 1,
+                              -1, 1, -1, 1);
+  EXPECT_EQ(slow.first.size(), s21::CurveSampler::kInitialSamples);
+
+  auto fast = model.PlotCurve(s21::CurveKind::kParametric,
+                              {"cos(100*t)", "sin(100*t)"}, 0, 1, -1, 1, -1,
+                              1);
+  EXPECT_GT(fast.first.size(), s21::CurveSampler::kInitialSamples);
+  EXPECT_LE(fast.first.size(), s21::CurveSampler::kMaxSamples);
+  double longest = 0;
+  for (std::size_t i = 0; i + 1 < fast.first.size(); ++i) {
+    double step = std::hypot(fast.first[i + 1] - fast.first[i],
+                             fast.second[i + 1] - fast.second[i]);
+    longest = std::max(longest, step);
+  }
+  EXPECT_LE(longest, 2 / s21::CurveSampler::kResolution);
+
+  auto hidden = model.PlotCurve(s21::CurveKind::kParametric,
+                                {"cos(100*t)+10", "sin(100*t)"}, 0, 1, -1, 1,
+                                -1, 1);
+  EXPECT_EQ(hidden.first.size(), s21::CurveSampler::kInitialSamples);
+}
+
+TEST(CurveTest, case_parse_curve) {
+  using s21::CalcModelController;
+  s21::CurveKind kind;
+  std::vector<std::string> components;
+  double t_min, t_max;
+  EXPECT_FALSE(CalcModelController::ParseCurve("sin(x)", kind, components,
+                                               t_min, t_max));
+  ASSERT_TRUE(CalcModelController::ParseCurve(" cos(t) , sin(t) ", kind,
+                                              components, t_min, t_max));
+  EXPECT_EQ(kind, s21::CurveKind::kParametric);
+  EXPECT_EQ(components, std::vector<std::string>({"cos(t)", "sin(t)"}));
+  EXPECT_EQ(t_min, 0);
+  EXPECT_DOUBLE_EQ(t_max, 2 * M_PI);
+  ASSERT_TRUE(CalcModelController::ParseCurve("r = 1+cos(t), -1.5, 3", kind,
+                                              components, t_min, t_max));
+  EXPECT_EQ(kind, s21::CurveKind::kPolar);
+  EXPECT_EQ(components, std::vector<std::string>({"1+cos(t)"}));
+  EXPECT_EQ(t_min, -1.5);
+  EXPECT_EQ(t_max, 3);
+  EXPECT_THROW(CalcModelController::ParseCurve("t, t, 1", kind, components,
+                                               t_min, t_max),
+               s21::BadExpression);
+  EXPECT_THROW(CalcModelController::ParseCurve("r=t, 0, a", kind, components,
+                                               t_min, t_max),
+               s21::BadExpression);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../src/model/decimation.h"
+
+using set_type = s21::ICalculationModel::set_type;
+
+set_type Sample(std::size_t n, double (*f)(std::size_t)) {
+  set_type set;
+  for (std::size_t i = 0; i < n; ++i) {
+    set.first.push_back(i * 0.001);
+    set.second.push_back(f(i));
+  }
+  return set;
+}
+
+std::size_t Nans(const set_type& set) {
+  return std::count_if(set.second.begin(), set.second.end(),
+                       [](double y) { return std::isnan(y); });
+}
+
+TEST(DecimationTest, case_small_input) {
+  set_type set = Sample(100, [](std::size_t i) { return i * 1.0; });
+  set_type returned = s21::Decimate(set, 50);
+  EXPECT_EQ(returned, set);
+}
+
+TEST(DecimationTest, case_envelope) {
+  constexpr std::size_t kColumns = 200;
+  set_type set =
+      Sample(20000, [](std::size_t i) { return std::sin(i * 0.37); });
+  set_type returned = s21::Decimate(set, kColumns);
+  EXPECT_LE(returned.first.size(), 4 * kColumns);
+  EXPECT_EQ(returned.first.front(), set.first.front());
+  EXPECT_EQ(returned.first.back(), set.first.back());
+  EXPECT_TRUE(std::is_sorted(returned.first.begin(), returned.first.end()));
+  std::size_t per_column = set.first.size() / kColumns;
+  for (std::size_t column = 0; column < kColumns; ++column) {
+    auto begin = set.second.begin() + column * per_column;
+    double low = *std::min_element(begin, begin + per_column);
+    double high = *std::max_element(begin, begin + per_column);
+    double x_begin = set.first[column * per_column];
+    double x_end = set.first[(column + 1) * per_column - 1];
+    double returned_low = INFINITY, returned_high = -INFINITY;
+    for (std::size_t i = 0; i < returned.first.size(); ++i) {
+      if (returned.first[i] < x_begin || returned.first[i] > x_end) continue;
+      returned_low = std::min(returned_low, returned.second[i]);
+      returned_high = std::max(returned_high, returned.second[i]);
+    }
+    EXPECT_EQ(low, returned_low);
+    EXPECT_EQ(high, returned_high);
+  }
+}
+
+TEST(DecimationTest, case_gap) {
+  set_type set = Sample(10000, [](std::size_t i) {
+    return i > 4000 && i < 6000 ? NAN : i * 1.0;
+  });
+  set_type returned = s21::Decimate(set, 100);
+  EXPECT_EQ(Nans(returned), 1u);
+  auto gap = std::find_if(returned.second.begin(), returned.second.end(),
+                          [](double y) { return std::isnan(y); });
+  EXPECT_EQ(*(gap - 1), 4000);
+  EXPECT_EQ(*(gap + 1), 6000);
+}
+
+TEST(DecimationTest, case_many_gaps) {
+  constexpr std::size_t kColumns = 10;
+  set_type set = Sample(10000, [](std::size_t i) {
+    return i % 3 ? std::cos(i * 0.01) : NAN;
+  });
+  set_type returned = s21::Decimate(set, kColumns);
+  EXPECT_LE(returned.first.size(), 12 * kColumns);
+  EXPECT_GT(Nans(returned), 0u);
+  EXPECT_FALSE(std::isnan(returned.second.front()));
+}
+
+TEST(DecimationTest, case_status) {
+  set_type set = Sample(10000, [](std::size_t i) { return i * 1.0; });
+  std::vector<unsigned char> status(set.first.size(), 0);
+  for (std::size_t i = 4001; i < 6000; ++i) status[i] = 4;
+  set_type returned = s21::Decimate(set, status, 100);
+  EXPECT_EQ(Nans(returned), 1u);
+  auto gap = std::find_if(returned.second.begin(), returned.second.end(),
+                          [](double y) { return std::isnan(y); });
+  EXPECT_EQ(*(gap - 1), 4000);
+  EXPECT_EQ(*(gap + 1), 6000);
+  set_type small = Sample(10, [](std::size_t i) { return i * 1.0; });
+  returned = s21::Decimate(small, std::vector<unsigned char>(10, 1), 100);
+  EXPECT_EQ(Nans(returned), 10u);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,298 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+
+#include "../src/controller/controller.h"
+#include "../src/model/compiler.h"
+#include "../src/model/defaultmodel.h"
+#include "../src/model/definitions.h"
+#include "../src/model/evaluator.h"
+#include "../src/model/tokenizer.h"
+
+class DefinitionsTest : public ::testing::Test {
+ protected:
+  void Define(const std::string& name, const std::string& parameter,
+              const std::string& body) {
+    s21::ShuntingYardCompiler body_compiler;
+    body_compiler.UseDefinitions(definitions);
+    body_compiler.SetParameter(parameter);
+    s21::Program program = body_compiler.Compile(body);
+    ASSERT_TRUE(program.Valid()) << body;
+    auto next = std::make_shared<s21::Definitions>(*definitions);
+    next->DefineFunction(name, std::move(program));
+    definitions = next;
+    compiler.UseDefinitions(definitions);
+  }
+
+  double Calculate(const std::string& expression, double x) {
+    s21::Program program = compiler.Compile(expression);
+    EXPECT_TRUE(program.Valid()) << expression;
+    return evaluator.Calculate(program.View(), x);
+  }
+
+  std::shared_ptr<const s21::Definitions> definitions =
+      std::make_shared<s21::Definitions>();
+  s21::ShuntingYardCompiler compiler;
+  s21::Evaluator<double> evaluator;
+};
+
+TEST_F(DefinitionsTest, case_inlined) {
+  Define("f", "t", "t^2+sin(t)");
+  s21::Program inlined = compiler.Compile("2*f(x)");
+  s21::ShuntingYardCompiler plain;
+  s21::Program expanded = plain.Compile("2*(x^2+sin(x))");
+  ASSERT_EQ(inlined.Code().size(), expanded.Code().size());
+  for (std::size_t i = 0; i < inlined.Code().size(); ++i) {
+    EXPECT_EQ(inlined.Code()[i].op, expanded.Code()[i].op);
+    EXPECT_EQ(inlined.Code()[i].value, expanded.Code()[i].value);
+  }
+  EXPECT_EQ(inlined.MaxDepth(), expanded.MaxDepth());
+  EXPECT_DOUBLE_EQ(Calculate("2*f(x+1)", 1), 2 * (4 + std::sin(2)));
+}
+
+TEST_F(DefinitionsTest, case_argument_once) {
+  Define("f", "t", "t*t+sin(t)");
+  std::string expression = "x";
+  double expected = 0.5;
+  for (int i = 0; i < 12; ++i) {
+    expression = "f(" + expression + ")";
+    expected = expected * expected + std::sin(expected);
+  }
+  s21::Program program = compiler.Compile(expression);
+  ASSERT_TRUE(program.Valid());
+  EXPECT_LE(program.Code().size(), 12u * 8);
+  EXPECT_DOUBLE_EQ(evaluator.Calculate(program.View(), 0.5), expected);
+  double x[3] = {0.5, 0.5, 0.5}, y[3];
+  evaluator.Calculate(program.View(), x, y, 3);
+  EXPECT_DOUBLE_EQ(y[2], expected);
+  std::size_t arguments = 0;
+  for (const s21::Instruction& instruction : program.Code())
+    arguments += instruction.op == s21::Opcode::kArg;
+  EXPECT_EQ(arguments, 3u);
+
+  Define("g", "u", "f(u)+f(u+1)*u");
+  double u = 0.25;
+  EXPECT_DOUBLE_EQ(Calculate("g(g(x))", u),
+                   [](double v) {
+                     auto f = [](double t) { return t * t + std::sin(t); };
+                     double g = f(v) + f(v + 1) * v;
+                     return f(g) + f(g + 1) * g;
+                   }(u));
+}
+
+TEST_F(DefinitionsTest, case_nested) {
+  Define("sq", "x", "x*x");
+  Define("g", "u", "sq(u)+sq(u+1)");
+  EXPECT_DOUBLE_EQ(Calculate("g(x)", 2), 13);
+  EXPECT_DOUBLE_EQ(Calculate("g(sq(x))-1", 2), 40);
+  EXPECT_DOUBLE_EQ(Calculate("2g 1", 0), 10);
+  EXPECT_DOUBLE_EQ(Calculate("sin(g(0))", 0), std::sin(1));
+}
+
+TEST_F(DefinitionsTest, case_parameter) {
+  s21::ShuntingYardCompiler body;
+  body.SetParameter("t");
+  EXPECT_FALSE(body.Compile("t+x").Valid());
+  EXPECT_TRUE(body.Compile("tan(t)+t").Valid());
+  body.SetParameter("x");
+  EXPECT_THROW(body.Compile("t+x"), s21::BadExpression);
+}
+
+TEST_F(DefinitionsTest, case_inline_cap) {
+  std::string previous = "qa";
+  Define(previous, "x", "x*x+1");
+  for (char level = 'b'; level <= 'q'; ++level) {
+    std::string name = std::string("q") + level;
+    Define(name, "x", previous + "(x)+" + previous + "(x+1)");
+    previous = name;
+  }
+  s21::Program program =
+      compiler.Compile(previous + "(x)+" + previous + "(x)");
+  EXPECT_FALSE(program.Valid());
+  EXPECT_EQ(program.Status().code, s21::ErrorCode::kTooLong);
+}
+
+TEST_F(DefinitionsTest, case_recompile) {
+  Define("f", "x", "x+1");
+  EXPECT_DOUBLE_EQ(
+      evaluator.Calculate(compiler.Recompile("f(x)*2").View(), 1), 4);
+  EXPECT_DOUBLE_EQ(
+      evaluator.Calculate(compiler.Recompile("f(x)*f(2)").View(), 1), 6);
+}
+
+TEST(DefinitionsModelTest, case_constant) {
+  s21::DefaultModel model;
+  model.Define("k", "", "9.81");
+  model.Define("half", "", "k/2");
+  model.setExpression("k*x+half");
+  EXPECT_DOUBLE_EQ(model.Calculate(2), 9.81 * 2.5);
+  EXPECT_THROW(model.Define("c", "", "x+1"), s21::BadExpression);
+  EXPECT_THROW(model.Define("c", "", "1+"), s21::BadExpression);
+  EXPECT_THROW(model.Define("sin", "", "1"), s21::BadExpression);
+  EXPECT_THROW(model.Define("y", "", "1"), s21::BadExpression);
+  EXPECT_THROW(model.Define("f", "sin", "1"), s21::BadExpression);
+  EXPECT_THROW(model.Define("f", "t", "x"), s21::BadExpression);
+}
+
+TEST(DefinitionsModelTest, case_redefine) {
+  s21::DefaultModel model;
+  model.Define("f", "t", "t^2+sin(t)");
+  model.setExpression("f(x)");
+  EXPECT_DOUBLE_EQ(model.Calculate(1), 1 + std::sin(1));
+  model.Define("g", "x", "f(x)+1");
+  model.Define("f", "t", "t");
+  model.setExpression("f(x)");
+  EXPECT_DOUBLE_EQ(model.Calculate(2), 2);
+  model.setExpression("g(x)");
+  EXPECT_DOUBLE_EQ(model.Calculate(0), 1);
+}
+
+TEST(DefinitionsModelTest, case_current_expression) {
+  s21::DefaultModel model;
+  model.Define("a", "", "2");
+  model.setExpression("a*x");
+  EXPECT_EQ(model.Calculate(3), 6);
+  model.Define("a", "", "5");
+  EXPECT_EQ(model.Calculate(3), 15);
+  EXPECT_EQ(model.Plot(3, 3, -100, 100).second[0], 15);
+  model.Define("a", "t", "t+1");
+  EXPECT_THROW(model.Calculate(3), s21::BadExpression);
+  model.Define("a", "", "7");
+  EXPECT_EQ(model.Calculate(3), 21);
+  EXPECT_THROW(model.Define("a", "", "1+"), s21::BadExpression);
+  EXPECT_EQ(model.Calculate(3), 21);
+}
+
+TEST(DefinitionsModelTest, case_size_limit) {
+  s21::DefaultModel model(16);
+  std::string body = "t";
+  for (int i = 1; i < 8; ++i) body += "+t";
+  model.Define("f", "t", body);
+  model.Define("g", "t", "f(f(t))");
+  model.setExpression("g(x)+f(x)");
+  EXPECT_DOUBLE_EQ(model.Calculate(1), 72);
+  EXPECT_THROW(model.Define("h", "t", body + "+t+t"), s21::BadExpression);
+}
+
+TEST(DefinitionsModelTest, case_plots) {
+  s21::DefaultModel model;
+  model.Define("a", "", "2");
+  auto implicit = model.PlotImplicit("(y-a*x)", -1, 1, -1, 1);
+  ASSERT_FALSE(implicit.first.empty());
+  for (std::size_t i = 0; i < implicit.first.size(); i += 3)
+    EXPECT_NEAR(implicit.second[i], 2 * implicit.first[i], 1e-9);
+  model.Define("a", "", "-1");
+  implicit = model.PlotImplicit("(y-a*x)", -1, 1, -1, 1);
+  ASSERT_FALSE(implicit.first.empty());
+  for (std::size_t i = 0; i < implicit.first.size(); i += 3)
+    EXPECT_NEAR(implicit.second[i], -implicit.first[i], 1e-9);
+}
+
+TEST(DefinitionsModelTest, case_overlay) {
+  s21::DefaultModel model;
+  model.Define("f", "t", "t*t+sin(t)");
+  auto sets = model.PlotOverlay({"f(f(x+1))", "f(x+1)*2"}, -2, 2, -50, 50);
+  model.setExpression("f(f(x+1))");
+  auto first = model.Plot(-2, 2, -50, 50);
+  model.setExpression("f(x+1)*2");
+  auto second = model.Plot(-2, 2, -50, 50);
+  ASSERT_EQ(sets.size(), 2u);
+  auto same = [](double a, double b) {
+    return std::isnan(a) ? std::isnan(b) : std::abs(a - b) <= 1e-12;
+  };
+  for (std::size_t i = 0; i < first.first.size(); ++i) {
+    EXPECT_TRUE(same(sets[0].second[i], first.second[i]));
+    EXPECT_TRUE(same(sets[1].second[i], second.second[i]));
+  }
+}
+
+TEST(DefinitionsModelTest, case_parse_definition) {
+  std::string name, parameter, body;
+  ASSERT_TRUE(s21::CalcModelController::ParseDefinition(
+      "f(t) = t^2 + sin(t)", name, parameter, body));
+  EXPECT_EQ(name, "f");
+  EXPECT_EQ(parameter, "t");
+  EXPECT_EQ(body, "t^2 + sin(t)");
+  ASSERT_TRUE(s21::CalcModelController::ParseDefinition(" k = 9.81", name,
+                                                        parameter, body));
+  EXPECT_EQ(name, "k");
+  EXPECT_TRUE(parameter.empty());
+  EXPECT_EQ(body, "9.81");
+  EXPECT_FALSE(s21::CalcModelController::ParseDefinition("sin(x) = y", name,
+                                                         parameter, body));
+  EXPECT_FALSE(s21::CalcModelController::ParseDefinition("r = 2", name,
+                                                         parameter, body));
+  EXPECT_FALSE(s21::CalcModelController::ParseDefinition("x^2 = y", name,
+                                                         parameter, body));
+  EXPECT_FALSE(s21::CalcModelController::ParseDefinition("f(t) = t, 0, 1",
+                                                         name, parameter,
+                                                         body));
+  EXPECT_FALSE(s21::CalcModelController::ParseDefinition("f(2) = 1", name,
+                                                         parameter, body));
+  EXPECT_FALSE(s21::CalcModelController::ParseDefinition("k + 1", name,
+                                                         parameter, body));
+}
+
+class PreviewView final : public s21::ICalculatorView {
+ public:
+  void SubscribeExprEval(const ExprEvalDelegate& delegate) override {
+    eval = delegate;
+  }
+  void SubscribePlotEval(const PlotEvalDelegate&) override {}
+  void SubscribeCurveEval(const CurveEvalDelegate& delegate) override {
+    curve = delegate;
+  }
+  void SubscribeRangeEval(const RangeEvalDelegate&) override {}
+  void SendError(const std::string& msg) override { message = msg; }
+  std::string GetExpr() override { return input; }
+  bool Previewing() const override { return preview; }
+
+  ExprEvalDelegate eval;
+  CurveEvalDelegate curve;
+  std::string input;
+  std::string message;
+  bool preview = true;
+};
+
+TEST(DefinitionsModelTest, case_preview) {
+  s21::DefaultModel model;
+  PreviewView view;
+  s21::CalcModelController controller(&model, &view);
+  model.setExpression("x+1");
+  view.input = "a=1";
+  EXPECT_TRUE(std::isnan(view.eval(0)));
+  EXPECT_EQ(view.message.rfind("Error:", 0), 0u);
+  view.input = "f(t)=t*2";
+  s21::ICalculatorView::set_type curve;
+  EXPECT_TRUE(view.curve(-1, 1, -1, 1, curve));
+  EXPECT_TRUE(curve.first.empty());
+  EXPECT_EQ(model.Calculate(2), 3);
+  EXPECT_THROW(model.setExpression("a"), s21::BadExpression);
+
+  view.preview = false;
+  view.input = "a=12";
+  EXPECT_EQ(view.eval(0), 12);
+  view.input = "f(t)=t*2";
+  EXPECT_TRUE(view.curve(-1, 1, -1, 1, curve));
+  model.setExpression("f(a)");
+  EXPECT_EQ(model.Calculate(), 24);
+}
+
+TEST(DefinitionsModelTest, case_is_name) {
+  EXPECT_TRUE(s21::Tokenizer::IsName("f"));
+  EXPECT_TRUE(s21::Tokenizer::IsName("speed"));
+  EXPECT_FALSE(s21::Tokenizer::IsName(""));
+  EXPECT_FALSE(s21::Tokenizer::IsName("max"));
+  EXPECT_FALSE(s21::Tokenizer::IsName("sine"));
+  EXPECT_FALSE(s21::Tokenizer::IsName("modulus"));
+  EXPECT_FALSE(s21::Tokenizer::IsName("f1"));
+  EXPECT_FALSE(s21::Tokenizer::IsName("y"));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
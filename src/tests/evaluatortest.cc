@@ -0,0 +1,128 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "../src/model/compiler.h"
+#include "../src/model/evaluator.h"
+
+constexpr const char* kExpressions[] = {"1+2*3-4/5",
+                                        "-x^2+x mod 3",
+                                        "sin(x)^2+cos(x)^2",
+                                        "sqrt(x*x+1)",
+                                        "ln(x)*log(x)",
+                                        "tan(x)-cot(x)",
+                                        "exp(-x)/(1+x)",
+                                        "asin(x/9)+acos(x/9)",
+                                        "atan(x)+acot(x)",
+                                        "-(-(-x))"};
+
+template <class T>
+class EvaluatorTest : public ::testing::Test {
+ protected:
+  std::vector<T> Arguments(std::size_t n) const {
+    std::vector<T> x(n);
+    for (std::size_t i = 0; i < n; ++i) x[i] = static_cast<T>(i * 0.37 - 7);
+    return x;
+  }
+
+  s21::ShuntingYardCompiler compiler;
+  s21::Evaluator<T> evaluator;
+};
+
+using ScalarTypes = ::testing::Types<float, double, long double>;
+TYPED_TEST_SUITE(EvaluatorTest, ScalarTypes);
+
+TYPED_TEST(EvaluatorTest, case_batch_matches_scalar) {
+  std::size_t n = 3 * s21::Evaluator<TypeParam>::kLanes + 5;
+  std::vector<TypeParam> x = this->Arguments(n), y(n);
+  for (const char* expression : kExpressions) {
+    s21::Program program = this->compiler.Compile(expression);
+    this->evaluator.Calculate(program.View(), x.data(), y.data(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+      TypeParam expected = this->evaluator.Calculate(program.View(), x[i]);
+      if (std::isnan(expected))
+        EXPECT_TRUE(std::isnan(y[i])) << expression;
+      else
+        EXPECT_EQ(expected, y[i]) << expression << " x=" << x[i];
+    }
+  }
+}
+
+TYPED_TEST(EvaluatorTest, case_close_to_double) {
+  s21::Evaluator<double> reference;
+  for (const char* expression : kExpressions) {
+    s21::Program program = this->compiler.Compile(expression);
+    for (double x : {-2.5, 0.5, 1.75, 4.0}) {
+      double expected = reference.Calculate(program.View(), x);
+      double returned = static_cast<double>(this->evaluator.Calculate(
+          program.View(), static_cast<TypeParam>(x)));
+      if (std::isnan(expected))
+        EXPECT_TRUE(std::isnan(returned)) << expression;
+      else
+        EXPECT_NEAR(expected, returned, 1e-5 * (1 + std::fabs(expected)))
+            << expression << " x=" << x;
+    }
+  }
+}
+
+TYPED_TEST(EvaluatorTest, case_two_variables) {
+  this->compiler.AllowY(true);
+  s21::Program program = this->compiler.Compile("x^2-y*3+y mod x");
+  std::size_t n = s21::Evaluator<TypeParam>::kLanes + 3;
+  std::vector<TypeParam> x = this->Arguments(n), y(n), f(n);
+  for (std::size_t i = 0; i < n; ++i) y[i] = x[n - 1 - i];
+  this->evaluator.Calculate(program.View(), x.data(), y.data(), f.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    TypeParam expected = this->evaluator.Calculate(program.View(), x[i], y[i]);
+    if (std::isnan(expected))
+      EXPECT_TRUE(std::isnan(f[i])) << i;
+    else
+      EXPECT_EQ(expected, f[i]) << i;
+  }
+  EXPECT_EQ(this->evaluator.Calculate(program.View(), 2, 0), 4);
+  this->evaluator.Calculate(program.View(), x.data(), f.data(), n);
+  EXPECT_EQ(f[0], this->evaluator.Calculate(program.View(), x[0]));
+}
+
+TYPED_TEST(EvaluatorTest, case_status) {
+  s21::Program program = this->compiler.Compile("sqrt(x)+1/(x-1)+x^3");
+  std::size_t n = 2 * s21::Evaluator<TypeParam>::kLanes + 7;
+  std::vector<TypeParam> x = this->Arguments(n), y(n), expected(n);
+  x[n - 1] = 1;
+  std::vector<unsigned char> status(n, 0xff);
+  this->evaluator.Calculate(program.View(), x.data(), y.data(), status.data(),
+                            TypeParam(-2), TypeParam(50), n);
+  this->evaluator.Calculate(program.View(), x.data(), expected.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    TypeParam value = expected[i];
+    if (std::isnan(value)) {
+      EXPECT_TRUE(std::isnan(y[i]));
+      EXPECT_EQ(status[i], s21::kLaneDomain) << x[i];
+    } else if (std::isinf(value)) {
+      EXPECT_EQ(status[i], s21::kLaneOverflow | s21::kLaneOutOfRange);
+    } else {
+      EXPECT_EQ(y[i], value);
+      EXPECT_EQ(status[i], value < -2 || value > 50 ? s21::kLaneOutOfRange : 0)
+          << x[i];
+    }
+  }
+  EXPECT_EQ(status[n - 1], s21::kLaneOverflow | s21::kLaneOutOfRange);
+  EXPECT_EQ(status[0], s21::kLaneDomain);
+}
+
+TEST(EvaluatorPrecisionTest, case_long_double) {
+  if (std::numeric_limits<long double>::digits < 64) GTEST_SKIP();
+  s21::ShuntingYardCompiler compiler;
+  s21::Program program = compiler.Compile("(x+1)^2-x^2-2x");
+  long double x = 1e9L;
+  EXPECT_EQ(s21::Evaluator<long double>().Calculate(program.View(), x), 1);
+  EXPECT_NE(s21::Evaluator<float>().Calculate(program.View(), 1e9f), 1);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
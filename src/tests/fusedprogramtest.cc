@@ -0,0 +1,82 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../src/model/calculator.h"
+#include "../src/model/compiler.h"
+#include "../src/model/fusedprogram.h"
+
+class FusedProgramTest : public ::testing::Test {
+ protected:
+  void Fuse(const std::vector<std::string>& expressions) {
+    programs.clear();
+    std::vector<s21::ProgramView> views;
+    for (const std::string& expression : expressions)
+      programs.push_back(compiler.Compile(expression));
+    for (const s21::Program& program : programs)
+      views.push_back(program.View());
+    fused.Fuse(views);
+  }
+
+  void ExpectSame(std::size_t n) {
+    std::vector<double> x(n);
+    for (std::size_t i = 0; i < n; ++i) x[i] = i * 0.173 - 9;
+    std::vector<std::vector<double>> y(programs.size(),
+                                       std::vector<double>(n));
+    std::vector<double*> outputs;
+    for (auto& values : y) outputs.push_back(values.data());
+    fused.Calculate(x.data(), n, outputs.data());
+    for (std::size_t j = 0; j < programs.size(); ++j) {
+      for (std::size_t i = 0; i < n; ++i) {
+        double expected = calc.Calculate(programs[j], x[i]);
+        if (std::isnan(expected))
+          EXPECT_TRUE(std::isnan(y[j][i])) << j << " x=" << x[i];
+        else
+          EXPECT_EQ(expected, y[j][i]) << j << " x=" << x[i];
+      }
+    }
+  }
+
+  s21::ShuntingYardCompiler compiler;
+  s21::RPNCalculator calc;
+  std::vector<s21::Program> programs;
+  s21::FusedProgram fused;
+};
+
+TEST_F(FusedProgramTest, case_same_as_separate) {
+  Fuse({"sin(x)^2+cos(x)^2", "sin(x)*cos(x)", "sqrt(x*x+1)-x", "ln(x)/x",
+        "-x mod 3", "2^-x+tan(x/2)", "acos(x/9)*asin(x/9)"});
+  EXPECT_EQ(fused.Outputs(), 7u);
+  ExpectSame(3 * s21::FusedProgram::kLanes + 7);
+  ExpectSame(1);
+}
+
+TEST_F(FusedProgramTest, case_common_subexpressions) {
+  Fuse({"sin(x)^2+1", "sin(x)^2-1", "1+sin(x)^2"});
+  EXPECT_EQ(fused.Operations(), 7u);
+  EXPECT_LE(fused.Slots(), 3u);
+  ExpectSame(100);
+}
+
+TEST_F(FusedProgramTest, case_repeated) {
+  Fuse({"x*x+x*x", "+x", "x", "(x*x+x*x)"});
+  EXPECT_EQ(fused.Operations(), 3u);
+  ExpectSame(50);
+}
+
+TEST_F(FusedProgramTest, case_refuse) {
+  Fuse({"x+1"});
+  ExpectSame(10);
+  Fuse({"exp(x)", "exp(x)/2", "exp(x)/3", "exp(x)/2+exp(x)/3"});
+  EXPECT_EQ(fused.Outputs(), 4u);
+  EXPECT_EQ(fused.Operations(), 7u);
+  ExpectSame(40);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
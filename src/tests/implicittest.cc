@@ -0,0 +1,107 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+
+#include "../src/controller/controller.h"
+#include "../src/model/compiler.h"
+#include "../src/model/defaultmodel.h"
+#include "../src/model/implicit.h"
+
+class ImplicitTest : public ::testing::Test {
+ protected:
+  s21::ImplicitPlotter::set_type Plot(const std::string& expression,
+                                      double left, double right, double bottom,
+                                      double top) {
+    compiler.AllowY(true);
+    s21::Program program = compiler.Compile(expression);
+    EXPECT_TRUE(program.Valid()) << expression;
+    return plotter.Plot(program.View(), left, right, bottom, top);
+  }
+
+  static constexpr std::size_t kCells =
+      s21::ImplicitPlotter::kCoarseCells << s21::ImplicitPlotter::kRefinements;
+
+  s21::ShuntingYardCompiler compiler;
+  s21::ImplicitPlotter plotter;
+};
+
+TEST_F(ImplicitTest, case_circle) {
+  auto segments = Plot("x^2+y^2-4", -3, 3, -3, 3);
+  ASSERT_FALSE(segments.first.empty());
+  ASSERT_EQ(segments.first.size() % 3, 0u);
+  double cell = 6.0 / kCells;
+  int quadrants[4] = {};
+  for (std::size_t i = 0; i < segments.first.size(); i += 3) {
+    for (std::size_t j = i; j < i + 2; ++j) {
+      double x = segments.first[j], y = segments.second[j];
+      EXPECT_NEAR(std::hypot(x, y), 2, cell * cell) << x << " " << y;
+      ++quadrants[(x < 0) + 2 * (y < 0)];
+    }
+    EXPECT_TRUE(std::isnan(segments.first[i + 2]));
+    EXPECT_TRUE(std::isnan(segments.second[i + 2]));
+  }
+  for (int count : quadrants) EXPECT_GT(count, 0);
+  EXPECT_LT(plotter.Evaluations(), (kCells + 1) * (kCells + 1) / 20);
+}
+
+TEST_F(ImplicitTest, case_no_curve) {
+  auto segments = Plot("x^2+y^2+1", -3, 3, -3, 3);
+  EXPECT_TRUE(segments.first.empty());
+  std::size_t tiles = s21::ImplicitPlotter::kCoarseCells /
+                      s21::ImplicitPlotter::kTileCells;
+  std::size_t corners = s21::ImplicitPlotter::kTileCells + 1;
+  EXPECT_EQ(plotter.Evaluations(), tiles * tiles * corners * corners);
+}
+
+TEST_F(ImplicitTest, case_threads) {
+  s21::ImplicitPlotter single(1);
+  EXPECT_EQ(single.Threads(), 1u);
+  compiler.AllowY(true);
+  s21::Program program = compiler.Compile("sin(x*y)-0.3");
+  auto expected = single.Plot(program.View(), -4, 4, -4, 4);
+  auto segments = plotter.Plot(program.View(), -4, 4, -4, 4);
+  ASSERT_EQ(segments.first.size(), expected.first.size());
+  for (std::size_t i = 0; i < segments.first.size(); i += 3) {
+    EXPECT_EQ(segments.first[i], expected.first[i]);
+    EXPECT_EQ(segments.second[i + 1], expected.second[i + 1]);
+  }
+  EXPECT_EQ(single.Evaluations(), plotter.Evaluations());
+}
+
+TEST_F(ImplicitTest, case_domain) {
+  auto segments = Plot("sqrt(x)-y", -1, 1, -1, 1);
+  ASSERT_FALSE(segments.first.empty());
+  for (std::size_t i = 0; i < segments.first.size(); i += 3)
+    EXPECT_NEAR(segments.second[i], std::sqrt(segments.first[i]), 0.05);
+}
+
+TEST(ImplicitModelTest, case_plot_implicit) {
+  s21::DefaultModel model;
+  model.setExpression("x+1");
+  auto segments = model.PlotImplicit("(y-x)", -1, 1, -1, 1);
+  ASSERT_FALSE(segments.first.empty());
+  for (std::size_t i = 0; i < segments.first.size(); i += 3)
+    EXPECT_NEAR(segments.first[i], segments.second[i], 1e-9);
+  EXPECT_EQ(model.Calculate(1), 2);
+  model.setExpression("y+1");
+  EXPECT_THROW(model.Calculate(1), s21::BadExpression);
+  EXPECT_THROW(model.PlotImplicit("y+", -1, 1, -1, 1), s21::BadExpression);
+  EXPECT_THROW(model.PlotImplicit("y-x", 1, -1, -1, 1), s21::BadExpression);
+  EXPECT_THROW(model.PlotImplicit("y-x", -1, 1, 1, 1), s21::BadExpression);
+}
+
+TEST(ImplicitModelTest, case_parse_implicit) {
+  std::string expression;
+  EXPECT_FALSE(s21::CalcModelController::ParseImplicit("x+y", expression));
+  ASSERT_TRUE(s21::CalcModelController::ParseImplicit("x^2 = y", expression));
+  EXPECT_EQ(expression, "(x^2 )-( y)");
+  EXPECT_THROW(s21::CalcModelController::ParseImplicit("x=y=1", expression),
+               s21::BadExpression);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,6 +1,9 @@
 // Copyright 2023 School21 @gruntmet Snezhana Valeeva
 #include <gtest/gtest.h>
 
+#include <limits>
+#include <new>
+
 #include "../src/model/defaultmodel.h"
 
 typedef s21::DefaultModel TestingModel;
@@ -85,6 +88,12 @@ TEST_F(ModelIntegrationTest, case_trivial_12) {
   EXPECT_NEAR(subject->Calculate(2), expected, eps);
 }
 
+TEST_F(ModelIntegrationTest, case_trivial_mod) {
+  subject->setExpression("2.25 mod 0.5 + 7mod-4");
+  constexpr double expected = 3.25;
+  EXPECT_NEAR(subject->Calculate(), expected, eps);
+}
+
 TEST_F(ModelIntegrationTest, case_trivial_13) {
   subject->setExpression("3e8");
   constexpr double expected = 3e8;
@@ -261,6 +270,221 @@ TEST_F(ModelIntegrationTest, case_long) {
   EXPECT_THROW(subject->setExpression(longd), s21::BadExpression);
 }
 
+TEST_F(ModelIntegrationTest, case_max_size) {
+  s21::DefaultModel model(s21::DefaultModel::kNoSizeLimit);
+  std::string longd = "7";
+  for (int i = 0; i < 50000; longd += "+2", i++) {
+  };
+  model.setExpression(longd);
+  EXPECT_NEAR(model.Calculate(), 100007, eps);
+  model.SetMaxSize(10);
+  EXPECT_EQ(model.MaxSize(), 10u);
+  EXPECT_THROW(model.setExpression("1+2+3+4+5+6"), s21::BadExpression);
+}
+
+TEST_F(ModelIntegrationTest, case_plot_single) {
+  s21::DefaultModel model;
+  model.setExpression("sin(x)*x");
+  auto expected = model.Plot(-10, 10, -5, 5);
+  model.SetPlotPrecision(s21::DefaultModel::Precision::kSingle);
+  auto returned = model.Plot(-10, 10, -5, 5);
+  ASSERT_EQ(expected.second.size(), returned.second.size());
+  for (std::size_t i = 0; i < expected.second.size(); ++i) {
+    double l = expected.second[i], r = returned.second[i];
+    if (std::isnan(l) != std::isnan(r)) {
+      EXPECT_NEAR(std::fabs(std::isnan(l) ? r : l), 5, 1e-4);
+    } else if (!std::isnan(l)) {
+      EXPECT_NEAR(l, r, 1e-5);
+    }
+  }
+  model.setExpression("x-1e9");
+  subject->setExpression("x-1e9");
+  EXPECT_EQ(model.Plot(1e9, 1e9 + 1, -1, 2),
+            subject->Plot(1e9, 1e9 + 1, -1, 2));
+  model.setExpression("x+1e6");
+  subject->setExpression("x+1e6");
+  EXPECT_EQ(model.Plot(-1, 1, 1e6 - 1, 1e6 + 1),
+            subject->Plot(-1, 1, 1e6 - 1, 1e6 + 1));
+  model.setExpression("x*1e300");
+  subject->setExpression("x*1e300");
+  EXPECT_EQ(model.Plot(-1, 1, -1e300, 1e300),
+            subject->Plot(-1, 1, -1e300, 1e300));
+  for (const char* expression : {"x*1e50/1e50", "1e-46*x*1e46"}) {
+    model.setExpression(expression);
+    subject->setExpression(expression);
+    auto single = model.Plot(-10, 10, -20, 20);
+    EXPECT_EQ(single, subject->Plot(-10, 10, -20, 20)) << expression;
+    EXPECT_FALSE(std::isnan(single.second[single.second.size() / 2]));
+  }
+}
+
+TEST_F(ModelIntegrationTest, case_plot_status) {
+  s21::DefaultModel model;
+  model.setExpression("ln(x)+1/(x-2)");
+  auto set = model.Plot(-4, 4, -3, 3);
+  ASSERT_EQ(model.PlotStatus().size(), 1u);
+  const std::vector<unsigned char>& status = model.PlotStatus()[0];
+  ASSERT_EQ(status.size(), set.first.size());
+  bool domain = false, clipped = false;
+  for (std::size_t i = 0; i < status.size(); ++i) {
+    double x = set.first[i];
+    EXPECT_EQ(std::isnan(set.second[i]), status[i] != 0) << x;
+    if (x < 0) {
+      EXPECT_EQ(status[i], s21::kLaneDomain) << x;
+    }
+    domain |= status[i] == s21::kLaneDomain;
+    clipped |= status[i] == s21::kLaneOutOfRange;
+  }
+  EXPECT_TRUE(domain);
+  EXPECT_TRUE(clipped);
+  model.SetPlotPrecision(s21::DefaultModel::Precision::kSingle);
+  auto single = model.Plot(-4, 4, -3, 3);
+  ASSERT_EQ(model.PlotStatus().size(), 1u);
+  EXPECT_EQ(model.PlotStatus()[0].size(), single.first.size());
+  EXPECT_EQ(model.PlotStatus()[0][0], s21::kLaneDomain);
+
+  auto sets = model.PlotOverlay({"ln(x)", "1/x", "x"}, -4, 4, -3, 3);
+  ASSERT_EQ(model.PlotStatus().size(), sets.size());
+  for (std::size_t i = 0; i < sets.size(); ++i) {
+    ASSERT_EQ(model.PlotStatus()[i].size(), sets[i].first.size());
+    for (std::size_t j = 0; j < sets[i].first.size(); ++j) {
+      EXPECT_EQ(std::isnan(sets[i].second[j]), model.PlotStatus()[i][j] != 0);
+    }
+  }
+  EXPECT_EQ(model.PlotStatus()[0][0], s21::kLaneDomain);
+  EXPECT_EQ(model.PlotStatus()[1][0], 0);
+  EXPECT_EQ(model.PlotStatus()[2][0], s21::kLaneOutOfRange);
+}
+
+TEST_F(ModelIntegrationTest, case_plot_approximation) {
+  s21::DefaultModel model;
+  model.setExpression("1/(x-1)+sin(x)^2");
+  subject->setExpression("1/(x-1)+sin(x)^2");
+  model.SetApproximation(1e-10);
+  for (double shift : {0.0, 3.0, -7.0}) {
+    auto expected = subject->Plot(-10 + shift, 10 + shift, -50, 50);
+    auto returned = model.Plot(-10 + shift, 10 + shift, -50, 50);
+    ASSERT_EQ(expected.second.size(), returned.second.size());
+    for (std::size_t i = 0; i < expected.second.size(); ++i) {
+      double l = expected.second[i], r = returned.second[i];
+      if (std::isnan(l) != std::isnan(r)) {
+        EXPECT_NEAR(std::fabs(std::isnan(l) ? r : l), 50, 1e-6);
+      } else if (!std::isnan(l)) {
+        EXPECT_NEAR(l, r, 1e-10 * std::max(1.0, std::fabs(l)));
+      }
+    }
+  }
+  EXPECT_NEAR(model.Calculate(2.5), subject->Calculate(2.5), 1e-10);
+  EXPECT_TRUE(std::isinf(model.Calculate(1)));
+  model.setExpression("x^2");
+  EXPECT_EQ(model.Calculate(3), 9);
+}
+
+TEST_F(ModelIntegrationTest, case_plot_overlay) {
+  s21::DefaultModel model;
+  model.setExpression("x+1");
+  std::vector<std::string> expressions = {"sin(x)", "sin(x)^2", "x/0"};
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    auto sets = model.PlotOverlay(expressions, -3, 3, -2, 2);
+    ASSERT_EQ(sets.size(), expressions.size());
+    for (std::size_t j = 0; j < sets.size(); ++j) {
+      subject->setExpression(expressions[j]);
+      auto expected = subject->Plot(-3, 3, -2, 2);
+      EXPECT_EQ(sets[j].first, expected.first);
+      for (std::size_t i = 0; i < expected.second.size(); ++i) {
+        if (std::isnan(expected.second[i])) {
+          EXPECT_TRUE(std::isnan(sets[j].second[i]));
+        } else {
+          EXPECT_EQ(sets[j].second[i], expected.second[i]);
+        }
+      }
+    }
+  }
+  EXPECT_EQ(model.Calculate(2), 3);
+  EXPECT_THROW(model.PlotOverlay({"x", "x+"}, -3, 3, -2, 2),
+               s21::BadExpression);
+  EXPECT_EQ(subject->PlotOverlay({"x", "2x"}, -1, 1, -5, 5).size(), 2u);
+}
+
+TEST_F(ModelIntegrationTest, case_plot_overlay_fixes) {
+  s21::DefaultModel model;
+  model.EditExpression("2sin(x");
+  EXPECT_TRUE(model.ExressionChanged());
+  model.PlotOverlay({"x", "x+1"}, -1, 1, -5, 5);
+  EXPECT_FALSE(model.ExressionChanged());
+  model.PlotOverlay({"2x", "sin(x"}, -1, 1, -5, 5);
+  EXPECT_TRUE(model.ExressionChanged());
+  model.EditExpression("x+1");
+  EXPECT_FALSE(model.ExressionChanged());
+  model.PlotOverlay({"2x", "sin(x"}, -1, 1, -5, 5);
+  EXPECT_TRUE(model.ExressionChanged());
+  model.Plot(-1, 1, -5, 5);
+  EXPECT_FALSE(model.ExressionChanged());
+  model.EditExpression("x+12");
+  model.PlotOverlay({"x", "x*x"}, -1, 1, -5, 5);
+  model.EditExpression("x+123");
+  EXPECT_EQ(model.Calculate(1), 124);
+}
+
+TEST_F(ModelIntegrationTest, case_try_set_expression) {
+  s21::DefaultModel model;
+  EXPECT_TRUE(model.TrySetExpression("x^2"));
+  s21::ParseResult result = model.TrySetExpression("x^2+");
+  EXPECT_EQ(result.error.code, s21::ErrorCode::kNotFinished);
+  EXPECT_EQ(model.TrySetExpression("").error.code, s21::ErrorCode::kEmpty);
+  result = model.TrySetExpression(std::string(300, '1'));
+  EXPECT_EQ(result.error.code, s21::ErrorCode::kTooLong);
+  EXPECT_EQ(result.error.length, 45u);
+  EXPECT_NEAR(model.Calculate(3), 9, eps);
+}
+
+#ifdef S21_MODEL_STATS
+TEST_F(ModelIntegrationTest, case_stats) {
+  subject->ResetStats();
+  subject->setExpression("sin(x)*2");
+  subject->Calculate(1);
+  subject->Calculate(2);
+  subject->Plot(-1, 1, -10, 10);
+  s21::PipelineStats stats = subject->Stats();
+  const auto& compile = stats[static_cast<int>(s21::Stage::kCompile)];
+  const auto& calculate = stats[static_cast<int>(s21::Stage::kCalculate)];
+  const auto& plot = stats[static_cast<int>(s21::Stage::kPlot)];
+  EXPECT_EQ(compile.calls, 1u);
+  EXPECT_GT(compile.allocations, 0u);
+  EXPECT_EQ(calculate.calls, 3u);
+  EXPECT_EQ(calculate.points, 2u + TestingModel::kRangeFinesse);
+  EXPECT_EQ(plot.calls, 1u);
+  EXPECT_EQ(plot.points, TestingModel::kRangeFinesse);
+  std::uint64_t histogram_calls = 0;
+  for (auto bucket : calculate.latency_histogram) histogram_calls += bucket;
+  EXPECT_EQ(histogram_calls, calculate.calls);
+  subject->ResetStats();
+  EXPECT_EQ(subject->Stats()[static_cast<int>(s21::Stage::kPlot)].calls, 0u);
+}
+
+TEST_F(ModelIntegrationTest, case_construction) {
+  std::uint64_t before = s21::ThreadAllocations();
+  {
+    s21::DefaultModel model;
+    s21::RPNCalculator calc;
+  }
+  EXPECT_EQ(s21::ThreadAllocations() - before, 0u);
+}
+
+int new_handler_calls = 0;
+
+TEST_F(ModelIntegrationTest, case_new_handler) {
+  new_handler_calls = 0;
+  std::set_new_handler([] {
+    if (++new_handler_calls == 2) std::set_new_handler(nullptr);
+  });
+  volatile std::size_t size = std::numeric_limits<std::size_t>::max() / 2;
+  EXPECT_THROW(::operator delete(::operator new(size)), std::bad_alloc);
+  EXPECT_EQ(new_handler_calls, 2);
+  EXPECT_EQ(std::get_new_handler(), nullptr);
+}
+#endif
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,139 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../src/controller/controller.h"
+#include "../src/model/compiler.h"
+#include "../src/model/defaultmodel.h"
+#include "../src/model/rangescan.h"
+
+class RangeScanTest : public ::testing::Test {
+ protected:
+  s21::RangeStats Scan(const std::string& expression, double left,
+                       double right, std::size_t samples) {
+    program = compiler.Compile(expression);
+    EXPECT_TRUE(program.Valid()) << expression;
+    return scanner.Scan(program.View(), left, right, samples);
+  }
+
+  s21::ShuntingYardCompiler compiler;
+  s21::Program program;
+  s21::RangeScanner scanner;
+};
+
+TEST_F(RangeScanTest, case_parabola) {
+  s21::RangeStats stats = Scan("x^2-2", -3, 3, 1001);
+  EXPECT_EQ(stats.samples, 1001u);
+  EXPECT_EQ(stats.finite, 1001u);
+  EXPECT_NEAR(stats.min, -2, 1e-4);
+  EXPECT_NEAR(stats.argmin, 0, 0.01);
+  EXPECT_EQ(stats.max, 7);
+  EXPECT_EQ(stats.argmax, -3);
+  EXPECT_NEAR(stats.integral, 6, 1e-4);
+  EXPECT_NEAR(stats.mean, 1, 0.01);
+  ASSERT_EQ(stats.sign_changes.size(), 2u);
+  EXPECT_LE(stats.sign_changes[0].first, -std::sqrt(2));
+  EXPECT_GE(stats.sign_changes[0].second, -std::sqrt(2));
+  EXPECT_LE(stats.sign_changes[1].first, std::sqrt(2));
+  EXPECT_GE(stats.sign_changes[1].second, std::sqrt(2));
+  ASSERT_EQ(stats.extrema.size(), 1u);
+  EXPECT_FALSE(stats.extrema[0].maximum);
+  EXPECT_EQ(stats.extrema[0].x, stats.argmin);
+}
+
+TEST_F(RangeScanTest, case_chunks) {
+  std::size_t samples = 5 * s21::RangeScanner::kChunk + 3;
+  s21::RangeStats stats = Scan("sin(x*x/50)*x", -40, 40, samples);
+  s21::RangeScanner single(1);
+  s21::RangeStats expected = single.Scan(program.View(), -40, 40, samples);
+  EXPECT_EQ(stats.min, expected.min);
+  EXPECT_EQ(stats.argmax, expected.argmax);
+  EXPECT_DOUBLE_EQ(stats.integral, expected.integral);
+  ASSERT_EQ(stats.sign_changes.size(), expected.sign_changes.size());
+  ASSERT_EQ(stats.extrema.size(), expected.extrema.size());
+  for (std::size_t i = 0; i < stats.extrema.size(); ++i)
+    EXPECT_EQ(stats.extrema[i].x, expected.extrema[i].x);
+
+  double step = 80.0 / static_cast<double>(samples - 1);
+  s21::Evaluator<double> evaluator;
+  std::size_t changes = 0, extrema = 0;
+  double previous = NAN, before = NAN;
+  for (std::size_t i = 0; i < samples; ++i) {
+    double x = i + 1 == samples ? 40 : -40 + step * static_cast<double>(i);
+    double y = evaluator.Calculate(program.View(), x);
+    changes += y == 0 || (previous < 0 && y > 0) || (previous > 0 && y < 0);
+    extrema += (previous > before && previous > y) ||
+               (previous < before && previous < y);
+    before = previous;
+    previous = y;
+  }
+  EXPECT_EQ(stats.sign_changes.size(), changes);
+  EXPECT_EQ(stats.extrema.size(), extrema);
+}
+
+TEST_F(RangeScanTest, case_not_finite) {
+  s21::RangeStats stats = Scan("ln(x)", -1, 1, 200);
+  EXPECT_EQ(stats.finite, 100u);
+  EXPECT_EQ(stats.max, 0);
+  EXPECT_EQ(stats.argmax, 1);
+  EXPECT_EQ(stats.sign_changes.size(), 1u);
+  stats = Scan("1/x", -1, 1, 200);
+  ASSERT_EQ(stats.sign_changes.size(), 1u);
+  EXPECT_LT(stats.sign_changes[0].first, 0);
+  EXPECT_GT(stats.sign_changes[0].second, 0);
+  stats = Scan("sqrt(-1-x*x)", -1, 1, 10);
+  EXPECT_EQ(stats.finite, 0u);
+  EXPECT_TRUE(std::isnan(stats.min));
+  EXPECT_TRUE(std::isnan(stats.mean));
+  EXPECT_EQ(stats.integral, 0);
+}
+
+TEST_F(RangeScanTest, case_event_limit) {
+  s21::RangeStats stats = Scan("sin(x)", 0, 10000, 200000);
+  EXPECT_EQ(stats.sign_changes.size(), s21::RangeStats::kMaxEvents);
+  EXPECT_EQ(stats.extrema.size(), s21::RangeStats::kMaxEvents);
+  EXPECT_NEAR(stats.min, -1, 1e-6);
+  EXPECT_NEAR(stats.max, 1, 1e-6);
+}
+
+TEST(RangeStatsModelTest, case_analyze) {
+  s21::DefaultModel model;
+  model.setExpression("3");
+  s21::RangeStats stats = model.Analyze(0, 2, 3);
+  EXPECT_EQ(stats.mean, 3);
+  EXPECT_EQ(stats.integral, 6);
+  EXPECT_THROW(model.Analyze(2, 0, 3), s21::BadExpression);
+  EXPECT_THROW(model.Analyze(0, 2, 1), s21::BadExpression);
+  EXPECT_THROW(model.Analyze(0, INFINITY, 10), s21::BadExpression);
+  model.setExpression("1..2");
+  EXPECT_THROW(model.Analyze(0, 2, 3), s21::BadExpression);
+}
+
+TEST(RangeStatsModelTest, case_fit_range) {
+  s21::DefaultModel model;
+  model.setExpression("sin(x)*2");
+  std::vector<s21::RangeStats> stats = {model.Analyze(-10, 10, 10000)};
+  model.setExpression("x/4+5");
+  stats.push_back(model.Analyze(-10, 10, 10000));
+  double y_min = 0, y_max = 0;
+  ASSERT_TRUE(s21::CalcModelController::FitRange(stats, y_min, y_max));
+  double margin = 9.5 * s21::CalcModelController::kFitMargin;
+  EXPECT_NEAR(y_min, -2 - margin, 1e-4);
+  EXPECT_NEAR(y_max, 7.5 + margin, 1e-4);
+  model.setExpression("1");
+  stats = {model.Analyze(-10, 10, 100)};
+  ASSERT_TRUE(s21::CalcModelController::FitRange(stats, y_min, y_max));
+  EXPECT_EQ(y_min, 0);
+  EXPECT_EQ(y_max, 2);
+  model.setExpression("ln(-1-x*x)");
+  stats = {model.Analyze(-10, 10, 100)};
+  EXPECT_FALSE(s21::CalcModelController::FitRange(stats, y_min, y_max));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,94 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+
+#include "../src/model/defaultmodel.h"
+#include "../src/model/resultcache.h"
+
+TEST(ResultCacheTest, case_find) {
+  s21::ResultCache cache;
+  double y = 0;
+  EXPECT_FALSE(cache.Find(1, 2, y));
+  cache.Insert(1, 2, 4);
+  ASSERT_TRUE(cache.Find(1, 2, y));
+  EXPECT_EQ(y, 4);
+  EXPECT_FALSE(cache.Find(2, 2, y));
+  EXPECT_FALSE(cache.Find(1, std::nextafter(2.0, 3.0), y));
+  cache.Insert(1, 0.0, 1);
+  EXPECT_FALSE(cache.Find(1, -0.0, y));
+  cache.Insert(1, NAN, 5);
+  ASSERT_TRUE(cache.Find(1, NAN, y));
+  EXPECT_EQ(y, 5);
+  cache.Clear();
+  EXPECT_FALSE(cache.Find(1, 2, y));
+  cache.Insert(0, 2, 4);
+  EXPECT_FALSE(cache.Find(0, 2, y));
+}
+
+TEST(ResultCacheTest, case_bounded) {
+  s21::ResultCache cache;
+  for (std::uint64_t i = 0; i < 10 * s21::ResultCache::kEntries; ++i)
+    cache.Insert(1, static_cast<double>(i), static_cast<double>(i) * 2);
+  std::size_t found = 0;
+  double y = 0;
+  for (std::uint64_t i = 0; i < 10 * s21::ResultCache::kEntries; ++i) {
+    if (cache.Find(1, static_cast<double>(i), y)) {
+      ++found;
+      EXPECT_EQ(y, static_cast<double>(i) * 2);
+    }
+  }
+  EXPECT_GT(found, 0u);
+  EXPECT_LE(found, s21::ResultCache::kEntries);
+  EXPECT_LE(sizeof(cache), 32 * s21::ResultCache::kEntries);
+}
+
+TEST(ResultCacheModelTest, case_invalidate) {
+  s21::DefaultModel model;
+  model.setExpression("x^2");
+  EXPECT_EQ(model.Calculate(3), 9);
+  EXPECT_EQ(model.Calculate(3), 9);
+  model.setExpression("x^3");
+  EXPECT_EQ(model.Calculate(3), 27);
+  model.EditExpression("x^2");
+  EXPECT_EQ(model.Calculate(3), 9);
+  ASSERT_TRUE(model.TrySetExpression("x+1"));
+  EXPECT_EQ(model.Calculate(3), 4);
+  model.Define("f", "t", "t*10");
+  model.setExpression("f(x)");
+  EXPECT_EQ(model.Calculate(3), 30);
+  model.Define("f", "t", "t*100");
+  model.setExpression("f(x)");
+  EXPECT_EQ(model.Calculate(3), 300);
+  model.setExpression("1..2");
+  EXPECT_THROW(model.Calculate(3), s21::BadExpression);
+  EXPECT_THROW(model.Calculate(3), s21::BadExpression);
+}
+
+#ifdef S21_MODEL_STATS
+TEST(ResultCacheModelTest, case_memoized) {
+  s21::DefaultModel model;
+  model.setExpression("sin(x)*cos(x)");
+  model.ResetStats();
+  for (int i = 0; i < 5; ++i) EXPECT_EQ(model.Calculate(1), model.Calculate(1));
+  model.Calculate(2);
+  auto calls = [&model] {
+    return model.Stats()[static_cast<int>(s21::Stage::kCalculate)].calls;
+  };
+  EXPECT_EQ(calls(), 2u);
+  model.SetResultCache(false);
+  model.ResetStats();
+  for (int i = 0; i < 5; ++i) model.Calculate(1);
+  EXPECT_EQ(calls(), 5u);
+  model.SetResultCache(true);
+  model.ResetStats();
+  for (int i = 0; i < 5; ++i) model.Calculate(1);
+  EXPECT_EQ(calls(), 1u);
+}
+#endif
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../src/model/defaultmodel.h"
+#include "../src/model/resultring.h"
+
+TEST(ResultRingTest, case_records) {
+  s21::ResultRing ring = s21::ResultRing::Create(100);
+  ASSERT_GE(ring.Capacity(), 100u);
+  s21::ResultRing::Record record;
+  EXPECT_FALSE(ring.Peek(record));
+  EXPECT_EQ(ring.Begin(ring.Capacity()), nullptr);
+
+  double* values = ring.Begin(3);
+  ASSERT_NE(values, nullptr);
+  EXPECT_EQ(ring.Begin(1), nullptr);
+  ASSERT_TRUE(ring.Peek(record));
+  EXPECT_EQ(record.size, 3u);
+  EXPECT_EQ(record.ready, 0u);
+  EXPECT_FALSE(record.complete);
+  values[0] = 1.5;
+  ring.Progress(1);
+  ASSERT_TRUE(ring.Peek(record));
+  EXPECT_EQ(record.ready, 1u);
+  EXPECT_EQ(record.data[0], 1.5);
+  ring.Consume();
+  ASSERT_TRUE(ring.Peek(record));
+  values[1] = 2.5;
+  values[2] = 3.5;
+  ring.Commit();
+  EXPECT_EQ(ring.Sequence(), 1u);
+  ASSERT_TRUE(ring.Peek(record));
+  EXPECT_TRUE(record.complete);
+  EXPECT_EQ(record.ready, 3u);
+  EXPECT_EQ(record.data, values);
+  ring.Consume();
+  EXPECT_FALSE(ring.Peek(record));
+}
+
+TEST(ResultRingTest, case_wrap_around) {
+  s21::ResultRing producer = s21::ResultRing::Create(1);
+  s21::ResultRing consumer = s21::ResultRing::Attach(dup(producer.Fd()));
+  std::size_t size = producer.Capacity() / 3;
+  for (int round = 0; round < 20; round += 2) {
+    for (int record = round; record < round + 2; ++record) {
+      double* values = producer.Begin(size);
+      ASSERT_NE(values, nullptr) << record;
+      for (std::size_t i = 0; i < size; ++i) values[i] = record * 1e6 + i;
+      producer.Commit();
+    }
+    EXPECT_EQ(producer.Begin(size), nullptr);
+    s21::ResultRing::Record record;
+    for (int expected = round; expected < round + 2; ++expected) {
+      ASSERT_TRUE(consumer.Peek(record));
+      ASSERT_TRUE(record.complete);
+      ASSERT_EQ(record.size, size);
+      for (std::size_t i = 0; i < size; ++i)
+        ASSERT_EQ(record.data[i], expected * 1e6 + i) << expected << " " << i;
+      consumer.Consume();
+    }
+    EXPECT_FALSE(consumer.Peek(record));
+  }
+  EXPECT_EQ(producer.Sequence(), 20u);
+}
+
+TEST(ResultRingTest, case_attach) {
+  EXPECT_THROW(s21::ResultRing::Attach(dup(STDIN_FILENO)),
+               std::invalid_argument);
+  s21::ResultRing ring = s21::ResultRing::Create(10);
+  s21::ResultRing moved = std::move(ring);
+  EXPECT_EQ(ring.Fd(), -1);
+  ring = s21::ResultRing::Attach(dup(moved.Fd()));
+  EXPECT_EQ(ring.Capacity(), moved.Capacity());
+}
+
+TEST(ResultRingTest, case_other_process) {
+  s21::ResultRing ring = s21::ResultRing::Create(1 << 16);
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (!child) {
+    s21::ResultRing consumer = s21::ResultRing::Attach(dup(ring.Fd()));
+    s21::ResultRing::Record record;
+    double sum = 0;
+    for (int received = 0; received < 50;) {
+      if (!consumer.Peek(record) || !record.complete) {
+        std::this_thread::yield();
+        continue;
+      }
+      for (std::size_t i = 0; i < record.size; ++i) sum += record.data[i];
+      consumer.Consume();
+      ++received;
+    }
+    _exit(sum == 50 * 1000 * 999 / 2 ? 0 : 1);
+  }
+  for (int sent = 0; sent < 50;) {
+    double* values = ring.Begin(1000);
+    if (!values) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (int i = 0; i < 1000; ++i) values[i] = i;
+    ring.Commit();
+    ++sent;
+  }
+  int status = 0;
+  ASSERT_EQ(waitpid(child, &status, 0), child);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(ResultRingTest, case_plot_into) {
+  constexpr std::size_t kSize = s21::DefaultModel::kRangeFinesse;
+  s21::ResultRing ring = s21::ResultRing::Create(3 * kSize);
+  s21::ResultRing consumer = s21::ResultRing::Attach(dup(ring.Fd()));
+  s21::DefaultModel model;
+  model.setExpression("1/x");
+  s21::DefaultModel::set_type expected = model.Plot(-2, 2, -10, 10);
+
+  std::vector<std::size_t> progress;
+  std::thread reader([&] {
+    s21::ResultRing::Record record;
+    do {
+      if (consumer.Peek(record) &&
+          (progress.empty() || progress.back() != record.ready))
+        progress.push_back(record.ready);
+    } while (!record.complete);
+  });
+  ASSERT_TRUE(model.PlotInto(ring, -2, 2, -10, 10));
+  reader.join();
+  EXPECT_EQ(progress.back(), 2 * kSize);
+  EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+  EXPECT_FALSE(model.PlotInto(ring, -2, 2, -10, 10));
+
+  s21::ResultRing::Record record;
+  ASSERT_TRUE(consumer.Peek(record));
+  ASSERT_EQ(record.size, 2 * kSize);
+  for (std::size_t i = 0; i < kSize; ++i) {
+    EXPECT_EQ(record.data[i], expected.first[i]);
+    if (std::isnan(expected.second[i]))
+      EXPECT_TRUE(std::isnan(record.data[kSize + i])) << i;
+    else
+      EXPECT_EQ(record.data[kSize + i], expected.second[i]) << i;
+  }
+  consumer.Consume();
+  EXPECT_THROW(model.PlotInto(ring, 2, -2, -10, 10), s21::BadExpression);
+  EXPECT_FALSE(consumer.Peek(record));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,154 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "../model/badexpression.h"
+#include "../src/model/calculator.h"
+#include "../src/model/compiler.h"
+#include "../src/model/definitions.h"
+#include "../src/model/evaluator.h"
+#include "../src/model/serialization.h"
+
+class SerializationTest : public ::testing::Test {
+ protected:
+  std::vector<char> Save(const std::string& expression) {
+    std::vector<char> buffer;
+    s21::SaveProgram(compiler.Compile(expression), buffer);
+    return buffer;
+  }
+
+  s21::ShuntingYardCompiler compiler;
+  s21::RPNCalculator calc;
+};
+
+TEST_F(SerializationTest, case_round_trip) {
+  for (const char* expression :
+       {"2+2", "sin(x)^2+cos(x)^2", "-x mod 3", "ln(1+2*(3-4/(x+5)))"}) {
+    s21::Program program = compiler.Compile(expression);
+    std::vector<char> buffer;
+    s21::SaveProgram(program, buffer);
+    std::size_t used = 0;
+    auto view = s21::LoadProgram(buffer.data(), buffer.size(), &used);
+    ASSERT_TRUE(view) << expression;
+    EXPECT_EQ(used, buffer.size());
+    EXPECT_EQ(view->size(), program.Code().size());
+    EXPECT_EQ(view->MaxDepth(), program.MaxDepth());
+    EXPECT_EQ(static_cast<const void*>(view->begin()),
+              static_cast<const void*>(buffer.data() + 24));
+    for (double x : {-2.0, 0.5, 7.0})
+      EXPECT_DOUBLE_EQ(calc.Calculate(*view, x), calc.Calculate(program, x));
+  }
+}
+
+TEST_F(SerializationTest, case_two_variables) {
+  std::uint32_t variables = 0;
+  std::vector<char> buffer = Save("x*2");
+  std::memcpy(&variables, buffer.data() + 16, sizeof(variables));
+  EXPECT_EQ(variables, 1u);
+  EXPECT_TRUE(s21::LoadProgram(buffer.data(), buffer.size(), nullptr, 2));
+
+  compiler.AllowY(true);
+  s21::Program program = compiler.Compile("x^2+y*3");
+  buffer.clear();
+  s21::SaveProgram(program, buffer);
+  std::memcpy(&variables, buffer.data() + 16, sizeof(variables));
+  EXPECT_EQ(variables, 2u);
+  EXPECT_FALSE(s21::LoadProgram(buffer.data(), buffer.size()));
+  auto view = s21::LoadProgram(buffer.data(), buffer.size(), nullptr, 2);
+  ASSERT_TRUE(view);
+  s21::Evaluator<double> evaluator;
+  EXPECT_DOUBLE_EQ(evaluator.Calculate(*view, 2, 5), 19);
+
+  std::vector<char> broken = buffer;
+  variables = 1;
+  std::memcpy(broken.data() + 16, &variables, sizeof(variables));
+  EXPECT_FALSE(s21::LoadProgram(broken.data(), broken.size(), nullptr, 2));
+  variables = 3;
+  std::memcpy(broken.data() + 16, &variables, sizeof(variables));
+  EXPECT_FALSE(s21::LoadProgram(broken.data(), broken.size(), nullptr, 3));
+}
+
+TEST_F(SerializationTest, case_inlined) {
+  auto definitions = std::make_shared<s21::Definitions>();
+  s21::ShuntingYardCompiler body;
+  body.SetParameter("t");
+  definitions->DefineFunction("f", body.Compile("t*t+sin(t)"));
+  compiler.UseDefinitions(definitions);
+  s21::Program program = compiler.Compile("f(f(x+1))");
+  std::vector<char> buffer;
+  s21::SaveProgram(program, buffer);
+  auto view = s21::LoadProgram(buffer.data(), buffer.size());
+  ASSERT_TRUE(view);
+  EXPECT_DOUBLE_EQ(calc.Calculate(*view, 0.5), calc.Calculate(program, 0.5));
+
+  std::size_t load = 0;
+  while (program.Code()[load].op != s21::Opcode::kLoad) ++load;
+  std::vector<char> broken = buffer;
+  double slot = 5;
+  std::memcpy(broken.data() + 24 + 16 * load + 8, &slot, sizeof(slot));
+  EXPECT_FALSE(s21::LoadProgram(broken.data(), broken.size()));
+}
+
+TEST_F(SerializationTest, case_many_records) {
+  std::vector<char> buffer;
+  for (int i = 1; i <= 100; ++i)
+    s21::SaveProgram(compiler.Compile(std::to_string(i) + "*x"), buffer);
+  EXPECT_EQ(buffer.size() % 8, 0u);
+  std::size_t offset = 0, used = 0;
+  for (int i = 1; i <= 100; ++i, offset += used) {
+    auto view =
+        s21::LoadProgram(buffer.data() + offset, buffer.size() - offset, &used);
+    ASSERT_TRUE(view);
+    double y = 0;
+    double x = 2;
+    calc.Calculate(*view, &x, &y, 1);
+    EXPECT_DOUBLE_EQ(y, 2.0 * i);
+  }
+  EXPECT_EQ(offset, buffer.size());
+}
+
+TEST_F(SerializationTest, case_invalid_program) {
+  std::vector<char> buffer;
+  EXPECT_THROW(s21::SaveProgram(compiler.Compile("2.3.4+x"), buffer),
+               s21::BadExpression);
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST_F(SerializationTest, case_rejected) {
+  std::vector<char> buffer = Save("sin(x)+2");
+  EXPECT_FALSE(s21::LoadProgram(buffer.data(), buffer.size() - 1));
+  EXPECT_FALSE(s21::LoadProgram(buffer.data(), 10));
+
+  std::vector<char> broken = buffer;
+  broken[0] = 'X';
+  EXPECT_FALSE(s21::LoadProgram(broken.data(), broken.size()));
+
+  broken = buffer;
+  broken[4] = 2;
+  EXPECT_FALSE(s21::LoadProgram(broken.data(), broken.size()));
+
+  broken = buffer;
+  broken[24] = 100;
+  EXPECT_FALSE(s21::LoadProgram(broken.data(), broken.size()));
+
+  broken = buffer;
+  broken[24] = static_cast<char>(s21::Opcode::kAdd);
+  EXPECT_FALSE(s21::LoadProgram(broken.data(), broken.size()));
+
+  broken = buffer;
+  broken[12]++;
+  EXPECT_FALSE(s21::LoadProgram(broken.data(), broken.size()));
+
+  std::vector<double> storage(buffer.size() / 8 + 1);
+  char* misaligned = reinterpret_cast<char*>(storage.data()) + 4;
+  std::memcpy(misaligned, buffer.data(), buffer.size());
+  EXPECT_FALSE(s21::LoadProgram(misaligned, buffer.size()));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
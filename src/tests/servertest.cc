@@ -0,0 +1,304 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/server/protocol.h"
+#include "../src/server/server.h"
+
+namespace {
+struct Reply {
+  s21::ReplyStatus status;
+  std::string body;
+};
+
+class Client {
+ public:
+  explicit Client(const std::string& path) {
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+    connected_ = connect(fd_, reinterpret_cast<sockaddr*>(&address),
+                         sizeof(address)) == 0;
+  }
+  ~Client() { close(fd_); }
+
+  bool Connected() const { return connected_; }
+
+  std::uint32_t Compile(const std::string& expression) {
+    s21::FrameWriter frame(pending_, ++id_,
+                           static_cast<std::uint8_t>(
+                               s21::RequestType::kCompile));
+    frame.Bytes(expression);
+    return id_;
+  }
+
+  std::uint32_t Evaluate(std::uint32_t handle, std::vector<double> x) {
+    s21::FrameWriter frame(pending_, ++id_,
+                           static_cast<std::uint8_t>(
+                               s21::RequestType::kEvaluate));
+    frame.U32(handle);
+    frame.Doubles(x.data(), x.size());
+    return id_;
+  }
+
+  std::uint32_t Plot(std::uint32_t handle, double l, double r) {
+    s21::FrameWriter frame(pending_, ++id_,
+                           static_cast<std::uint8_t>(s21::RequestType::kPlot));
+    frame.U32(handle);
+    for (double value : {l, r, -1e9, 1e9}) frame.F64(value);
+    return id_;
+  }
+
+  std::uint32_t Release(std::uint32_t handle) {
+    s21::FrameWriter frame(
+        pending_, ++id_,
+        static_cast<std::uint8_t>(s21::RequestType::kRelease));
+    frame.U32(handle);
+    return id_;
+  }
+
+  std::uint32_t Raw(std::uint8_t kind, const std::string& body) {
+    s21::FrameWriter frame(pending_, ++id_, kind);
+    frame.Bytes(body);
+    return id_;
+  }
+
+  void Flush() {
+    if (pending_.empty()) return;
+    ASSERT_EQ(write(fd_, pending_.data(), pending_.size()),
+              static_cast<ssize_t>(pending_.size()));
+    pending_.clear();
+  }
+
+  void Finish() {
+    Flush();
+    shutdown(fd_, SHUT_WR);
+  }
+
+  Reply Wait(std::uint32_t id) {
+    Flush();
+    while (!replies_.count(id)) {
+      s21::Frame frame;
+      std::size_t used = 0;
+      if (s21::SplitFrame(input_, frame, used) ==
+          s21::FrameState::kComplete) {
+        replies_[frame.id] = {static_cast<s21::ReplyStatus>(frame.kind),
+                              std::string(frame.body)};
+        input_.erase(0, used);
+        continue;
+      }
+      char buffer[4096];
+      ssize_t got = read(fd_, buffer, sizeof(buffer));
+      if (got <= 0) return {s21::ReplyStatus::kMalformed, "closed"};
+      input_.append(buffer, got);
+    }
+    Reply reply = replies_[id];
+    replies_.erase(id);
+    return reply;
+  }
+
+  std::uint32_t Handle(std::uint32_t id) {
+    Reply reply = Wait(id);
+    std::uint32_t handle = 0;
+    s21::BodyReader body(reply.body);
+    EXPECT_EQ(reply.status, s21::ReplyStatus::kOk) << reply.body;
+    EXPECT_TRUE(body.U32(handle));
+    return handle;
+  }
+
+  std::vector<double> Values(std::uint32_t id) {
+    Reply reply = Wait(id);
+    EXPECT_EQ(reply.status, s21::ReplyStatus::kOk) << reply.body;
+    std::vector<double> values(reply.body.size() / sizeof(double));
+    if (!values.empty())
+      std::memcpy(values.data(), reply.body.data(), reply.body.size());
+    return values;
+  }
+
+ private:
+  int fd_ = -1;
+  bool connected_ = false;
+  std::uint32_t id_ = 0;
+  std::string pending_, input_;
+  std::map<std::uint32_t, Reply> replies_;
+};
+
+class ServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path = "/tmp/smartcalc_test_" + std::to_string(getpid()) + ".sock";
+    server = std::make_unique<s21::Server>(path);
+    thread = std::thread([this] { server->Run(); });
+  }
+
+  void TearDown() override {
+    server->Stop();
+    thread.join();
+    server.reset();
+    EXPECT_NE(access(path.c_str(), F_OK), 0);
+  }
+
+  std::string path;
+  std::unique_ptr<s21::Server> server;
+  std::thread thread;
+};
+}  // namespace
+
+TEST_F(ServerTest, case_evaluate) {
+  Client client(path);
+  ASSERT_TRUE(client.Connected());
+  std::uint32_t handle = client.Handle(client.Compile("x^2+1"));
+  EXPECT_EQ(client.Values(client.Evaluate(handle, {0, 2, -3})),
+            (std::vector<double>{1, 5, 10}));
+  EXPECT_TRUE(client.Values(client.Evaluate(handle, {})).empty());
+  std::vector<double> y = client.Values(client.Evaluate(handle, {-1}));
+  ASSERT_EQ(y.size(), 1u);
+  EXPECT_EQ(y[0], 2);
+}
+
+TEST_F(ServerTest, case_errors) {
+  Client client(path);
+  EXPECT_EQ(client.Handle(client.Compile("2+sin(x")), 1u);
+  Reply reply = client.Wait(client.Compile("2+$"));
+  ASSERT_EQ(reply.status, s21::ReplyStatus::kBadExpression);
+  s21::BodyReader body(reply.body);
+  std::uint8_t code = 0;
+  std::uint32_t offset = 0, length = 0;
+  ASSERT_TRUE(body.U8(code) && body.U32(offset) && body.U32(length));
+  EXPECT_NE(code, 0);
+  EXPECT_EQ(offset, 2u);
+  EXPECT_FALSE(body.Rest().empty());
+
+  EXPECT_EQ(client.Wait(client.Evaluate(77, {1})).status,
+            s21::ReplyStatus::kUnknownHandle);
+  EXPECT_EQ(client.Wait(client.Release(77)).status,
+            s21::ReplyStatus::kUnknownHandle);
+  EXPECT_EQ(client.Wait(client.Raw(42, "")).status,
+            s21::ReplyStatus::kMalformed);
+  EXPECT_EQ(client.Wait(client.Raw(2, "abc")).status,
+            s21::ReplyStatus::kMalformed);
+  EXPECT_EQ(client.Wait(client.Plot(1, 0, 1)).status, s21::ReplyStatus::kOk);
+}
+
+TEST_F(ServerTest, case_coalescing) {
+  Client client(path);
+  std::uint32_t handle = client.Handle(client.Compile("sin(x)*x"));
+  std::size_t before = server->Evaluations();
+  std::vector<std::uint32_t> ids;
+  for (int i = 0; i < 20; ++i) ids.push_back(client.Evaluate(handle, {i * 1.}));
+  client.Flush();
+  for (int i = 0; i < 20; ++i) {
+    std::vector<double> y = client.Values(ids[i]);
+    ASSERT_EQ(y.size(), 1u);
+    EXPECT_DOUBLE_EQ(y[0], std::sin(i) * i);
+  }
+  EXPECT_LT(server->Evaluations() - before, 20u);
+}
+
+TEST_F(ServerTest, case_handles) {
+  auto first = std::make_unique<Client>(path);
+  Client second(path);
+  std::uint32_t a = first->Handle(first->Compile("x+1"));
+  std::uint32_t b = second.Handle(second.Compile("x+1"));
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(server->Handles(), 1u);
+  EXPECT_EQ(second.Wait(second.Release(b)).status, s21::ReplyStatus::kOk);
+  EXPECT_EQ(second.Wait(second.Evaluate(b, {1})).status,
+            s21::ReplyStatus::kUnknownHandle);
+  EXPECT_EQ(first->Values(first->Evaluate(a, {1})),
+            (std::vector<double>{2}));
+  first.reset();
+  std::uint32_t c = second.Handle(second.Compile("x+2"));
+  EXPECT_EQ(server->Handles(), 1u);
+  EXPECT_EQ(second.Values(second.Evaluate(c, {1})), (std::vector<double>{3}));
+}
+
+TEST_F(ServerTest, case_half_close) {
+  Client client(path);
+  std::uint32_t compile = client.Compile("x^2");
+  std::uint32_t evaluate = client.Evaluate(1, {3});
+  std::uint32_t plot = client.Plot(1, -1, 1);
+  client.Finish();
+  EXPECT_EQ(client.Handle(compile), 1u);
+  EXPECT_EQ(client.Values(evaluate), (std::vector<double>{9}));
+  EXPECT_EQ(client.Wait(plot).status, s21::ReplyStatus::kOk);
+  EXPECT_EQ(client.Wait(plot + 1).body, "closed");
+}
+
+TEST_F(ServerTest, case_plot) {
+  Client client(path);
+  std::uint32_t handle = client.Handle(client.Compile("2*x"));
+  Reply reply = client.Wait(client.Plot(handle, -1, 1));
+  ASSERT_EQ(reply.status, s21::ReplyStatus::kOk);
+  s21::BodyReader body(reply.body);
+  std::uint32_t n = 0;
+  ASSERT_TRUE(body.U32(n));
+  ASSERT_GT(n, 0u);
+  ASSERT_EQ(body.Rest().size(), 2 * n * sizeof(double));
+  std::vector<double> points(2 * n);
+  std::memcpy(points.data(), body.Rest().data(), body.Rest().size());
+  for (std::uint32_t i = 0; i < n; ++i)
+    EXPECT_DOUBLE_EQ(points[n + i], 2 * points[i]);
+}
+
+TEST_F(ServerTest, case_plot_range) {
+  Client client(path);
+  std::uint32_t handle = client.Handle(client.Compile("2*x"));
+  EXPECT_EQ(client.Wait(client.Plot(handle, 1, -1)).status,
+            s21::ReplyStatus::kMalformed);
+  EXPECT_EQ(client.Wait(client.Plot(handle, NAN, 1)).status,
+            s21::ReplyStatus::kMalformed);
+  EXPECT_EQ(client.Wait(client.Plot(handle, -1, INFINITY)).status,
+            s21::ReplyStatus::kMalformed);
+  EXPECT_EQ(client.Wait(client.Plot(handle, -1, 1)).status,
+            s21::ReplyStatus::kOk);
+  EXPECT_EQ(client.Values(client.Evaluate(handle, {3})),
+            (std::vector<double>{6}));
+}
+
+TEST(ProtocolTest, case_frames) {
+  std::string out;
+  {
+    s21::FrameWriter frame(out, 7, 3);
+    frame.U32(5);
+    frame.F64(0.5);
+  }
+  ASSERT_EQ(out.size(), s21::kFrameHeaderSize + 12);
+  s21::Frame frame;
+  std::size_t used = 0;
+  EXPECT_EQ(s21::SplitFrame(std::string_view(out).substr(0, out.size() - 1),
+                            frame, used),
+            s21::FrameState::kIncomplete);
+  ASSERT_EQ(s21::SplitFrame(out, frame, used), s21::FrameState::kComplete);
+  EXPECT_EQ(used, out.size());
+  EXPECT_EQ(frame.id, 7u);
+  EXPECT_EQ(frame.kind, 3);
+  s21::BodyReader body(frame.body);
+  std::uint32_t u = 0;
+  double d = 0;
+  EXPECT_TRUE(body.U32(u) && body.F64(d));
+  EXPECT_EQ(u, 5u);
+  EXPECT_EQ(d, 0.5);
+  EXPECT_FALSE(body.U32(u));
+
+  std::string huge(4, '\xff');
+  EXPECT_EQ(s21::SplitFrame(huge, frame, used), s21::FrameState::kOversized);
+  std::string tiny(4, '\0');
+  EXPECT_EQ(s21::SplitFrame(tiny, frame, used), s21::FrameState::kOversized);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "../model/badexpression.h"
+#include "../src/model/calculator.h"
+#include "../src/model/compiler.h"
+#include "../src/model/staticprogram.h"
+
+static constexpr auto kSum = s21::StaticCompile("1+2*3");
+static_assert(kSum.size == 5 && kSum.max_depth == 3,
+              "The literal is compiled at compile time");
+static_assert(kSum.code[4].op == s21::Opcode::kAdd &&
+                  kSum.code[3].op == s21::Opcode::kMul,
+              "Multiplication takes priority");
+
+static constexpr auto kPower = s21::StaticCompile("-x^2^0.5");
+static_assert(kPower.code[kPower.size - 1].op == s21::Opcode::kMinus &&
+                  kPower.code[kPower.size - 2].op == s21::Opcode::kPow,
+              "Powers are right-associative and bind tighter than minus");
+
+static constexpr auto kImplicit = s21::StaticCompile(" 2x(x+1)sin(x) mod 3");
+static constexpr auto kNested = s21::StaticCompile("sqrt(ln(acos(x/9)+2)");
+static constexpr auto kNumbers = s21::StaticCompile("1.5e3+.25-7.e-2+0.000125");
+static_assert(kNumbers.code[0].value == 1500 && kNumbers.code[1].value == 0.25,
+              "Numbers are parsed at compile time");
+
+class StaticProgramTest : public ::testing::Test {
+ protected:
+  template <const auto& kProgram>
+  void ExpectSame(const char* expression) {
+    s21::Program program = compiler.Compile(expression);
+    ASSERT_EQ(kProgram.size, program.Code().size()) << expression;
+    EXPECT_EQ(kProgram.max_depth, program.MaxDepth()) << expression;
+    for (std::size_t i = 0; i < kProgram.size; ++i) {
+      EXPECT_EQ(kProgram.code[i].op, program.Code()[i].op) << expression;
+      EXPECT_EQ(kProgram.code[i].value, program.Code()[i].value) << expression;
+    }
+    for (double x : {-3.5, 0.25, 2.0, 7.75}) {
+      double expected = calc.Calculate(program, x);
+      for (double returned : {s21::StaticCalculate<kProgram>(x),
+                              calc.Calculate(kProgram.View(), x)}) {
+        if (std::isnan(expected))
+          EXPECT_TRUE(std::isnan(returned)) << expression;
+        else
+          EXPECT_EQ(expected, returned) << expression << " x=" << x;
+      }
+    }
+  }
+
+  s21::ShuntingYardCompiler compiler;
+  s21::RPNCalculator calc;
+};
+
+TEST_F(StaticProgramTest, case_same_as_runtime) {
+  ExpectSame<kSum>("1+2*3");
+  ExpectSame<kPower>("-x^2^0.5");
+  ExpectSame<kImplicit>(" 2x(x+1)sin(x) mod 3");
+  ExpectSame<kNested>("sqrt(ln(acos(x/9)+2)");
+  ExpectSame<kNumbers>("1.5e3+.25-7.e-2+0.000125");
+}
+
+TEST_F(StaticProgramTest, case_numbers) {
+  for (const char* number :
+       {"0.1", "3.14159265358979323846", "6.02214076e23", "1e-300",
+        "123456789012345678901234567890", "2.2250738585072014e-308",
+        "1.7976931348623157e308"}) {
+    char expression[64] = {};
+    std::strcpy(expression, number);
+    auto program = s21::StaticCompile(expression);
+    double expected = std::strtod(number, nullptr);
+    EXPECT_NEAR(program.code[0].value, expected, std::fabs(expected) * 1e-15)
+        << number;
+  }
+  EXPECT_EQ(s21::StaticCompile("0.1").code[0].value, 0.1);
+  EXPECT_EQ(s21::StaticCompile("1e22").code[0].value, 1e22);
+}
+
+TEST_F(StaticProgramTest, case_errors_at_run_time) {
+  char unfinished[] = "2+";
+  char unknown[] = "2*foo(x)";
+  char number[] = "2.3.4";
+  char range[] = "1e400";
+  char bracket[] = "(x))";
+  char function[] = "sinx";
+  char blank[] = "  ";
+  EXPECT_THROW(s21::StaticCompile(unfinished), s21::BadExpression);
+  EXPECT_THROW(s21::StaticCompile(number), s21::BadExpression);
+  EXPECT_THROW(s21::StaticCompile(range), s21::BadExpression);
+  EXPECT_THROW(s21::StaticCompile(bracket), s21::BadExpression);
+  EXPECT_THROW(s21::StaticCompile(function), s21::BadExpression);
+  EXPECT_THROW(s21::StaticCompile(blank), s21::BadExpression);
+  try {
+    s21::StaticCompile(unknown);
+    FAIL();
+  } catch (const s21::BadExpression& e) {
+    EXPECT_EQ(e.error().code, s21::ErrorCode::kUnknownFunction);
+    EXPECT_EQ(e.error().offset, 2u);
+    EXPECT_EQ(e.error().length, 3u);
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -514,6 +514,38 @@ TEST(TokenizerTest, case_error_mismatch_op_2) {
   EXPECT_THROW(tr.Tokenize("1+sin*2"), s21::BadExpression);
 }
 
+TEST(TokenizerTest, case_keyword_1) {
+  s21::Tokenizer tr;
+  std::string expected = "7%3";
+  std::list<std::string> returned = tr.Tokenize("7mod3");
+  EXPECT_EQ(expected, to_string(returned));
+  EXPECT_FALSE(tr.ExpressionChanged());
+}
+
+TEST(TokenizerTest, case_keyword_2) {
+  s21::Tokenizer tr;
+  std::string expected = "x%(2)*sin(x)";
+  std::list<std::string> returned = tr.Tokenize("x mod (2) sin(x)");
+  EXPECT_EQ(expected, to_string(returned));
+}
+
+TEST(TokenizerTest, case_keyword_3) {
+  s21::Tokenizer tr;
+  std::string expected = "2%~3";
+  std::list<std::string> returned = tr.Tokenize("2 mod -3");
+  EXPECT_EQ(expected, to_string(returned));
+}
+
+TEST(TokenizerTest, case_error_keyword_1) {
+  s21::Tokenizer tr;
+  EXPECT_THROW(tr.Tokenize("mod 3"), s21::BadExpression);
+}
+
+TEST(TokenizerTest, case_error_keyword_2) {
+  s21::Tokenizer tr;
+  EXPECT_THROW(tr.Tokenize("3 mo 2"), s21::BadExpression);
+}
+
 TEST(TokenizerTest, case_error_mismatch_op_3) {
   s21::Tokenizer tr;
   EXPECT_THROW(tr.Tokenize("cos-xcosx-sinxcos*sqrtsin-(1-xx+sqrt(1+cossin2x))"),
@@ -571,6 +603,78 @@ TEST(TokenizerTest, case_error_unknown_func_2) {
   EXPECT_THROW(tr.Tokenize("2@3"), s21::BadExpression);
 }
 
+class NullSink final : public s21::Tokenizer::Sink {
+ public:
+  void Push(s21::Tokenizer::TokenType, std::string_view) override {}
+};
+
+TEST(TokenizerTest, case_parse_unknown_func) {
+  s21::Tokenizer tr;
+  NullSink sink;
+  tr.Parse("1+qqrt(2)", sink);
+  EXPECT_EQ(tr.Error().code, s21::ErrorCode::kUnknownFunction);
+  EXPECT_EQ(tr.Error().offset, 2u);
+  EXPECT_EQ(tr.Error().length, 4u);
+}
+
+TEST(TokenizerTest, case_parse_mismatch) {
+  s21::Tokenizer tr;
+  NullSink sink;
+  tr.Parse("3-mod-.32", sink);
+  EXPECT_EQ(tr.Error().code, s21::ErrorCode::kMismatchedToken);
+  EXPECT_EQ(tr.Error().offset, 2u);
+  EXPECT_EQ(tr.Error().length, 3u);
+  tr.Parse("(1+)x", sink);
+  EXPECT_EQ(tr.Error().code, s21::ErrorCode::kMismatchedToken);
+  EXPECT_EQ(tr.Error().offset, 3u);
+  EXPECT_EQ(tr.Error().length, 1u);
+}
+
+TEST(TokenizerTest, case_parse_not_finished) {
+  s21::Tokenizer tr;
+  NullSink sink;
+  tr.Parse("2*", sink);
+  EXPECT_EQ(tr.Error().code, s21::ErrorCode::kNotFinished);
+  EXPECT_EQ(tr.Error().offset, 2u);
+  tr.Parse("", sink);
+  EXPECT_EQ(tr.Error().code, s21::ErrorCode::kEmpty);
+  tr.Parse("2", sink);
+  EXPECT_FALSE(tr.Error().Failed());
+}
+
+TEST(TokenizerTest, case_parse_fixes) {
+  s21::Tokenizer tr;
+  NullSink sink;
+  tr.Parse(" 2sin x)", sink);
+  EXPECT_FALSE(tr.Error().Failed());
+  ASSERT_EQ(tr.Fixes().size(), 5u);
+  EXPECT_EQ(tr.Fixes()[0].kind, s21::FixKind::kSpaceTrimmed);
+  EXPECT_EQ(tr.Fixes()[1].kind, s21::FixKind::kMultiplyInserted);
+  EXPECT_EQ(tr.Fixes()[1].offset, 2u);
+  EXPECT_EQ(tr.Fixes()[2].kind, s21::FixKind::kBracketOpened);
+  EXPECT_EQ(tr.Fixes()[2].offset, 6u);
+  EXPECT_EQ(tr.Fixes()[3].kind, s21::FixKind::kBracketClosed);
+  EXPECT_EQ(tr.Fixes()[3].offset, 7u);
+  EXPECT_EQ(tr.Fixes()[4].kind, s21::FixKind::kBracketDropped);
+  EXPECT_EQ(tr.Fixes()[4].offset, 7u);
+  tr.Parse("(2", sink);
+  ASSERT_EQ(tr.Fixes().size(), 1u);
+  EXPECT_EQ(tr.Fixes()[0].kind, s21::FixKind::kBracketClosed);
+  EXPECT_EQ(tr.Fixes()[0].offset, 2u);
+}
+
+TEST(TokenizerTest, case_error_position) {
+  s21::Tokenizer tr;
+  try {
+    tr.Tokenize("sin(2)+cos(2@)");
+    FAIL();
+  } catch (s21::BadExpression& e) {
+    EXPECT_EQ(e.error().code, s21::ErrorCode::kUnknownFunction);
+    EXPECT_EQ(e.error().offset, 12u);
+    EXPECT_EQ(e.error().length, 1u);
+  }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
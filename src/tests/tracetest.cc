@@ -0,0 +1,94 @@
+// Copyright 2023 School21 @gruntmet Snezhana Valeeva
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "../src/model/batch.h"
+#include "../src/model/defaultmodel.h"
+#include "../src/model/implicit.h"
+#include "../src/model/rangescan.h"
+#include "../src/model/trace.h"
+
+class TraceTest : public ::testing::Test {
+ protected:
+  void TearDown() override { std::remove(path.c_str()); }
+
+  std::string ReadTrace() {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+  }
+
+  static std::size_t Count(const std::string& text, const std::string& what) {
+    std::size_t count = 0;
+    for (auto pos = text.find(what); pos != std::string::npos;
+         pos = text.find(what, pos + 1))
+      ++count;
+    return count;
+  }
+
+  std::string path = ::testing::TempDir() + "smartcalc_trace.json";
+};
+
+TEST_F(TraceTest, case_disabled) {
+  EXPECT_FALSE(s21::Tracer::Instance().Enabled());
+  { s21::ScopedTrace trace("ignored", "test"); }
+  EXPECT_FALSE(s21::Tracer::Instance().Stop());
+}
+
+TEST_F(TraceTest, case_model_stages) {
+  s21::Tracer::Instance().Start(path);
+  s21::DefaultModel model;
+  model.setExpression("sin(x)");
+  model.Calculate(1);
+  model.Plot(-1, 1, -2, 2);
+  ASSERT_TRUE(s21::Tracer::Instance().Stop());
+  std::string trace = ReadTrace();
+  EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+  EXPECT_EQ(Count(trace, "\"name\":\"compile\",\"cat\":\"model\""), 1u);
+  EXPECT_EQ(Count(trace, "\"name\":\"plot\""), 1u);
+  EXPECT_EQ(Count(trace, "\"name\":\"calculate\""), 2u);
+}
+
+TEST_F(TraceTest, case_threads) {
+  s21::Tracer::Instance().Start(path);
+  { s21::ScopedTrace trace("main", "test"); }
+  std::thread worker([] {
+    for (int i = 0; i < 3; ++i) s21::ScopedTrace trace("worker", "test");
+  });
+  worker.join();
+  ASSERT_TRUE(s21::Tracer::Instance().Stop());
+  std::string trace = ReadTrace();
+  EXPECT_EQ(Count(trace, "\"ph\":\"X\""), 4u);
+  EXPECT_EQ(Count(trace, "\"name\":\"worker\""), 3u);
+  auto main_tid = trace.substr(trace.find("\"tid\":", trace.find("main")));
+  auto worker_tid =
+      trace.substr(trace.find("\"tid\":", trace.find("\"worker\"")));
+  EXPECT_NE(main_tid.substr(0, 8), worker_tid.substr(0, 8));
+}
+
+TEST_F(TraceTest, case_workers) {
+  s21::Tracer::Instance().Start(path);
+  s21::BatchEvaluator batch(2);
+  batch.Run({{"x", {1}}, {"x+1", {2}}, {"x+2", {3}}});
+  s21::DefaultModel model;
+  model.setExpression("sin(x)");
+  model.Analyze(-1, 1, s21::RangeScanner::kChunk * 3);
+  model.PlotImplicit("x*x+y*y-1", -2, 2, -2, 2);
+  ASSERT_TRUE(s21::Tracer::Instance().Stop());
+  std::string trace = ReadTrace();
+  constexpr std::size_t kTiles =
+      s21::ImplicitPlotter::kCoarseCells / s21::ImplicitPlotter::kTileCells;
+  EXPECT_EQ(Count(trace, "\"name\":\"BatchJob\""), 3u);
+  EXPECT_EQ(Count(trace, "\"name\":\"ScanChunk\""), 3u);
+  EXPECT_EQ(Count(trace, "\"name\":\"ImplicitTile\""), kTiles * kTiles);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
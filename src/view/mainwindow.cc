@@ -4,25 +4,57 @@
 #include <QDoubleValidator>
 #include <QFile>
 #include <QFontDatabase>
+#include <QMetaObject>
 #include <QTextStream>
-#include <regex>
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <string_view>
 
+#include "../model/decimation.h"
+#include "../model/stats.h"
 #include "./ui_mainwindow.h"
 
+namespace {
+/** The expression of the job running on this thread, if any*/
+thread_local const std::string* job_expression = nullptr;
+/** Receives the messages of the job running on this thread*/
+thread_local std::vector<std::string>* job_messages = nullptr;
+/** Whether the job running on this thread is a live preview*/
+thread_local bool job_preview = false;
+
+bool HasError(const std::vector<std::string>& messages) {
+  return std::any_of(messages.begin(), messages.end(),
+                     [](const std::string& message) {
+                       return std::string_view(message).substr(0, 6) ==
+                              "Error:";
+                     });
+}
+}  // namespace
+
 const std::set<QString> MainWindow::banned_buttons = {QString("button_ac"),
                                                       QString("button_del")};
 
+const QColor MainWindow::kGraphColors[] = {
+    QColor(0xff, 0xaa, 0x44), QColor(0x44, 0xaa, 0xff),
+    QColor(0x66, 0xdd, 0x66), QColor(0xee, 0x55, 0x77),
+    QColor(0xbb, 0x88, 0xff), QColor(0xee, 0xee, 0x55),
+    QColor(0x44, 0xdd, 0xcc), QColor(0xcc, 0xcc, 0xcc)};
+
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent), ui(new Ui::MainWindow) {
   ui->setupUi(this);
+  live_timer_.setSingleShot(true);
+  live_timer_.setInterval(kLiveDelay);
+  live_pool_.setMaxThreadCount(1);
   SetRestrictions();
   LoadStyle();
   ConnectEvents();
 }
 
 std::string MainWindow::GetExpr() {
-  return ReplaceCrutch(ui->edit_input->text().toStdString());
+  if (job_expression) return *job_expression;
+  return ui->edit_input->text().toStdString();
 }
 
 void MainWindow::SetRestrictions() {
@@ -35,6 +67,8 @@ void MainWindow::SetRestrictions() {
   ui->input_xr->setValidator(val);
   ui->input_yl->setValidator(val);
   ui->input_yr->setValidator(val);
+  ui->input_yl->setPlaceholderText("auto");
+  ui->input_yr->setPlaceholderText("auto");
 }
 
 void MainWindow::LoadStyle() {
@@ -61,8 +95,7 @@ void MainWindow::LoadStyle() {
   ui->plot->yAxis->setTickLabelFont(font);
   ui->plot->yAxis->setLabelFont(font);
 
-  ui->plot->addGraph();
-  ui->plot->graph(0)->setPen(QPen(QColor(0xff, 0xaa, 0x44, 0xff), 1.2));
+  SetGraphCount(1);
 
   ui->plot->xAxis->setLabel("x");
   ui->plot->yAxis->setLabel("y");
@@ -100,6 +133,96 @@ void MainWindow::ConnectEvents() {
   connect(ui->button_plot, &QPushButton::clicked, this, &MainWindow::Plot);
 
   connect(ui->edit_input, &QLineEdit::editingFinished, this, &MainWindow::Eval);
+  connect(ui->edit_input, &QLineEdit::textChanged, this,
+          &MainWindow::OnExprChanged);
+  connect(ui->check_live, &QCheckBox::toggled, this,
+          [this](bool) { OnExprChanged(ui->edit_input->text()); });
+  connect(&live_timer_, &QTimer::timeout, this, &MainWindow::LivePreview);
+}
+
+void MainWindow::OnExprChanged(const QString& text) {
+  if (ui->check_live->isChecked() && !text.isEmpty())
+    live_timer_.start();
+  else
+    live_timer_.stop();
+}
+
+void MainWindow::LivePreview() {
+  auto job = std::make_shared<LiveJob>();
+  job->generation = ++generation_;
+  job->expression = GetExpr();
+  job->x = ui->input_x->text();
+  job->plot = ReadPlotInput();
+  Start(job, &MainWindow::ComputeLive, &MainWindow::ShowLive);
+}
+
+void MainWindow::Start(const std::shared_ptr<LiveJob>& job,
+                       void (MainWindow::*compute)(LiveJob&),
+                       void (MainWindow::*show)(const LiveJob&)) {
+  live_pool_.start([this, job, compute, show] {
+    if (job->preview && Superseded(job->generation)) return;
+    job_expression = &job->expression;
+    job_messages = &job->messages;
+    job_preview = job->preview;
+    (this->*compute)(*job);
+    job_expression = nullptr;
+    job_messages = nullptr;
+    job_preview = false;
+    QMetaObject::invokeMethod(
+        this, [this, job, show] { (this->*show)(*job); },
+        Qt::QueuedConnection);
+  });
+}
+
+bool MainWindow::Superseded(std::uint64_t generation) const {
+  return generation && generation != generation_;
+}
+
+void MainWindow::ComputeEval(LiveJob& job) {
+  double arg = job.x.toDouble(&job.has_x);
+  if (job.has_x)
+    job.value = on_eval_(arg);
+  else
+    job.messages.push_back("Error: Invalid x argument");
+  job.evaluated = job.has_x && !HasError(job.messages);
+}
+
+void MainWindow::ComputeLive(LiveJob& job) {
+  ComputeEval(job);
+  if (!job.evaluated || Superseded(job.generation)) return;
+  job.output = ComputePlot(job.plot, job.generation);
+  job.plotted = job.output.error.empty() && !HasError(job.messages);
+}
+
+void MainWindow::ComputeGraph(LiveJob& job) {
+  job.output = ComputePlot(job.plot, 0);
+}
+
+void MainWindow::ShowLive(const LiveJob& job) {
+  if (job.generation != generation_ || !job.evaluated) return;
+  ui->label_msg->clear();
+  ui->label_output->setText(QString::number(job.value));
+  if (job.plotted) ShowPlot(job.output);
+}
+
+void MainWindow::ShowEval(const LiveJob& job) {
+  if (job.generation <= cleared_) return;
+  ShowMessages(job.messages);
+  if (job.has_x) ui->label_output->setText(QString::number(job.value));
+}
+
+void MainWindow::ShowGraph(const LiveJob& job) {
+  if (job.generation <= cleared_) return;
+  ShowMessages(job.messages);
+  if (job.output.error.empty())
+    ShowPlot(job.output);
+  else
+    SendError(job.output.error);
+}
+
+void MainWindow::ShowMessages(const std::vector<std::string>& messages) {
+  ui->label_msg->clear();
+  if (!messages.empty()) SendError(messages.back());
 }
 
 void MainWindow::InputButtonPressed() {
@@ -110,6 +233,7 @@ void MainWindow::InputButtonPressed() {
 void MainWindow::DelSymbol() { ui->edit_input->backspace(); }
 
 void MainWindow::ClearAll() {
+  cleared_ = ++generation_;
   ui->edit_input->clear();
   ui->input_x->setText("0");
   ui->input_xl->setText("-10");
@@ -119,48 +243,149 @@ void MainWindow::ClearAll() {
 
   ui->label_msg->clear();
   ui->label_output->setText("0");
+  SetGraphCount(1);
   ui->plot->graph(0)->data()->clear();
-  ui->plot->replot();
+  RemoveCurve();
+  Replot(0);
 }
 
 void MainWindow::SendError(const std::string& msg) {
+  if (job_messages) return job_messages->push_back(msg);
   ui->label_msg->setText(QString::fromStdString(msg));
 }
 
 void MainWindow::Eval() {
-  ui->label_msg->clear();
-  bool succ;
-  double arg = ui->input_x->text().toDouble(&succ);
-  if (succ)
-    ui->label_output->setText(QString::number(on_eval_(arg)));
-  else
-    SendError("Error: Invalid x argument");
+  auto job = std::make_shared<LiveJob>();
+  job->generation = ++generation_;
+  job->preview = false;
+  job->expression = GetExpr();
+  job->x = ui->input_x->text();
+  Start(job, &MainWindow::ComputeEval, &MainWindow::ShowEval);
 }
 
 void MainWindow::Plot() {
-  ui->label_msg->clear();
+  auto job = std::make_shared<LiveJob>();
+  job->generation = ++generation_;
+  job->preview = false;
+  job->expression = GetExpr();
+  job->plot = ReadPlotInput();
+  Start(job, &MainWindow::ComputeGraph, &MainWindow::ShowGraph);
+}
+
+MainWindow::PlotInput MainWindow::ReadPlotInput() const {
+  PlotInput input;
+  input.x_left = ui->input_xl->text();
+  input.x_right = ui->input_xr->text();
+  input.y_min = ui->input_yl->text();
+  input.y_max = ui->input_yr->text();
+  input.columns = static_cast<std::size_t>(ui->plot->axisRect()->width() *
+                                           ui->plot->devicePixelRatioF());
+  return input;
+}
+
+MainWindow::PlotOutput MainWindow::ComputePlot(const PlotInput& input,
+                                               std::uint64_t generation) const {
+  PlotOutput output;
   bool succ, accumulated = true;
-  double xlb = ui->input_xl->text().toDouble(&succ);
-  accumulated &= succ;
-  double xrb = ui->input_xr->text().toDouble(&succ);
+  double xlb = input.x_left.toDouble(&succ);
   accumulated &= succ;
-  double ylb = ui->input_yl->text().toDouble(&succ);
+  double xrb = input.x_right.toDouble(&succ);
   accumulated &= succ;
-  double yrb = ui->input_yr->text().toDouble(&succ);
+  double ylb = 0, yrb = 0;
+  if (input.y_min.isEmpty() && input.y_max.isEmpty()) {
+    if (!accumulated || !on_range_ || !on_range_(xlb, xrb, ylb, yrb)) {
+      ylb = xlb;
+      yrb = xrb;
+    }
+  } else {
+    ylb = input.y_min.toDouble(&succ);
+    accumulated &= succ;
+    yrb = input.y_max.toDouble(&succ);
+  }
+  if (Superseded(generation)) return output;
   if (yrb < ylb) {
-    SendError("Error: Invalid set boundaries");
-  } else if (accumulated) {
-    auto set = on_plot_(xlb, xrb, 2 * ylb - yrb, 2 * yrb - ylb);
-    QVector<double> x_set(set.first.begin(), set.first.end());
-    QVector<double> y_set(set.second.begin(), set.second.end());
-    ui->plot->graph(0)->setData(x_set, y_set);
-
-    ui->plot->xAxis->setRange(xlb, xrb);
-    ui->plot->yAxis->setRange(ylb, yrb);
-    ui->plot->replot();
+    output.error = "Error: Invalid set boundaries";
+  } else if (!accumulated) {
+    output.error = "Error: Invalid x argument";
+  } else if (on_curve_ && on_curve_(xlb, xrb, ylb, yrb, output.points)) {
+    output.curve = true;
+  } else if (!Superseded(generation)) {
+    status_type status;
+    auto sets = on_plot_(xlb, xrb, 2 * ylb - yrb, 2 * yrb - ylb, status);
+    for (std::size_t i = 0; i < sets.size(); ++i) {
+      if (i < status.size() && status[i].size() == sets[i].first.size())
+        output.sets.push_back(
+            s21::Decimate(sets[i], status[i], input.columns));
+      else
+        output.sets.push_back(s21::Decimate(sets[i], input.columns));
+    }
+  }
+  output.x_left = xlb;
+  output.x_right = xrb;
+  output.y_min = ylb;
+  output.y_max = yrb;
+  return output;
+}
+
+void MainWindow::ShowPlot(const PlotOutput& output) {
+  std::size_t points = 0;
+  if (output.curve) {
+    SetGraphCount(1);
+    ui->plot->graph(0)->data()->clear();
+    points = DrawCurve(output.points);
   } else {
-    SendError("Error: Invalid x argument");
+    RemoveCurve();
+    const std::vector<set_type>& sets = output.sets;
+    SetGraphCount(std::max<int>(sets.size(), 1));
+    for (int i = 0; i < ui->plot->graphCount(); ++i) {
+      if (static_cast<std::size_t>(i) >= sets.size()) {
+        ui->plot->graph(i)->data()->clear();
+        continue;
+      }
+      const set_type& set = sets[i];
+      QVector<QCPGraphData> data(static_cast<int>(set.first.size()));
+      for (int j = 0; j < data.size(); ++j)
+        data[j] = QCPGraphData(set.first[j], set.second[j]);
+      ui->plot->graph(i)->data()->set(data, true);
+      points += data.size();
+    }
   }
+  ui->plot->xAxis->setRange(output.x_left, output.x_right);
+  ui->plot->yAxis->setRange(output.y_min, output.y_max);
+  Replot(points);
+}
+
+void MainWindow::SetGraphCount(int count) {
+  while (ui->plot->graphCount() > count)
+    ui->plot->removeGraph(ui->plot->graphCount() - 1);
+  while (ui->plot->graphCount() < count) {
+    QColor color = kGraphColors[ui->plot->graphCount() %
+                                (sizeof(kGraphColors) / sizeof(QColor))];
+    ui->plot->addGraph()->setPen(QPen(color, 1.2));
+  }
+}
+
+std::size_t MainWindow::DrawCurve(const set_type& curve) {
+  if (!curve_) {
+    curve_ = new QCPCurve(ui->plot->xAxis, ui->plot->yAxis);
+    curve_->setPen(QPen(kGraphColors[0], 1.2));
+  }
+  QVector<QCPCurveData> data(static_cast<int>(curve.first.size()));
+  for (int i = 0; i < data.size(); ++i)
+    data[i] = QCPCurveData(i, curve.first[i], curve.second[i]);
+  curve_->data()->set(data, true);
+  return data.size();
+}
+
+void MainWindow::RemoveCurve() {
+  if (!curve_) return;
+  ui->plot->removePlottable(curve_);
+  curve_ = nullptr;
+}
+
+void MainWindow::Replot(std::size_t points) {
+  s21::ScopedStage stage(s21::Stage::kRender, points);
+  ui->plot->replot();
 }
 
 void MainWindow::SubscribeExprEval(const ExprEvalDelegate& delegate) {
@@ -171,8 +396,19 @@ void MainWindow::SubscribePlotEval(const PlotEvalDelegate& delegate) {
   on_plot_ = delegate;
 }
 
-std::string MainWindow::ReplaceCrutch(const std::string& text) const {
-  return std::regex_replace(text, std::regex("mod"), "%");
+void MainWindow::SubscribeCurveEval(const CurveEvalDelegate& delegate) {
+  on_curve_ = delegate;
 }
 
-MainWindow::~MainWindow() { delete ui; }
+void MainWindow::SubscribeRangeEval(const RangeEvalDelegate& delegate) {
+  on_range_ = delegate;
+}
+
+bool MainWindow::Previewing() const { return job_preview; }
+
+MainWindow::~MainWindow() {
+  ++generation_;
+  live_pool_.clear();
+  live_pool_.waitForDone();
+  delete ui;
+}
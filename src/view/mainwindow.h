@@ -7,13 +7,23 @@
 #ifndef CPP3_SMARTCALC_V2_SRC_VIEW_MAINWINDOW_H_
 #define CPP3_SMARTCALC_V2_SRC_VIEW_MAINWINDOW_H_
 
+#include <QColor>
 #include <QLineEdit>
 #include <QMainWindow>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "view_interface.h"
 
+class QCPCurve;
+
 QT_BEGIN_NAMESPACE
 namespace Ui {
 class MainWindow;
@@ -28,6 +38,7 @@ class MainWindow : public QMainWindow, public s21::ICalculatorView {
   typedef BaseView::ExprChangedDelegate ExprChangedDelegate;
   typedef BaseView::ExprEvalDelegate ExprEvalDelegate;
   typedef BaseView::PlotEvalDelegate PlotEvalDelegate;
+  typedef BaseView::CurveEvalDelegate CurveEvalDelegate;
 
   /**
    * @brief Construct a MainWindow object.
@@ -48,6 +59,17 @@ class MainWindow : public QMainWindow, public s21::ICalculatorView {
    * @param delegate The callback to be invoked for plotting evaluation.
    */
   void SubscribePlotEval(const PlotEvalDelegate& delegate) override;
+  /**
+   * @brief Subscribes a callback to handle the curve evaluation event.
+   * @param delegate The callback to be invoked for curve evaluation.
+   */
+  void SubscribeCurveEval(const CurveEvalDelegate& delegate) override;
+  /**
+   * @brief Subscribes a callback to handle the range fitting event.
+   * @param delegate The callback to be invoked to fit the Y range when both
+   * of its fields are empty.
+   */
+  void SubscribeRangeEval(const RangeEvalDelegate& delegate) override;
   /**
    * @brief Sends an error message to be displayed.
    * @param msg The error message to be displayed.
@@ -58,6 +80,11 @@ class MainWindow : public QMainWindow, public s21::ICalculatorView {
    * @return The entered expression as a string.
    */
   std::string GetExpr() override;
+  /**
+   * @brief Tells whether the events come from a live preview.
+   * @return true on the worker thread while it computes a live preview.
+   */
+  bool Previewing() const override;
 
  private:
   /**
@@ -90,28 +117,197 @@ class MainWindow : public QMainWindow, public s21::ICalculatorView {
    */
   void ClearAll();
   /**
-   * @brief Evaluates the input expression and displays the result.
+   * @struct PlotInput
+   * @brief Contents of the plot fields, read on the GUI thread.
+   */
+  struct PlotInput {
+    QString x_left;          /**< Left boundary of the X range*/
+    QString x_right;         /**< Right boundary of the X range*/
+    QString y_min;           /**< Lower boundary of the Y range*/
+    QString y_max;           /**< Upper boundary of the Y range*/
+    std::size_t columns = 0; /**< Device pixel columns of the plot*/
+  };
+  /**
+   * @struct PlotOutput
+   * @brief Plot computed from a PlotInput, drawn by ShowPlot.
+   */
+  struct PlotOutput {
+    std::string error;  /**< Error of the fields, empty if they are valid*/
+    double x_left = 0;  /**< Left boundary of the X range*/
+    double x_right = 0; /**< Right boundary of the X range*/
+    double y_min = 0;   /**< Lower boundary of the Y range*/
+    double y_max = 0;   /**< Upper boundary of the Y range*/
+    bool curve = false; /**< Whether the points are a curve*/
+    set_type points;    /**< Points of the curve*/
+    std::vector<set_type> sets; /**< Decimated points of the graphs*/
+  };
+  /**
+   * @struct LiveJob
+   * @brief A live preview or an explicit action, computed by the worker
+   * thread. A preview is shown unless a later preview or an explicit action
+   * superseded it, an action unless the calculator was cleared since.
+   */
+  struct LiveJob {
+    std::uint64_t generation = 0; /**< Value of generation_ at the start*/
+    bool preview = true;          /**< Whether it is a live preview*/
+    std::string expression;       /**< The expression, returned by GetExpr*/
+    QString x;                    /**< Contents of the x field*/
+    PlotInput plot;               /**< Contents of the plot fields*/
+    std::vector<std::string> messages; /**< Messages sent by the controller*/
+    double value = 0;       /**< The value at x*/
+    bool has_x = false;     /**< Whether the x field is a number*/
+    bool evaluated = false; /**< Whether the value was computed*/
+    bool plotted = false;   /**< Whether the plot was computed*/
+    PlotOutput output;      /**< The plot*/
+  };
+  /**
+   * @brief Evaluates the input expression on the worker thread and displays
+   * the result.
+   * @details The action waits for the running job, if any, without blocking
+   * the GUI thread; a running live preview stops at its next step.
    */
   void Eval();
   /**
-   * @brief Plots the function based on user input.
+   * @brief Plots the function based on user input on the worker thread, as
+   * Eval does.
+   * @details The Y range is fitted to the plot if both of its fields are
+   * empty, or is the X range if there is nothing to fit.
    */
   void Plot();
   /**
-   * @brief Replaces the string "mod" with the "%" sign in the given text.
-   * @param text The string containing the text to replace "mod" with "%".
-   * @return Modified text with "mod" replaced by the "%" sign.
+   * @brief Reads the plot fields.
+   * @return The contents of the fields.
    */
-  std::string ReplaceCrutch(const std::string& text) const;
+  PlotInput ReadPlotInput() const;
+  /**
+   * @brief Computes the plot through the delegates, without touching the
+   * widgets, so it may run on the worker thread.
+   * @param input The contents of the plot fields.
+   * @param generation The generation of a live preview, which stops between
+   * the steps once it is superseded; 0 for an explicit action.
+   * @return The plot, or the error of the fields; nothing if it stopped.
+   */
+  PlotOutput ComputePlot(const PlotInput& input,
+                         std::uint64_t generation) const;
+  /**
+   * @brief Draws the computed plot.
+   * @param output A plot with no error.
+   */
+  void ShowPlot(const PlotOutput& output);
+  /**
+   * @brief Adds or removes graphs to match the number of plotted expressions.
+   * @param count The number of graphs.
+   */
+  void SetGraphCount(int count);
+  /**
+   * @brief Draws the points of a parametric or polar curve in their order,
+   * or the segments of an implicit curve.
+   * @param curve The points of the curve, NaN points breaking it.
+   * @return Number of points drawn.
+   */
+  std::size_t DrawCurve(const set_type& curve);
+  /**
+   * @brief Removes the curve from the plot, if any.
+   */
+  void RemoveCurve();
+  /**
+   * @brief Redraws the plot, recording it as the render stage.
+   * @param points Number of points drawn.
+   */
+  void Replot(std::size_t points);
+  /**
+   * @brief Evaluates and plots the expression on the worker thread once the
+   * user stops typing.
+   */
+  void LivePreview();
+  /**
+   * @brief Runs the job on the worker thread, after the ones started before,
+   * and shows it on the GUI thread.
+   * @details The delegates are called on the worker thread only. A live
+   * preview that is superseded before it starts is skipped.
+   * @param job The job.
+   * @param compute Computes the job through the delegates.
+   * @param show Shows the computed job.
+   */
+  void Start(const std::shared_ptr<LiveJob>& job,
+             void (MainWindow::*compute)(LiveJob&),
+             void (MainWindow::*show)(const LiveJob&));
+  /**
+   * @brief Checks if a live preview was superseded.
+   * @param generation The generation of the preview, 0 for an explicit
+   * action, which is never superseded.
+   * @return true if a later preview or action started.
+   */
+  bool Superseded(std::uint64_t generation) const;
+  /**
+   * @brief Evaluates the expression at x.
+   * @param job The job, filled with the value.
+   */
+  void ComputeEval(LiveJob& job);
+  /**
+   * @brief Evaluates and plots the expression, stopping once the preview is
+   * superseded.
+   * @param job The preview, filled with the value and the plot.
+   */
+  void ComputeLive(LiveJob& job);
+  /**
+   * @brief Plots the expression.
+   * @param job The job, filled with the plot.
+   */
+  void ComputeGraph(LiveJob& job);
+  /**
+   * @brief Shows the live preview if it is the latest one and the
+   * expression is valid; its errors wait for editingFinished.
+   * @param job The computed preview.
+   */
+  void ShowLive(const LiveJob& job);
+  /**
+   * @brief Shows the value computed by Eval and its message.
+   * @param job The computed job.
+   */
+  void ShowEval(const LiveJob& job);
+  /**
+   * @brief Shows the plot computed by Plot and its message.
+   * @param job The computed job.
+   */
+  void ShowGraph(const LiveJob& job);
+  /**
+   * @brief Shows the last of the messages, which is the one the delegates
+   * leave on screen when they run on the GUI thread.
+   * @param messages The messages of a job.
+   */
+  void ShowMessages(const std::vector<std::string>& messages);
   /**
    * @brief Set of banned button names - buttons which don't print their inner
    * text.
    */
   static const std::set<QString> banned_buttons;
+  /**
+   * @brief Delay after the last keystroke before the live preview, in ms.
+   */
+  static constexpr int kLiveDelay = 150;
+  /**
+   * @brief Pen colors of the graphs, repeated if there are more graphs.
+   */
+  static const QColor kGraphColors[];
+
+  QTimer live_timer_;
+  /** Runs the live previews and the explicit actions one at a time, off the
+   * GUI thread*/
+  QThreadPool live_pool_;
+  /** Bumped by every live preview and explicit action; older previews are
+   * dropped*/
+  std::atomic<std::uint64_t> generation_{0};
+  /** Generation of the last ClearAll; older actions are dropped*/
+  std::uint64_t cleared_ = 0;
 
   Ui::MainWindow* ui;
 
   ExprEvalDelegate on_eval_;
   PlotEvalDelegate on_plot_;
+  CurveEvalDelegate on_curve_;
+  RangeEvalDelegate on_range_;
+
+  QCPCurve* curve_ = nullptr; /**< The curve, owned by the plot*/
 };
 #endif  // CPP3_SMARTCALC_V2_SRC_VIEW_MAINWINDOW_H_
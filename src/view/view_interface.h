@@ -21,10 +21,17 @@ namespace s21 {
 class ICalculatorView {
  public:
   typedef std::pair<std::vector<double>, std::vector<double>> set_type;
+  typedef std::vector<set_type> overlay_type;
+  typedef std::vector<std::vector<unsigned char>> status_type;
   typedef std::function<void(const std::string&)> ExprChangedDelegate;
   typedef std::function<double(double)> ExprEvalDelegate;
-  typedef std::function<set_type(double, double, double, double)>
+  typedef std::function<overlay_type(double, double, double, double,
+                                     status_type&)>
       PlotEvalDelegate;
+  typedef std::function<bool(double, double, double, double, set_type&)>
+      CurveEvalDelegate;
+  typedef std::function<bool(double, double, double&, double&)>
+      RangeEvalDelegate;
 
   virtual ~ICalculatorView() = default;
 
@@ -36,11 +43,31 @@ class ICalculatorView {
 
   /**
    * @brief Subscribes a callback to handle the plot evaluation event.
-   * @param delegate The callback to be invoked for plotting evaluation.
+   * @param delegate The callback to be invoked for plotting evaluation,
+   * returning a set of points per graph and filling the LaneStatus masks of
+   * their Y coordinates, or no masks if the model does not classify them.
    */
 
   virtual void SubscribePlotEval(const PlotEvalDelegate& delegate) = 0;
 
+  /**
+   * @brief Subscribes a callback to handle the curve evaluation event.
+   * @param delegate The callback to be invoked for plotting evaluation in the
+   * view range, filling the points of the curve in the order of its parameter
+   * or the segments of an implicit curve, broken by NaN points; it returns
+   * false if the expression is not a curve.
+   */
+
+  virtual void SubscribeCurveEval(const CurveEvalDelegate& delegate) = 0;
+
+  /**
+   * @brief Subscribes a callback to handle the range fitting event.
+   * @param delegate The callback to be invoked with the X range, filling the
+   * Y range that fits the plot; it returns false if there is nothing to fit.
+   */
+
+  virtual void SubscribeRangeEval(const RangeEvalDelegate& delegate) = 0;
+
   /**
    * @brief Sends an error message to the view to be displayed.
    * @param msg The error message to be displayed.
@@ -50,9 +77,18 @@ class ICalculatorView {
 
   /**
    * @brief Returns the current expression entered in the view.
-   * @return The entered expression as a string.
+   * @return The entered expression as a string; several expressions to plot
+   * together are separated by ';'.
    */
   virtual std::string GetExpr() = 0;
+
+  /**
+   * @brief Tells whether the events come from a live preview, which shows
+   * the input as it is typed and must not change the session, e.g. make the
+   * definitions of the partly typed input.
+   * @return true during a live preview; the default view has none.
+   */
+  virtual bool Previewing() const { return false; }
 };
 }  // namespace s21
 